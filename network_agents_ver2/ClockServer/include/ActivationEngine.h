@@ -0,0 +1,85 @@
+#ifndef ActivationEngine_INCLUDED
+#define ActivationEngine_INCLUDED
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Listener.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ActivationEngine
+/// Assigns the demand of a cycle to the consumers. Every consumer gets at
+/// most one activation, for one service, which may carry several demand
+/// units when there are fewer consumers than agents required. The
+/// consumers are taken in turn from where the previous cycle stopped, or
+/// the ones that were given the fewest units so far first, so the same
+/// agent processes do not get all the work.
+{
+public:
+	enum Policy
+	{
+		ROUND_ROBIN = 0,
+		LEAST_LOADED = 1
+	};
+
+	struct Demand
+	{
+		std::string service;
+		unsigned agents;
+		double quantity;
+			/// Per agent.
+	};
+
+	struct Assignment
+	{
+		Listener * listener;
+		std::size_t demand;
+			/// Index of the demand.
+		unsigned units;
+	};
+
+	ActivationEngine();
+
+	~ActivationEngine();
+
+	void configure(Policy policy, unsigned max_units);
+		/// At most max_units demand units per activation, at least one.
+
+	static Policy getPolicy(const std::string & name);
+		/// "round_robin" or "least_loaded", ROUND_ROBIN for any other name.
+
+	void assign(const std::vector<Listener *> & consumers,
+				const std::vector<Demand> & demands,
+				std::vector<Assignment> & assignments);
+		/// The units of every demand not given to a consumer are dropped.
+
+	void forget(const std::string & id);
+		/// The consumer disconnected.
+
+	void logStats();
+
+private:
+	Policy _policy;
+	unsigned _max_units;
+	std::size_t _next;
+	std::map<std::string, unsigned> _load;
+	unsigned _cycles;
+	unsigned _activations;
+	unsigned _dropped;
+
+	void order(const std::vector<Listener *> & consumers,
+			   std::vector<Listener *> & ordered);
+};
+
+} /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ActivationEngine_INCLUDED
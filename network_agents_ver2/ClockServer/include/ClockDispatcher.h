@@ -0,0 +1,93 @@
+//
+// ClockDispatcher.h
+//
+//
+// Definition of the ClockDispatcher class.
+//
+// Copyright (c) 2014, ChoiceNet Project.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef ClockDispatcher_INCLUDED
+#define ClockDispatcher_INCLUDED
+
+#include <Poco/Net/SocketAddress.h>
+
+#include "Message.h"
+#include "ServerDispatcher.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ClockDispatcher: public ServerDispatcher
+/// Methods answered by the clock server. They are executed by the
+/// dispatch reactor thread of the network server.
+{
+public:
+	ClockDispatcher();
+
+	~ClockDispatcher();
+
+	void onDisconnect(Poco::Net::SocketAddress socketAddress);
+
+	static void Connect(Poco::Net::SocketAddress socketAddress,
+						ChoiceNet::Eco::Message & messageRequest,
+						ChoiceNet::Eco::Message & messageResponse);
+
+	static void providerStartListening(Poco::Net::SocketAddress socketAddress,
+									   ChoiceNet::Eco::Message & messageRequest,
+									   ChoiceNet::Eco::Message & messageResponse);
+
+	static void sendCurrentPeriod(Poco::Net::SocketAddress socketAddress,
+								  ChoiceNet::Eco::Message & messageRequest,
+								  ChoiceNet::Eco::Message & messageResponse);
+
+	static void disconnectListener(Poco::Net::SocketAddress socketAddress,
+								   ChoiceNet::Eco::Message & messageRequest,
+								   ChoiceNet::Eco::Message & messageResponse);
+
+	static void getServices(Poco::Net::SocketAddress socketAddress,
+							ChoiceNet::Eco::Message & messageRequest,
+							ChoiceNet::Eco::Message & messageResponse);
+
+	static void periodDone(Poco::Net::SocketAddress socketAddress,
+						   ChoiceNet::Eco::Message & messageRequest,
+						   ChoiceNet::Eco::Message & messageResponse);
+
+private:
+	static void checkBarrier(void);
+		/// Ends the period when nobody else has to acknowledge it. In
+		/// virtual time it resumes the events.
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ClockDispatcher_INCLUDED
@@ -0,0 +1,70 @@
+#ifndef ClockEventQueue_INCLUDED
+#define ClockEventQueue_INCLUDED
+
+#include <Poco/Types.h>
+#include <queue>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+enum ClockEventType
+{
+	CLOCK_END_PERIOD = 1,
+	CLOCK_START_PERIOD = 2,
+	CLOCK_ACTIVATE_CONSUMER = 3
+};
+
+struct ClockEvent
+{
+	Poco::UInt64 time;
+	unsigned sequence;
+	ClockEventType type;
+	int period;
+};
+
+class ClockEventQueue
+/// Events of the clock running in virtual time, ordered by simulated time
+/// in milliseconds. The events scheduled for the same time keep the order
+/// they were scheduled in, so two runs process them in the same order.
+{
+public:
+	ClockEventQueue();
+
+	~ClockEventQueue();
+
+	void schedule(Poco::UInt64 time, ClockEventType type, int period);
+
+	bool empty() const;
+
+	const ClockEvent & next() const;
+		/// The earliest event. The queue must not be empty.
+
+	ClockEvent pop();
+
+	void clear();
+
+private:
+	struct Later
+	{
+		bool operator()(const ClockEvent & a, const ClockEvent & b) const
+		{
+			if (a.time != b.time)
+				return a.time > b.time;
+			return a.sequence > b.sequence;
+		}
+	};
+
+	std::priority_queue<ClockEvent, std::vector<ClockEvent>, Later> _events;
+	unsigned _next_sequence;
+};
+
+} /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ClockEventQueue_INCLUDED
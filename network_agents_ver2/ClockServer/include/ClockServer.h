@@ -38,6 +38,7 @@
 #include <Poco/Util/HelpFormatter.h>
 #include <iostream>
 #include "ClockSys.h"
+#include "TimerNotification.h"
 
 
 namespace ChoiceNet
@@ -58,6 +59,9 @@ namespace Eco
 		/// Destroy the NetworkQualityServer
 
         ClockSys* getClockSubsystem();
+
+        TimerNotification* getTimerNotification();
+        /// Period ticks, NULL when they are not running.
         
 	protected:	
 
@@ -79,6 +83,7 @@ namespace Eco
 	private:
 		bool _helpRequested;
 		ClockSys *_clockSysPtr;
+		TimerNotification *_timerPtr;
 	};
 
 } /// End Eco namespace
@@ -17,7 +17,10 @@
 #include "DecisionVariable.h"
 #include "Service.h"
 #include "Listener.h"
+#include "ListenerRegistry.h"
 #include "Message.h"
+#include "ClockEventQueue.h"
+#include "ActivationEngine.h"
 
 namespace ChoiceNet
 {
@@ -41,19 +44,8 @@ public:
 	void startListening(Poco::Net::SocketAddress socketAddress,
 					   Poco::UInt16 port, std::string type,
 					   ChoiceNet::Eco::Message & messageResponse);
-
-	void insertListenerBytype(std::string type, std::string listenerId);
-
-	void deleteListenerBytype(std::string type, std::string listenerId);
-
-	void addStagedData(Poco::Net::SocketAddress socketAddress,
-					   Poco::FIFOBuffer & fifoIn,
-					   int len);
-
-	void getMessage(Poco::FIFOBuffer & fifoIn, int len, Message &message);
-
-	bool getMessage(Poco::Net::SocketAddress socketAddress,
-					ChoiceNet::Eco::Message & message);
+		/// The response gives the period, the one a market place or a
+		/// provider acknowledges first in virtual time.
 
     void setDemandForecaster(PointSetDemandForecaster * demand_forecaster);
 
@@ -67,10 +59,6 @@ public:
 
 	void broadcastPeriodStart(void);
 
-	ChoiceNet::Eco::Message * getActivationMessage(void);
-
-	void decreaseActivationMessageCount(std::string serviceId);
-
 	void broadcastTerminate(void);
 
 	int getPeriod(void);
@@ -84,6 +72,17 @@ public:
 	void deleteListener( Poco::Net::SocketAddress socketAddress,
 						 ChoiceNet::Eco::Message & messageResponse );
 
+	void acknowledgePeriod(Poco::Net::SocketAddress socketAddress, int period,
+						   ChoiceNet::Eco::Message & messageResponse);
+		/// Records that the listener completed the period. The market places
+		/// and the providers give the period, the consumers the cycle they
+		/// were activated for; an acknowledgement of a past one is accepted
+		/// and ignored.
+
+	bool isPeriodAcknowledged(void);
+		/// True when the market places, the providers and the consumers
+		/// activated by the last period start have all acknowledged it.
+
     void getServices(std::string serviceId, ChoiceNet::Eco::Message & messageResponse);
 
     void getServices(ChoiceNet::Eco::Message & messageResponse);
@@ -95,6 +94,26 @@ public:
     void initialize(Poco::Util::Application &app);
 
 	void activateCustomers(int period);
+		/// Sends the forecast demand of the cycle to the consumers chosen by
+		/// the activation engine.
+
+	void logActivationStats(void);
+
+	void startVirtualTime(long interval);
+		/// Runs the simulation in virtual time with intervals of the given
+		/// milliseconds: the period changes are events processed in
+		/// simulated time order and no timer is involved. Reactor thread.
+
+	bool isVirtualTime(void);
+
+	Poco::UInt64 getVirtualTime(void);
+
+	void runEvents(void);
+		/// Processes the events due. A period does not end before a market
+		/// place is listening and the market places, providers and consumers
+		/// it waits for have all acknowledged it, including the market
+		/// places and providers that started listening during it; the
+		/// acknowledgements resume the events.
 
 protected:
 
@@ -103,18 +122,22 @@ protected:
 private:
     char p_cName;
 
-    struct ServiceActivation
-	{
-		int num_agents;
-		Message * message_to_send;
-	};
-
-    typedef std::map<Poco::Net::SocketAddress, Listener *> Listeners;
-
-    Listeners _listeners;
-    std::map<std::string, Listener *> _listeners_by_id;
-    std::map<std::string, std::vector<std::string> > _listeners_by_type;
-    std::map<std::string, ServiceActivation> _services_activation;
+    // Container for listeners, indexed by address, id and type.
+    ListenerRegistry _listeners;
+    ActivationEngine _activation;
+    // Listeners the current period waits for, by id, with the period
+    // their acknowledgement gives.
+    std::map<std::string, int> _pending_acks;
+    bool _awaiting_acks;
+    // Virtual time, in milliseconds.
+    bool _virtual;
+    Poco::UInt64 _virtual_time;
+    Poco::UInt64 _virtual_interval;
+    ClockEventQueue _events;
+
+    bool isPeriodOpen(void);
+
+    void endVirtualPeriod(Poco::UInt64 time);
     int _interval;
     int _period;
     int _intervals_per_cycle;
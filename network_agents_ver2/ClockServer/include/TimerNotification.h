@@ -1,11 +1,15 @@
 #ifndef TimerNotification_INCLUDED
 #define TimerNotification_INCLUDED
 
-#include <Poco/Timer.h>
+#include <Poco/Runnable.h>
 #include <Poco/Thread.h>
-#include <Poco/Stopwatch.h>
+#include <Poco/Event.h>
+#include <Poco/Clock.h>
+#include <atomic>
 #include <iostream>
 
+#include "WaitingSocketReactor.h"
+
 
 namespace ChoiceNet
 {
@@ -13,16 +17,59 @@ namespace ChoiceNet
 namespace Eco
 {
 
-class TimerNotification
+class TimerNotification: public Poco::Runnable
+/// Period ticks of the clock server. A thread sleeps until the deadline of
+/// the next tick on the monotonic clock and posts the tick to the dispatch
+/// reactor, where it is processed between the requests of the agents, so
+/// ClockSys is only used by that thread. The deadlines follow the schedule
+/// of the first one, a late tick does not move the next ones.
+///
+/// In barrier mode the period ends as soon as the listeners it waits for
+/// have acknowledged it, and the interval is only the upper bound: the
+/// next deadline is one interval after the tick was processed.
 {
 public:
-    TimerNotification(int intervals_per_cycle);
+    TimerNotification(WaitingSocketReactor & reactor, long interval,
+					  int intervals_per_cycle, bool barrier = false);
+		/// Interval in milliseconds.
+
+    ~TimerNotification();
+
+    void start();
+
+    void stop();
+		/// No tick is posted after it returns.
 
-    void onEndPeriod(Poco::Timer& timer);
+    void run();
+
+    void onEndPeriod(Poco::Clock deadline, unsigned generation);
+		/// Reactor thread only. In barrier mode a tick posted for a period
+		/// already ended by the barrier is dropped.
+
+    void advance();
+		/// Reactor thread only. Ends the period now in barrier mode, does
+		/// nothing otherwise.
+
+    void logStats();
+		/// Reactor thread only. Logs how late the ticks were processed.
 
 private:
-    Poco::Stopwatch _sw;
+    WaitingSocketReactor & _reactor;
+    Poco::Clock::ClockDiff _interval;
     int _intervals_per_cycle;
+    bool _barrier;
+    Poco::Thread _thread;
+    Poco::Event _wakeup;
+    std::atomic<bool> _stop;
+    // Ticks processed, the timer thread re-arms its deadline when it changes.
+    std::atomic<unsigned> _generation;
+    bool _finished;
+
+    // Lateness of the ticks, reactor thread only.
+    unsigned _ticks;
+    unsigned _advanced;
+    Poco::Clock::ClockDiff _late_total;
+    Poco::Clock::ClockDiff _late_max;
 };
 
 } /// End Eco namespace
@@ -0,0 +1,132 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Format.h>
+#include <algorithm>
+
+#include "ActivationEngine.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+ActivationEngine::ActivationEngine():
+_policy(ROUND_ROBIN),
+_max_units(1),
+_next(0),
+_cycles(0),
+_activations(0),
+_dropped(0)
+{
+}
+
+ActivationEngine::~ActivationEngine()
+{
+}
+
+void ActivationEngine::configure(Policy policy, unsigned max_units)
+{
+	_policy = policy;
+	_max_units = (max_units == 0) ? 1 : max_units;
+}
+
+ActivationEngine::Policy ActivationEngine::getPolicy(const std::string & name)
+{
+	if (name.compare("least_loaded") == 0)
+		return LEAST_LOADED;
+	return ROUND_ROBIN;
+}
+
+void ActivationEngine::order(const std::vector<Listener *> & consumers,
+							 std::vector<Listener *> & ordered)
+{
+	ordered.reserve(consumers.size());
+	if (consumers.empty() == true)
+		return;
+
+	// Starts after the last consumer activated in the previous cycle.
+	std::size_t first = _next % consumers.size();
+	for (std::size_t i = 0; i < consumers.size(); ++i)
+		ordered.push_back(consumers[(first + i) % consumers.size()]);
+
+	if (_policy == LEAST_LOADED)
+	{
+		// Stable, the ties keep the round robin order.
+		std::map<std::string, unsigned> & load = _load;
+		std::stable_sort(ordered.begin(), ordered.end(),
+			[&load](Listener * a, Listener * b)
+			{
+				return load[a->getId()] < load[b->getId()];
+			});
+	}
+}
+
+void ActivationEngine::assign(const std::vector<Listener *> & consumers,
+							  const std::vector<Demand> & demands,
+							  std::vector<Assignment> & assignments)
+{
+	std::vector<Listener *> ordered;
+	order(consumers, ordered);
+	++_cycles;
+
+	unsigned total = 0;
+	for (std::size_t i = 0; i < demands.size(); ++i)
+		total += demands[i].agents;
+
+	// One unit per consumer while there are enough of them, the units are
+	// only grouped when there are not.
+	unsigned units = 1;
+	if (ordered.empty() == false)
+		units = (unsigned) ((total + ordered.size() - 1) / ordered.size());
+	units = std::max(1u, std::min(units, _max_units));
+
+	std::size_t consumer = 0;
+	for (std::size_t i = 0; i < demands.size(); ++i)
+	{
+		unsigned remaining = demands[i].agents;
+		while ((remaining > 0) && (consumer < ordered.size()))
+		{
+			Assignment assignment;
+			assignment.listener = ordered[consumer++];
+			assignment.demand = i;
+			assignment.units = std::min(units, remaining);
+			remaining -= assignment.units;
+
+			_load[assignment.listener->getId()] += assignment.units;
+			assignments.push_back(assignment);
+			++_activations;
+		}
+		_dropped += remaining;
+	}
+
+	_next += consumer;
+}
+
+void ActivationEngine::forget(const std::string & id)
+{
+	_load.erase(id);
+}
+
+void ActivationEngine::logStats()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	unsigned low = 0;
+	unsigned high = 0;
+	std::map<std::string, unsigned>::iterator it;
+	for (it = _load.begin(); it != _load.end(); ++it)
+	{
+		if ((it == _load.begin()) || (it->second < low))
+			low = it->second;
+		if (it->second > high)
+			high = it->second;
+	}
+
+	app.logger().information(Poco::format("Activation cycles: %u, activations: %u, units dropped: %u, consumer load min %u max %u",
+							 _cycles, _activations, _dropped, low, high));
+}
+
+} /// End Eco namespace
+
+}  /// End ChoiceNet namespace
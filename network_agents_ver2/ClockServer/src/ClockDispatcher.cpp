@@ -0,0 +1,215 @@
+//
+// ClockDispatcher.cpp
+//
+// Definition of the ClockDispatcher class.
+//
+// Copyright (c) 2014, ChoiceNet Project.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <Poco/Util/Application.h>
+#include <Poco/NumberParser.h>
+#include <Poco/Types.h>
+#include <iostream>
+
+#include "ClockServerException.h"
+#include "ClockDispatcher.h"
+#include "ClockSys.h"
+#include "ClockServer.h"
+#include "TimerNotification.h"
+#include "Message.h"
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ClockDispatcher::ClockDispatcher()
+{
+	addMethod(connect, &ClockDispatcher::Connect);
+	addMethod(send_port, &ClockDispatcher::providerStartListening);
+	addMethod(get_current_period, &ClockDispatcher::sendCurrentPeriod);
+	addMethod(disconnect, &ClockDispatcher::disconnectListener);
+	addMethod(get_services, &ClockDispatcher::getServices);
+	addMethod(period_done, &ClockDispatcher::periodDone);
+}
+
+ClockDispatcher::~ClockDispatcher()
+{
+}
+
+void ClockDispatcher::onDisconnect(Poco::Net::SocketAddress socketAddress)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	ChoiceNet::Eco::Message messageResponse;
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys * clocksys = server.getClockSubsystem();
+	(*clocksys).deleteListener( socketAddress, messageResponse );
+	app.logger().information("deleted the listener");
+
+	// The period may have waited only for it.
+	checkBarrier();
+}
+
+void ClockDispatcher::Connect(Poco::Net::SocketAddress socketAddress,
+									   ChoiceNet::Eco::Message & message,
+									   ChoiceNet::Eco::Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("start Connect");
+
+	std::string listenerId = message.getParameter("Agent");
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys *clocksys = server.getClockSubsystem();
+	(*clocksys).insertListener(listenerId, socketAddress, messageResponse);
+
+	app.logger().information("ending Connect");
+
+}
+
+void ClockDispatcher::providerStartListening(Poco::Net::SocketAddress socketAddress,
+										       ChoiceNet::Eco::Message & message,
+										       ChoiceNet::Eco::Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("Start ProviderStartListening");
+
+	unsigned  Uport;
+	std::string port = message.getParameter("Port");
+	bool v_result = Poco::NumberParser::tryParseUnsigned(port, Uport);
+	std::string type = message.getParameter("Type");
+	if ( Uport <= 0xFFFF)
+	{
+		ClockServer &server = dynamic_cast<ClockServer&>(app);
+		ClockSys * clocksys = server.getClockSubsystem();
+		Poco::UInt16 u16Port = (Poco::UInt16) Uport;
+		(*clocksys).startListening(socketAddress, u16Port, type, messageResponse);
+
+		// In virtual time the periods wait for a market place.
+		checkBarrier();
+	}
+	else
+	{
+		std::cout << "Invalid Port" << std::endl;
+		app.logger().debug("Invalid Port");
+		throw ClockServerException("Invalid Port", 301);
+	}
+
+	app.logger().information("Ending ProviderStartListening");
+}
+
+void ClockDispatcher::sendCurrentPeriod(Poco::Net::SocketAddress socketAddress,
+										  ChoiceNet::Eco::Message & messageRequest,
+										  ChoiceNet::Eco::Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("start sendCurrentPeriod");
+
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys * clocksys = server.getClockSubsystem();
+	(*clocksys).sendCurrentPeriod(socketAddress, messageResponse);
+
+	app.logger().information("ending sendCurrentPeriod");
+
+}
+
+void ClockDispatcher::disconnectListener(Poco::Net::SocketAddress socketAddress,
+										   ChoiceNet::Eco::Message & messageRequest,
+										   ChoiceNet::Eco::Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("Start disconnectListener");
+
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys * clocksys = server.getClockSubsystem();
+	(*clocksys).deleteListener( socketAddress, messageResponse );
+
+	app.logger().information("Ending disconnectListener");
+
+}
+
+void ClockDispatcher::getServices(Poco::Net::SocketAddress ipAddress,
+								    ChoiceNet::Eco::Message & messageRequest,
+								    ChoiceNet::Eco::Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("start getServices");
+
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys *sys = server.getClockSubsystem();
+
+	if (messageRequest.existsParameter("Service")){
+		std::string serviceId = messageRequest.getParameter("Service");
+		(*sys).getServices(serviceId, messageResponse);
+	}
+	else{
+		(*sys).getServices(messageResponse);
+	}
+
+	app.logger().information("Ending main getServices");
+}
+
+void ClockDispatcher::periodDone(Poco::Net::SocketAddress socketAddress,
+								   ChoiceNet::Eco::Message & messageRequest,
+								   ChoiceNet::Eco::Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys * clocksys = server.getClockSubsystem();
+
+	int period = 0;
+	std::string periodStr = messageRequest.getParameter("Period");
+	if (Poco::NumberParser::tryParse(periodStr, period) == false)
+	{
+		throw ClockServerException("Invalid period", 304);
+	}
+
+	(*clocksys).acknowledgePeriod(socketAddress, period, messageResponse);
+	checkBarrier();
+}
+
+void ClockDispatcher::checkBarrier(void)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	ClockServer &server = dynamic_cast<ClockServer&>(app);
+	ClockSys * clocksys = server.getClockSubsystem();
+	TimerNotification * timer = server.getTimerNotification();
+
+	if ((*clocksys).isVirtualTime())
+		(*clocksys).runEvents();
+	else if ((timer != NULL) && (*clocksys).isPeriodAcknowledged())
+		(*timer).advance();
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,54 @@
+#include "ClockEventQueue.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+ClockEventQueue::ClockEventQueue():
+_next_sequence(0)
+{
+}
+
+ClockEventQueue::~ClockEventQueue()
+{
+}
+
+void ClockEventQueue::schedule(Poco::UInt64 time, ClockEventType type, int period)
+{
+	ClockEvent event;
+	event.time = time;
+	event.sequence = _next_sequence++;
+	event.type = type;
+	event.period = period;
+	_events.push(event);
+}
+
+bool ClockEventQueue::empty() const
+{
+	return _events.empty();
+}
+
+const ClockEvent & ClockEventQueue::next() const
+{
+	return _events.top();
+}
+
+ClockEvent ClockEventQueue::pop()
+{
+	ClockEvent event = _events.top();
+	_events.pop();
+	return event;
+}
+
+void ClockEventQueue::clear()
+{
+	while (_events.empty() == false)
+		_events.pop();
+}
+
+} /// End Eco namespace
+
+}  /// End ChoiceNet namespace
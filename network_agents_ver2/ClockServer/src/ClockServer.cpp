@@ -12,8 +12,6 @@
 #include <Poco/DateTimeFormat.h>
 #include <Poco/Net/ServerSocket.h>
 #include <Poco/AutoPtr.h>
-#include <Poco/Timer.h>
-#include <Poco/Stopwatch.h>
 #include <Poco/FileChannel.h>
 #include <Poco/Logger.h>
 #include <Poco/AutoPtr.h>
@@ -23,8 +21,8 @@
 
 #include "ClockServer.h"
 #include "ClockSys.h"
-#include "WaitingSocketReactor.h"
-#include "ConnectionHandler.h"
+#include "NetworkServer.h"
+#include "ClockDispatcher.h"
 #include "TimerNotification.h"
 #include "Service.h"
 #include "DecisionVariable.h"
@@ -45,7 +43,8 @@ namespace Eco
 
     ClockServer::ClockServer(): 
 	_helpRequested(false),
-	_clockSysPtr(NULL)
+	_clockSysPtr(NULL),
+	_timerPtr(NULL)
     {
     }
 
@@ -107,6 +106,11 @@ namespace Eco
 		throw Poco::NotFoundException("The subsystem has not been registered", typeid(ClockSys).name());
 	}
 
+    TimerNotification* ClockServer::getTimerNotification()
+    {
+		return _timerPtr;
+	}
+
     int ClockServer::main(const std::vector<std::string>& args)
     {
         if (!_helpRequested)
@@ -130,15 +134,19 @@ namespace Eco
 		   unsigned short port = (unsigned short)
 					config().getInt("listening_port", 3333);
 					
-		   // Server Socket
-		   Poco::Net::ServerSocket svs(port);
-		   // Reactor-Notifier
-		   WaitingSocketReactor reactor;
-		   // Server-Acceptor
-		   Poco::Net::SocketAcceptor<ConnectionHandler> acceptor(svs, reactor);
-		   // Threaded Reactor
-		   Poco::Thread thread;
-		   thread.start(reactor);
+		   // Reactor threads serving the connections
+		   unsigned reactors = (unsigned)
+					config().getInt("reactor_threads", 1);
+
+		   ClockDispatcher dispatcher;
+		   NetworkServer network("Clock_Server", dispatcher, reactors);
+
+		   // Unix domain socket for the agents on this host
+		   std::string local_path = config().getString("local_socket_path", "");
+		   if (local_path.empty() == false)
+			   network.listenLocal(local_path);
+
+		   network.start(port);
 		   
 		   // Starts timer events 
 		   // Get the time for each interval
@@ -149,23 +157,55 @@ namespace Eco
 		   unsigned short intervals_per_cycle = (unsigned short)
 					config().getInt("intervals_per_cycle", 2);
 							   
-		   Poco::Timer timer(interval, interval);
-		   TimerNotification notification(intervals_per_cycle);
-		   Poco::TimerCallback<TimerNotification> callback(notification, &TimerNotification::onEndPeriod);
-		   timer.start(callback);
+		   // In barrier mode a period ends when the market places and the
+		   // activated consumers have acknowledged it, at most after the
+		   // barrier timeout.
+		   bool barrier = config().getBool("barrier_mode", false);
+		   if (barrier == true)
+			   interval = (unsigned short) config().getInt("barrier_timeout", interval);
+
+		   // In virtual time the periods only wait for the acknowledgements.
+		   bool virtual_time = config().getBool("virtual_time", false);
+
+		   ClockSys * clocksys = getClockSubsystem();
+		   TimerNotification notification(network.getDispatchReactor(), interval,
+										  intervals_per_cycle, barrier);
+		   if (virtual_time == true)
+		   {
+			   long virtual_interval = interval;
+			   network.getDispatchReactor().post([clocksys, virtual_interval]()
+			   {
+				   clocksys->startVirtualTime(virtual_interval);
+			   });
+		   }
+		   else
+		   {
+			   // The ticks are processed by the dispatch reactor
+			   _timerPtr = &notification;
+			   notification.start();
+		   }
 		   
 		   // Wait for CTRL+C
 		   waitForTerminationRequest();
-		   getClockSubsystem()->broadcastTerminate();
-		   // Stop timer
-		   timer.stop();
-		   // Stop reactor
-		   reactor.stop();
+		   // Stop ticks
+		   notification.stop();
+		   TimerNotification * ticks = &notification;
+		   TimerNotification ** timer = &_timerPtr;
+		   network.getDispatchReactor().post([clocksys, ticks, timer, virtual_time]()
+		   {
+			   // No acknowledgement advances the periods anymore.
+			   *timer = NULL;
+			   if (virtual_time == false)
+				   ticks->logStats();
+			   clocksys->logActivationStats();
+			   clocksys->broadcastTerminate();
+		   });
+		   // Let the agents disconnect before stopping the reactors
 		   int sleptime = (interval * intervals_per_cycle) / 1000;
 		   std::cout << "sleeping for: " << sleptime <<  std::endl;
 		   sleep(sleptime);
-			
-		   thread.join();		   
+
+		   network.stop();
 		  
 		   
 		   return Poco::Util::ServerApplication::Application::EXIT_OK; 
@@ -16,6 +16,7 @@
 #include <limits.h>
 #include <unistd.h>
 #include <Poco/LogStream.h>
+#include <Poco/Util/ServerApplication.h>
 
 
 
@@ -28,6 +29,7 @@
 #include "TrafficConverter.h"
 #include "SimplestTrafficConverter.h"
 #include "Message.h"
+#include "NetworkServer.h"
 
 
 using Poco::LogStream;
@@ -41,7 +43,11 @@ ClockSys::ClockSys(void): FoundationSys(CLOCK_SERVER),
 _period(0),
 _interval(0),
 p_cName('C'),
-_executionNumber(0)
+_executionNumber(0),
+_awaiting_acks(false),
+_virtual(false),
+_virtual_time(0),
+_virtual_interval(0)
 {
 }
 
@@ -50,26 +56,7 @@ ClockSys::~ClockSys(void)
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug("Disconnecting the Event Discrete System");
 
-    // Release the memory assigned to listeners ( Pointers referenced by Listener Id)
-
-    std::map<std::string, Listener *>::iterator it_listeners_byId;
-    it_listeners_byId = _listeners_by_id.begin();
-    while ( it_listeners_byId != _listeners_by_id.end())
-    {
-		_listeners_by_id.erase(it_listeners_byId);
-		++it_listeners_byId;
-	}
-
-    // Release the memory assigned to listeners ( Pointers referenced by socket address)
-    Listeners::iterator it_listeners;
-    it_listeners = _listeners.begin();
-    while ( it_listeners != _listeners.end())
-    {
-		(*(it_listeners->second)).Disconnect();
-		delete it_listeners->second;
-		_listeners.erase(it_listeners);
-		++it_listeners;
-	}
+    // The registry disconnects and releases the listeners when it is destroyed.
 
 	app.logger().information("Event Discrete System Finished");
 }
@@ -95,6 +82,11 @@ void ClockSys::initialize(Poco::Util::Application &app)
 	// initialize variable
 	_intervals_per_cycle = intervals_per_cycle;
 
+	// How the demand is spread over the consumers
+	std::string policy = app.config().getString("activation_policy", "round_robin");
+	unsigned max_units = (unsigned) app.config().getInt("activation_max_units", 1);
+	_activation.configure(ActivationEngine::getPolicy(policy), max_units);
+
 	FoundationSys::initialize(app, bid_periods, 0);
 	app.logger().debug("Event Discrete System initialized");
 
@@ -107,67 +99,14 @@ const char* ClockSys::name() const
 
 bool ClockSys::isAlreadyListener(std::string idListener)
 {
-	bool val_return;
-	if (_listeners_by_id.count(idListener) > 0)
-	    val_return = true;
-	else
-		val_return = false;
-	return val_return;
+	return (_listeners.find(idListener) != NULL);
 }
 
 bool ClockSys::isAlreadyListener(Poco::Net::SocketAddress socketAddress)
 {
-	bool found = false;
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		found = true;
-	}
-	return found;
-
+	return (_listeners.find(socketAddress) != NULL);
 }
 
-void ClockSys::getMessage(Poco::FIFOBuffer & fifoIn,
-						  int len, Message &message )
-{
-	// If the socket address corresponds to a listener, then the message size
-	// could be unlimited, when it is not a listener then we have as its
-	// limit 1024.
-	std::string receiveString;
-	std::size_t i = 0;
-	for (; i < fifoIn.used() ; ++i){
-		receiveString += (*(fifoIn.begin() + i));
-	}
-	fifoIn.drain(len);
-	message.setData(receiveString);
-	std::cout << "Data accumulated is:"  << receiveString << std::endl;
-}
-
-
-void ClockSys::addStagedData(Poco::Net::SocketAddress socketAddress,
-				   Poco::FIFOBuffer & fifoIn,
-				   int len)
-{
-	// If the socket address corresponds to a listener, then the message size
-	// could be unlimited, when it is not a listener then we have as its
-	// limit 1024.
-
-	bool found = false;
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		(*(it->second)).addStreamStagedForProcessing(fifoIn,len);
-	}
-	else
-	{
-		std::cout << "The agent is not a listener" << std::endl;
-		throw ClockServerException("The agent is not a listener", 303);
-	}
-}
-
-
 void ClockSys::insertListener(std::string idListener,
 							 Poco::Net::SocketAddress socketAddress,
 							 Message & messageResponse )
@@ -180,10 +119,11 @@ void ClockSys::insertListener(std::string idListener,
 	else
 	{
 		std::cout << "Insert Listener";
-		Listener *listener = new Listener(idListener, socketAddress);
-
-		_listeners.insert( std::pair<Poco::Net::SocketAddress, Listener *>(socketAddress,listener));
-		_listeners_by_id.insert( std::pair<std::string, Listener *>(idListener,listener));
+		if (_listeners.add(idListener, socketAddress) == NULL)
+		{
+			std::cout << "The agent is already a listener" << std::endl;
+			throw ClockServerException("The agent is already a listener", 302);
+		}
 
 		std::cout << "Size:" << _listeners.size() << std::endl;
 		messageResponse.setResponseOk();
@@ -198,25 +138,34 @@ void ClockSys::startListening(Poco::Net::SocketAddress socketAddress,
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug("Start - startListening ");
 
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if (it != _listeners.end())
+	Listener * listener = _listeners.find(socketAddress);
+	if (listener != NULL)
 	{
 
 		app.logger().debug("The provider was found");
 
 		try
 		{
-			Poco::Net::SocketAddress sa = (*(it->second)).getSocketAddress();
+			Poco::Net::SocketAddress sa = listener->getSocketAddress();
 
 			app.logger().debug("Socket address:" + sa.toString());
 
 			std::cout << "Found the provider" << std::endl;
-			Poco::Net::SocketAddress sockadd(sa.host(), port);
-			(*(it->second)).Connect(sockadd);
-			(*(it->second)).setType(type);
-			insertListenerBytype(type, (*(it->second)).getId());
+			Poco::Net::SocketAddress sockadd(NetworkServer::getCallbackHost(sa), port);
+			listener->Connect(sockadd);
+			_listeners.setType(listener, type);
+
+			// In virtual time the period joined waits for the market places
+			// and the providers as well, it does not end while they are
+			// still setting up.
+			if ((_virtual == true) &&
+				((listener->getType() == MARKET_PLACE) || (listener->getType() == PROVIDER)))
+			{
+				_pending_acks[listener->getId()] = _period;
+				_awaiting_acks = true;
+			}
 			messageResponse.setResponseOk();
+			messageResponse.setParameter("Period", Poco::NumberFormatter::format(_period));
 		} catch(const Poco::InvalidArgumentException &ex) {
 			std::cout << "Invalid host" << std::endl;
 			throw ClockServerException("Invalid host", 307);
@@ -235,49 +184,6 @@ void ClockSys::startListening(Poco::Net::SocketAddress socketAddress,
 	app.logger().debug("Ending - startListening ");
 }
 
-void ClockSys::insertListenerBytype(std::string type, std::string listenerId)
-{
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Start - insertListenerBytype ");
-
-	std::map<std::string, std::vector<std::string> >::iterator it;
-	it = _listeners_by_type.find(type);
-	if (it == _listeners_by_type.end())
-	{
-		std::vector<std::string> list;
-		_listeners_by_type.insert(std::pair<std::string, std::vector<std::string> > (type, list));
-
-	}
-	it = _listeners_by_type.find(type);
-	(it->second).push_back(listenerId);
-
-	app.logger().debug("Ending - insertListenerBytype ");
-}
-
-void ClockSys::deleteListenerBytype(std::string type, std::string listenerId)
-{
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Start - deleteListenerBytype ");
-
-	// Find the type in the list of listener types.
-	std::map<std::string, std::vector<std::string> >::iterator it;
-	it = _listeners_by_type.find(type);
-	if (it != _listeners_by_type.end())
-	{
-		// Find the specific listener id in the list.
-		std::vector<std::string>::iterator iter_list_ids;
-		for (unsigned i=0; (it->second).size(); ++i){
-    		if (listenerId.compare((it->second)[i]) == 0)
-    			(it->second).erase((it->second).begin() + i);
-		}
-	}
-
-	app.logger().debug("Ending - deleteListenerBytype ");
-}
-
-
 void ClockSys::sendCurrentPeriod(Poco::Net::SocketAddress socketAddress,
 								 Message & messageResponse)
 {
@@ -286,26 +192,12 @@ void ClockSys::sendCurrentPeriod(Poco::Net::SocketAddress socketAddress,
 
 	lstr << "Entering send current period" << socketAddress.toString() << std::endl;
 
-	int val_return = -1;
-	Listeners::iterator it;
-	it = _listeners.begin();
-	bool found = false;
-    std::string sockAddrPar = socketAddress.toString();
-
-	while( (it!=_listeners.end()) && (found ==false) )
-	{
-		Poco::Net::SocketAddress sa = (*(it->second)).getSocketAddress();
-		std::string sockAddrStr = sa.toString();
-
-		if ( sockAddrPar.compare(sockAddrStr) == 0 ){
-            // Builds the message with the current period
-            messageResponse.setResponseOk();
-            messageResponse.setParameter("Period", Poco::NumberFormatter::format(_period));
-            found = true;
-		}
-		++it;
+	if (_listeners.find(socketAddress) != NULL){
+		// Builds the message with the current period
+		messageResponse.setResponseOk();
+		messageResponse.setParameter("Period", Poco::NumberFormatter::format(_period));
 	}
-    if (found == false){
+	else{
 		std::cout << "The agent is not inscribed as listener" << std::endl;
 		throw ClockServerException("The agent is not inscribed as listener", 303);
 	}
@@ -314,31 +206,6 @@ void ClockSys::sendCurrentPeriod(Poco::Net::SocketAddress socketAddress,
 
 }
 
-bool ClockSys::getMessage(Poco::Net::SocketAddress socketAddress,
-				Message & message)
-{
-	bool val_return = false;
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Start - getMessage");
-
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		val_return = (*(it->second)).getMessage(message);
-	}
-	else
-	{
-		std::cout << "The agent is not a listener" << std::endl;
-		throw ClockServerException("The agent is not a listener", 303);
-	}
-
-	app.logger().debug("End - getMessage");
-
-	return val_return;
-}
-
 void ClockSys::broadcastPeriodEnd(void)
 {
 	Poco::Util::Application& app = Poco::Util::Application::instance();
@@ -350,27 +217,19 @@ void ClockSys::broadcastPeriodEnd(void)
     Method method = end_period;
     endPeriod.setMethod(method);
     endPeriod.setParameter("Period", Poco::NumberFormatter::format(_period));
+    if (_virtual == true)
+		endPeriod.setVirtualTime(_virtual_time);
 
     // Only send the broadcast end period to market server listeners.
-	std::map<std::string, std::vector<std::string> >::iterator it_market_server;
-	it_market_server = _listeners_by_type.find("market_place");
-	if ( it_market_server != _listeners_by_type.end() )
-	{
-		std::vector<std::string> list = it_market_server->second;
-		std::vector<std::string>::iterator it_strings;
-		it_strings = list.begin();
+	std::vector<Listener *> list;
+	_listeners.getListeners("market_place", list);
 
-		while (it_strings != list.end())
+	std::vector<Listener *>::iterator it;
+	for (it = list.begin(); it != list.end(); ++it)
+	{
+		if ((*it)->getStatus() == 1 ) // the listener is connected
 		{
-			std::map<std::string, Listener *>::iterator it = _listeners_by_id.find(*it_strings);
-			if( it != _listeners_by_id.end() )
-			{
-				if ((*(it->second)).getStatus() == 1 ) // the listener is connected
-				{
-					(*(it->second)).write (endPeriod.to_string());
-				}
-			}
-			++it_strings;
+			(*it)->write (endPeriod.to_string());
 		}
 	}
 
@@ -383,77 +242,77 @@ void ClockSys::activateCustomers(int period)
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug(Poco::format("Starting activate Customers %d",period) );
 
-    // Send the messsage to consumer listeners.
-    double new_demand = 0;
-    unsigned num_agents = 0;
-    ListenerType type = CONSUMER;
-    _services_activation.clear();
-
     // Forecast the demand for the new period
-    for(int i=0; i < _services_to_execute.size(); ++i)
+    std::vector<double> forecasts;
+    getForecasts(period, forecasts);
+
+    std::vector<ActivationEngine::Demand> demands;
+    for(std::size_t i=0; i < forecasts.size(); ++i)
     {
-		new_demand = 0;
-		Service * service = getService(_services_to_execute[i]);
-		new_demand = service->getForecast(period);
-		num_agents = service->getRequiredAgents(new_demand);
+		Service * service = _services_to_execute_ptr[i];
+		double new_demand = forecasts[i];
+		unsigned num_agents = service->getRequiredAgents(new_demand);
 
 		app.logger().debug(Poco::format("Demand:%f Num Agents:%d", new_demand, (int) num_agents) );
 
 		if (num_agents > 0)
 		{
-			// Builds the message with the current period
-			Message * activate = new Message();
-			Method method_act = activate_consumer;
-			activate->setMethod(method_act);
-			activate->setParameter("Service", service->getId());
-			activate->setParameter("Period", (int) period);
-			activate->setParameter("Quantity", Poco::NumberFormatter::format(new_demand / num_agents));
-			// Creates the structure.
-			ServiceActivation activation;
-			activation.num_agents = num_agents;
-			activation.message_to_send = activate;
-			_services_activation.insert(std::pair<std::string, ServiceActivation> (service->getId(), activation));
+			ActivationEngine::Demand demand;
+			demand.service = service->getId();
+			demand.agents = num_agents;
+			demand.quantity = new_demand / num_agents;
+			demands.push_back(demand);
 		}
 	}
 
-	Listeners::iterator it;
-	unsigned num_initiated = 0;
-	it = _listeners.begin();
-	while( it != _listeners.end() )
+	// Only the connected consumers, through the index of the type.
+	std::vector<Listener *> list;
+	std::vector<Listener *> consumers;
+	_listeners.getListeners("consumer", list);
+	std::vector<Listener *>::iterator it;
+	for (it = list.begin(); it != list.end(); ++it)
 	{
+		if ((*it)->getStatus() == 1)
+			consumers.push_back(*it);
+	}
 
-		if ( ( (*(it->second)).getStatus() == 1 ) and
-			 ((*(it->second)).getType() == type )  )
-		{
-			// the listener is connected and is consumer.
-
-			 std::cout << "Sending the activation message" << std::endl;
-			 std::cout << "Listener:" << (*(it->second)).getId() << "Status:"
-					  << (*(it->second)).getStatus() << "Type:"
-				      << (*(it->second)).getType() << std::endl;
-
-			Message * message = getActivationMessage();
+	std::vector<ActivationEngine::Assignment> assignments;
+	_activation.assign(consumers, demands, assignments);
 
-			if (message != NULL)
-			{
-				(*(it->second)).write (message->to_string());
-				decreaseActivationMessageCount(message->getParameter("Service"));
-			}
-			else
-			{
-				// All required agents have been activated.
-				break;
-			}
+	// Every message is encoded once, for a demand and a number of units.
+	std::map<std::pair<std::size_t, unsigned>, std::string> encoded;
+	std::vector<ActivationEngine::Assignment>::iterator assignment;
+	for (assignment = assignments.begin(); assignment != assignments.end(); ++assignment)
+	{
+		std::pair<std::size_t, unsigned> key(assignment->demand, assignment->units);
+		std::map<std::pair<std::size_t, unsigned>, std::string>::iterator found = encoded.find(key);
+		if (found == encoded.end())
+		{
+			const ActivationEngine::Demand & demand = demands[assignment->demand];
+			Message activate;
+			Method method_act = activate_consumer;
+			activate.setMethod(method_act);
+			activate.setParameter("Service", demand.service);
+			activate.setParameter("Period", (int) period);
+			activate.setParameter("Quantity", Poco::NumberFormatter::format(demand.quantity * assignment->units));
+			activate.setParameter("Units", (int) assignment->units);
+			if (_virtual == true)
+				activate.setVirtualTime(_virtual_time);
+			found = encoded.insert(std::make_pair(key, activate.to_string())).first;
 		}
-		++it;
+
+		assignment->listener->write(found->second);
+		_pending_acks[assignment->listener->getId()] = period;
+		_awaiting_acks = true;
 	}
 
-	app.logger().debug(Poco::format("Ending activate Customers %d", period) );
+	app.logger().debug(Poco::format("Ending activate Customers %d, %z activations", period, assignments.size()) );
 }
 
 void ClockSys::broadcastPeriodStart(void)
 {
-	Listeners::iterator it;
+	std::vector<Listener *> list;
+	std::vector<Listener *>::iterator it;
 
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug(Poco::format("Start broadcastPeriodStart %d", (int) _period));
@@ -468,25 +327,39 @@ void ClockSys::broadcastPeriodStart(void)
     Method method = start_period;
     startPeriod.setMethod(method);
     startPeriod.setParameter("Period", Poco::NumberFormatter::format(_period));
+    if (_virtual == true)
+		startPeriod.setVirtualTime(_virtual_time);
 
     app.logger().debug(Poco::format("Message: %s", startPeriod.to_string()) );
 
-    it = _listeners.begin();
-	while( it!=_listeners.end() )
+    // The period waits for the market places, the providers and the
+    // consumers activated.
+    _pending_acks.clear();
+    _awaiting_acks = false;
+
+    _listeners.getListeners(list);
+    it = list.begin();
+	while( it!=list.end() )
 	{
-		app.logger().debug(Poco::format("sending message to %s", (it->second)->getId()));
+		app.logger().debug(Poco::format("sending message to %s", (*it)->getId()));
 
-		if ( ( (*(it->second)).getStatus() == 1 ) and
-		     ((*(it->second)).getType() != type )  ){
+		if ( ( (*it)->getStatus() == 1 ) and
+		     ((*it)->getType() != type )  ){
 			// the listener is connected and it is not consumer.
-			(*(it->second)).write (startPeriod.to_string());
+			(*it)->write (startPeriod.to_string());
+			if (((*it)->getType() == MARKET_PLACE) || ((*it)->getType() == PROVIDER))
+			{
+				_pending_acks[(*it)->getId()] = _period;
+				_awaiting_acks = true;
+			}
 		}
 		++it;
 	}
 
     app.logger().debug(Poco::format("Period %d intervals per cycle:%d intervals for cust act:%d", (int) _period, (int) _intervals_per_cycle, (int) _interval_for_customer_activation ));
 
-	if ((_period % _intervals_per_cycle) == _interval_for_customer_activation){
+	// In virtual time the activation is an event of its own.
+	if ((_virtual == false) && ((_period % _intervals_per_cycle) == _interval_for_customer_activation)){
 		activateCustomers(_period / _intervals_per_cycle);
 	}
 
@@ -494,55 +367,10 @@ void ClockSys::broadcastPeriodStart(void)
 
 }
 
-Message * ClockSys::getActivationMessage(void)
-{
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	LogStream lstr(app.logger());
-	lstr << "Start getActivationMessage" << std::endl;
-
-	std::map<std::string, ServiceActivation>::iterator it;
-   it = _services_activation.begin();
-   if (it != _services_activation.end())
-   {
-	 ServiceActivation activation = it->second;
-	 return activation.message_to_send;
-   }
-   else
-   {
-	  return NULL;
-   }
-
-   lstr << "Ending getActivationMessage" << std::endl;
-
-}
-
-void ClockSys::decreaseActivationMessageCount(std::string serviceId)
-{
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	LogStream lstr(app.logger());
-	lstr << "Start decreaseActivationMessageCount" << std::endl;
-
-	std::map<std::string, ServiceActivation>::iterator it;
-	it = _services_activation.find(serviceId);
-	if (it != _services_activation.end())
-	{
-		(it->second).num_agents = (it->second).num_agents - 1;
-		if ((it->second).num_agents <= 0 )
-		{
-			delete (it->second).message_to_send;
-			_services_activation.erase(it);
-		}
-	}
-
-	lstr << "Ending decreaseActivationMessageCount" << std::endl;
-
-}
-
 void ClockSys::broadcastTerminate(void)
 {
-	Listeners::iterator it;
+	std::vector<Listener *> list;
+	std::vector<Listener *>::iterator it;
 
 
 	Poco::Util::Application& app = Poco::Util::Application::instance();
@@ -556,21 +384,22 @@ void ClockSys::broadcastTerminate(void)
     m_disconnect.setMethod(method);
 
     // Send the messsage to all connected listeners.
-	for ( it = _listeners.begin(); it!=_listeners.end(); ++it )
+	_listeners.getListeners(list);
+	for ( it = list.begin(); it!=list.end(); ++it )
 	{
 
-		if ((*(it->second)).getStatus() == 1 ) // the listener is connected
+		if ((*it)->getStatus() == 1 ) // the listener is connected
 		{
 			try
 			{
-				(*(it->second)).write (m_disconnect.to_string());
+				(*it)->write (m_disconnect.to_string());
 			}
 
 			catch (FoundationException &e)
 			{
 				Poco::Util::Application& app = Poco::Util::Application::instance();
 				std::string msg = "The listener ";
-				msg.append((*(it->second)).getId());
+				msg.append((*it)->getId());
 				msg.append("is not listening anymore");
 				app.logger().information( msg );
 				continue;
@@ -617,47 +446,20 @@ void ClockSys::deleteListener( Poco::Net::SocketAddress socketAddress,
 	LogStream lstr(app.logger());
 	lstr << "Start deleteListener" << _period << std::endl;
 
-	// Find the listener
-	Listeners::iterator it;
-	it = _listeners.begin();
-	bool found = false;
-
 	lstr << "Nbr Listeners:" << _listeners.size() << std::endl;
+	lstr << "Sock Address Par:" << socketAddress.toString() << std::endl;
 
-    std::string sockAddrPar = socketAddress.toString();
-
-    lstr << "Sock Address Par:" << sockAddrPar << std::endl;
-
-	while( (it!=_listeners.end()) && (found ==false) )
-	{
-		Poco::Net::SocketAddress sa = (*(it->second)).getSocketAddress();
-		std::string sockAddrStr = sa.toString();
+	// Take the listener out of every index.
+	Listener *listener = _listeners.remove(socketAddress);
 
-		lstr << "Ssock Address:" << sockAddrStr << std::endl;
+    if (listener != NULL){
+		// The period does not wait for it anymore.
+		_pending_acks.erase(listener->getId());
+		_activation.forget(listener->getId());
 
-		if ( sockAddrPar.compare(sockAddrStr) == 0 ){
-		   found = true;
-		   break;
-		}
-		++it;
-	}
-
-    if (found == true){
 		// Disconnect the socket that is waiting for periods
-		Listener *listener = (it->second);
 		listener->Disconnect();
-
-		// Delete from the listeners by type repository.
-		std::map<std::string, Listener *>::iterator listeners_by_id_iter;
-		listeners_by_id_iter = _listeners_by_id.find(listener->getId());
-		if (listeners_by_id_iter != _listeners_by_id.end())
-			_listeners_by_id.erase(listeners_by_id_iter);
-
-		// Delete from the listeners by type repository
-		deleteListenerBytype(listener->getTypeStr(), listener->getId());
-
-		// Erase the agent from the list of listeners
-		_listeners.erase(it);
+		delete listener;
 		messageResponse.setResponseOk();
 	}
 	else
@@ -672,6 +474,121 @@ void ClockSys::deleteListener( Poco::Net::SocketAddress socketAddress,
 
 }
 
+void ClockSys::acknowledgePeriod(Poco::Net::SocketAddress socketAddress, int period,
+							     Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	Listener *listener = _listeners.find(socketAddress);
+	if (listener == NULL)
+	{
+		throw ClockServerException("The agent is not inscribed as listener", 303);
+	}
+
+	std::map<std::string, int>::iterator it = _pending_acks.find(listener->getId());
+	if ((it != _pending_acks.end()) && (it->second == period))
+		_pending_acks.erase(it);
+
+	app.logger().debug(Poco::format("Period %d acknowledged by %s, %z pending",
+							 period, listener->getId(), _pending_acks.size()));
+	messageResponse.setResponseOk();
+}
+
+bool ClockSys::isPeriodAcknowledged(void)
+{
+	return (_awaiting_acks == true) && _pending_acks.empty();
+}
+
+void ClockSys::logActivationStats(void)
+{
+	_activation.logStats();
+}
+
+void ClockSys::startVirtualTime(long interval)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Running in virtual time, interval %ld ms", interval));
+
+	_virtual = true;
+	_virtual_time = 0;
+	_virtual_interval = (Poco::UInt64) interval;
+	_events.schedule(_virtual_interval, CLOCK_END_PERIOD, _period);
+	runEvents();
+}
+
+bool ClockSys::isVirtualTime(void)
+{
+	return _virtual;
+}
+
+Poco::UInt64 ClockSys::getVirtualTime(void)
+{
+	return _virtual_time;
+}
+
+bool ClockSys::isPeriodOpen(void)
+{
+	std::vector<Listener *> list;
+	_listeners.getListeners("market_place", list);
+	if (list.empty() == true)
+		return true;
+
+	return (_pending_acks.empty() == false);
+}
+
+void ClockSys::runEvents(void)
+{
+	while ((_virtual == true) && (_events.empty() == false))
+	{
+		if ((_events.next().type == CLOCK_END_PERIOD) && isPeriodOpen())
+			return;
+
+		ClockEvent event = _events.pop();
+		_virtual_time = event.time;
+
+		switch (event.type)
+		{
+		case CLOCK_END_PERIOD:
+			endVirtualPeriod(event.time);
+			break;
+		case CLOCK_START_PERIOD:
+			broadcastPeriodStart();
+			break;
+		case CLOCK_ACTIVATE_CONSUMER:
+			activateCustomers(event.period);
+			break;
+		}
+	}
+}
+
+void ClockSys::endVirtualPeriod(Poco::UInt64 time)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	broadcastPeriodEnd();
+	incrementInterval();
+	incrementPeriod();
+
+	app.logger().information(Poco::format("Virtual time %Lu ms - Interval:%d Period:%d",
+							 time, _interval, _period));
+
+	if ((_interval * _intervals_per_cycle) <= getBidPeriods())
+	{
+		_events.schedule(time, CLOCK_START_PERIOD, _period);
+		if ((_period % _intervals_per_cycle) == _interval_for_customer_activation)
+			_events.schedule(time, CLOCK_ACTIVATE_CONSUMER, _period / _intervals_per_cycle);
+		_events.schedule(time + _virtual_interval, CLOCK_END_PERIOD, _period);
+	}
+	else
+	{
+		// As part of the termination process all the listeners get a
+		// termination message.
+		_events.clear();
+		Poco::Util::ServerApplication &server = dynamic_cast<Poco::Util::ServerApplication&>(app);
+		server.terminate();
+	}
+}
+
 void ClockSys::getServices(std::string serviceId, Message & messageResponse)
 {
 
@@ -1,6 +1,3 @@
-#include <Poco/Timer.h>
-#include <Poco/Thread.h>
-#include <Poco/Stopwatch.h>
 #include <Poco/Util/ServerApplication.h>
 #include <iostream>
 #include "TimerNotification.h"
@@ -13,20 +10,126 @@ namespace ChoiceNet
 namespace Eco
 {
 
-TimerNotification::TimerNotification(int intervals_per_cycle):
-_intervals_per_cycle(intervals_per_cycle)
+TimerNotification::TimerNotification(WaitingSocketReactor & reactor, long interval,
+									 int intervals_per_cycle, bool barrier):
+_reactor(reactor),
+_interval((Poco::Clock::ClockDiff) interval * 1000),
+_intervals_per_cycle(intervals_per_cycle),
+_barrier(barrier),
+_stop(false),
+_generation(0),
+_finished(false),
+_ticks(0),
+_advanced(0),
+_late_total(0),
+_late_max(0)
 {
-	_sw.start();
 }
 
-void TimerNotification::onEndPeriod(Poco::Timer& timer)
+TimerNotification::~TimerNotification()
+{
+	stop();
+}
+
+void TimerNotification::start()
+{
+	_stop = false;
+	_thread.start(*this);
+}
+
+void TimerNotification::stop()
+{
+	if (_thread.isRunning())
+	{
+		_stop = true;
+		_wakeup.set();
+		_thread.join();
+	}
+}
+
+void TimerNotification::run()
+{
+	Poco::Clock deadline;
+	deadline += _interval;
+	unsigned generation = _generation;
+	bool posted = false;
+
+	while (_stop == false)
+	{
+		if (_barrier == true)
+		{
+			if (_generation != generation)
+			{
+				// A tick was processed, the next period starts now.
+				generation = _generation;
+				deadline = Poco::Clock();
+				deadline += _interval;
+				posted = false;
+			}
+			else if (posted == true)
+			{
+				// Waits for the reactor to process the tick.
+				_wakeup.wait();
+				continue;
+			}
+		}
+
+		Poco::Clock now;
+		if (now < deadline)
+		{
+			// Rounded up, the tick is never posted early.
+			_wakeup.tryWait((long) (((deadline - now) + 999) / 1000));
+			continue;
+		}
+
+		TimerNotification * notification = this;
+		_reactor.post([notification, deadline, generation]()
+		{
+			notification->onEndPeriod(deadline, generation);
+		});
+		if (_barrier == true)
+			posted = true;
+		else
+			deadline += _interval;
+	}
+}
+
+void TimerNotification::advance()
+{
+	if ((_barrier == false) || (_finished == true))
+		return;
+
+	++_advanced;
+	onEndPeriod(Poco::Clock(), _generation);
+}
+
+void TimerNotification::onEndPeriod(Poco::Clock deadline, unsigned generation)
 {
-	int interval_open = 0;
-	int interval_close = 0;
 	int current_period = 0;
 	int current_interval = 0;
 	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information("Starting onEndPeriod");
+
+	// Ticks already posted when the simulation ended.
+	if (_finished == true)
+		return;
+
+	if (_barrier == true)
+	{
+		// The barrier ended the period before the timeout was processed.
+		if (generation != _generation)
+			return;
+		++_generation;
+		_wakeup.set();
+	}
+
+	Poco::Clock now;
+	Poco::Clock::ClockDiff late = now - deadline;
+	++_ticks;
+	_late_total += late;
+	if (late > _late_max)
+		_late_max = late;
+
+	app.logger().information(Poco::format("Starting onEndPeriod, late %Ld us", (Poco::Int64) late));
 
 	// Communicates to all listeners the change in period
 	ClockServer &server = dynamic_cast<ClockServer&>(app);
@@ -44,14 +147,32 @@ void TimerNotification::onEndPeriod(Poco::Timer& timer)
 	if ( (current_interval * _intervals_per_cycle) <= (*clocksys).getBidPeriods())
 		(*clocksys).broadcastPeriodStart();
 	else
+	{
 		// As part of the termination process it is send to all listeners
 		// a termination message.
+		_finished = true;
 		server.terminate();
+	}
 
     app.logger().information("Ending onEndPeriod");
 
 }
 
+void TimerNotification::logStats()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	Poco::Int64 mean = 0;
+	if (_ticks > 0)
+		mean = (Poco::Int64) (_late_total / _ticks);
+
+	app.logger().information(Poco::format("Period ticks: %u, late mean %Ld us, late max %Ld us",
+							 _ticks, mean, (Poco::Int64) _late_max));
+	if (_barrier == true)
+		app.logger().information(Poco::format("Periods ended by the barrier: %u of %u",
+								 _advanced, _ticks));
+}
+
 
 } /// End Eco namespace
 
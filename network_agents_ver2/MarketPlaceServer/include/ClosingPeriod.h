@@ -0,0 +1,64 @@
+#ifndef ClosingPeriod_INCLUDED
+#define ClosingPeriod_INCLUDED
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Bid.h"
+#include "PurchaseInformation.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ClosingPeriod
+/// State of the market frozen at a period boundary. It holds copies of
+/// the bids to broadcast, the purchases of the period and the bids of
+/// every provider, so it can be saved and disseminated while the market
+/// keeps accepting the traffic of the next period.
+{
+public:
+	typedef std::map<std::string, std::vector<std::string> > ProviderBids;
+
+	ClosingPeriod(unsigned period, int executionCount, bool activatePresenter);
+
+	~ClosingPeriod();
+
+	unsigned getPeriod();
+
+	int getExecutionCount();
+
+	bool getActivatePresenter();
+
+	void addBid(Bid * bidPtr);
+		/// Stores a copy of the bid.
+
+	std::vector<Bid *> & getBids();
+
+	void setPurchases(PurchaseInformation * purchases);
+		/// The purchase information is not owned, it is kept in the
+		/// purchase history and is not modified after the period closes.
+
+	PurchaseInformation * getPurchases();
+
+	void addProviderBids(std::string providerId, const ProviderBids & bids);
+
+	std::map<std::string, ProviderBids> & getProviderBids();
+
+private:
+	unsigned _period;
+	int _execution_count;
+	bool _activate_presenter;
+	std::vector<Bid *> _bids;
+	PurchaseInformation * _purchases;
+	std::map<std::string, ProviderBids> _provider_bids;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ClosingPeriod_INCLUDED
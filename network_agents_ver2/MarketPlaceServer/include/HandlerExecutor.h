@@ -0,0 +1,80 @@
+#ifndef HandlerExecutor_INCLUDED
+#define HandlerExecutor_INCLUDED
+
+#include <Poco/Runnable.h>
+#include <Poco/Thread.h>
+#include <Poco/Mutex.h>
+#include <Poco/Condition.h>
+#include <functional>
+#include <deque>
+#include <vector>
+
+#include "Message.h"
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+enum HandlerClass
+{
+	HANDLER_INLINE = 0,		// Executed by the reactor thread.
+	HANDLER_SHARED = 1,		// Read only, offloaded, runs along other shared handlers.
+	HANDLER_EXCLUSIVE = 2	// Offloaded, runs alone.
+};
+
+class HandlerExecutor: public Poco::Runnable
+/// Executes the request handlers that are too expensive for the reactor
+/// thread. Handlers start in arrival order: consecutive shared handlers
+/// run concurrently, an exclusive handler waits for every handler before
+/// it and holds back every handler after it.
+///
+/// Inline handlers are executed by the reactor thread in the same order.
+/// When the executor is idle they run in place, otherwise they take an
+/// exclusive slot that hands the execution back to the reactor thread.
+{
+public:
+	typedef std::function<void()> Task;
+
+	HandlerExecutor(unsigned threads);
+
+	~HandlerExecutor();
+
+	static HandlerClass classify(Method method);
+
+	void submit(HandlerClass handlerClass, const Task & task);
+
+	bool runInline(WaitingSocketReactor & reactor, const Task & task);
+		/// Reactor thread only. Returns true when the task was executed in
+		/// place, false when it was queued.
+
+	void stop();
+		/// Executes every queued handler and joins the threads.
+
+	void run();
+
+private:
+	struct Entry
+	{
+		HandlerClass handlerClass;
+		Task task;
+	};
+
+	Poco::FastMutex _mutex;
+	Poco::Condition _ready;
+	std::deque<Entry> _pending;
+	unsigned _running_shared;
+	bool _running_exclusive;
+	bool _stopped;
+	std::vector<Poco::Thread *> _threads;
+
+	bool canStart();
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // HandlerExecutor_INCLUDED
@@ -0,0 +1,91 @@
+#ifndef MarketCheckpoint_INCLUDED
+#define MarketCheckpoint_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+struct CheckpointResource
+{
+	std::string id;
+	double initial;
+	std::map<unsigned, double> periods;		// Units left in the periods with a deduction
+};
+
+struct CheckpointProvider
+{
+	std::string id;
+	int capacity_type;
+	std::vector<CheckpointResource> resources;
+};
+
+struct CheckpointBid
+{
+	std::string id;
+	std::string provider;
+	std::string service;
+	std::string status;
+	bool active;							// Still in the fronts of its service
+	double unitary_profit;
+	double unitary_cost;
+	std::string parent_bid_id;
+	double capacity;
+	double init_capacity;
+	int creation_period;
+	std::map<std::string, double> decision_variables;
+};
+
+struct CheckpointPurchase
+{
+	std::string service_id;
+	std::string bid_id;
+	double quantity;
+	double quantity_backlog;
+};
+
+struct MarketState
+/// State of the market place at a period boundary.
+{
+	unsigned period;
+	std::vector<CheckpointProvider> providers;
+	std::vector<CheckpointBid> bids;
+	std::map<std::string, int> purchase_requests;
+	std::map<std::string, std::vector<CheckpointPurchase> > purchase_history;
+};
+
+class MarketCheckpoint
+/// Binary image of the market state, written on request at the end of a
+/// period and restored by a market started with it. It is kept in a
+/// SnapshotFile, a file that is truncated or does not match its checksum
+/// is not restored.
+{
+public:
+	static void write(const std::string & path, const MarketState & state);
+		/// Throws a FoundationException when it cannot be written.
+
+	static bool read(const std::string & path, MarketState & state,
+					 std::string & reason);
+		/// False, with the reason, when the file is missing or not valid.
+
+private:
+	enum
+	{
+		VERSION = 1
+	};
+
+	static void encode(const MarketState & state, std::string & payload);
+
+	static bool decode(const char * begin, const char * end, MarketState & state);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MarketCheckpoint_INCLUDED
@@ -0,0 +1,140 @@
+#ifndef MarketJournal_INCLUDED
+#define MarketJournal_INCLUDED
+
+#include <Poco/Runnable.h>
+#include <Poco/Thread.h>
+#include <Poco/Mutex.h>
+#include <Poco/Condition.h>
+#include <Poco/Types.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+enum JournalRecordType
+{
+	JOURNAL_PROVIDER = 'P',				// Provider id, capacity type
+	JOURNAL_REMOVE_PROVIDER = 'X',		// Provider id
+	JOURNAL_AVAILABILITY = 'A',			// Provider id, resource id, quantity
+	JOURNAL_ADD_BID = 'B',				// Bid id, request
+	JOURNAL_DELETE_BID = 'D',			// Bid id, request
+	JOURNAL_PURCHASE = 'U',				// Request
+	JOURNAL_START_PERIOD = 'S',			// Interval
+	JOURNAL_END_PERIOD = 'E',			// Period
+	JOURNAL_PERIOD = 'T',				// Period, only in a compacted journal
+	JOURNAL_BID_CAPACITY = 'C',			// Bid id, capacity left, idem
+	JOURNAL_PURCHASE_REQUESTS = 'R',	// Purchase id, times requested, idem
+	JOURNAL_PERIOD_AVAILABILITY = 'V'	// Provider id, resource id, period, quantity left, idem
+};
+
+struct JournalRecord
+{
+	char type;
+	std::vector<std::string> fields;
+};
+
+class MarketJournal: public Poco::Runnable
+/// Write-ahead journal of the operations changing the state of the market
+/// place, replayed by a market restarted in recovery mode. The records are
+/// framed with their length and checksum and appended to a buffer; a
+/// thread writes and syncs the buffer every flush interval, so many
+/// operations share one sync and the threads handling the requests never
+/// wait on the disk. The operations of the last interval before a crash
+/// may be lost.
+///
+/// The journal is periodically compacted: it is rewritten with the
+/// providers, availabilities and bids it tracks followed by the state
+/// given by the market, which replaces every record before it.
+{
+public:
+	MarketJournal(const std::string & path, long flushInterval);
+		/// The flush interval is in milliseconds.
+
+	~MarketJournal();
+
+	static std::size_t read(const std::string & path, std::vector<JournalRecord> & records);
+		/// Reads the records up to the first incomplete or corrupted one.
+		/// Returns the number of bytes of the valid records, 0 when there is
+		/// no journal.
+
+	void open(std::size_t size);
+		/// Appends to the journal after its first size bytes, the records
+		/// read. Throws a MarketPlaceException when it cannot be opened.
+
+	void start();
+
+	void stop();
+		/// Writes the records buffered and joins the thread.
+
+	void append(char type, const std::vector<std::string> & fields);
+		/// Any thread.
+
+	void track(const JournalRecord & record);
+		/// Keeps a provider, availability or bid record for the next
+		/// compaction without writing it, as when it is replayed.
+
+	void getAvailabilities(std::vector<std::pair<std::string, std::string> > & availabilities);
+		/// Provider and resource of every availability set.
+
+	void forgetBids(const std::set<std::string> & bidIds);
+		/// The bids released by the market are left out of the next
+		/// compaction.
+
+	void compact(const std::vector<JournalRecord> & state);
+		/// Replaces the journal by the records tracked and the state. Called
+		/// with the market quiesced. Throws a MarketPlaceException when the
+		/// journal cannot be written.
+
+	unsigned long getWritten();
+
+	unsigned long getSyncs();
+
+	void run();
+
+private:
+	std::string _path;
+	long _flush_interval;
+	int _fd;
+	bool _stopped;
+
+	// Records buffered, and compactions done. A buffer taken before a
+	// compaction is not written, the compaction includes it.
+	Poco::Mutex _mutex;
+	Poco::Condition _not_empty;
+	std::string _buffer;
+	unsigned long _buffered;
+	unsigned long _generation;
+
+	// Held while the file is written.
+	Poco::FastMutex _file_mutex;
+
+	// Records kept by the compaction, the bid records in arrival order.
+	// Only the last deletion of a bid is kept.
+	std::map<std::string, JournalRecord> _providers;
+	std::map<std::pair<std::string, std::string>, JournalRecord> _availabilities;
+	std::vector<JournalRecord> _bids;
+	std::map<std::string, std::size_t> _bid_deletes;
+
+	unsigned long _written;
+	unsigned long _syncs;
+
+	Poco::Thread _thread;
+
+	void keep(const JournalRecord & record);
+
+	static void encode(const JournalRecord & record, std::string & out);
+
+	void writeAll(int fd, const std::string & data);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MarketJournal_INCLUDED
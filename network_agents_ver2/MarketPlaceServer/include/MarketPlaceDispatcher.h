@@ -0,0 +1,170 @@
+//
+// MarketPlaceDispatcher.h
+//
+//
+// Definition of the MarketPlaceDispatcher class.
+//
+// Copyright (c) 2014, ChoiceNet Project.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef MarketPlaceDispatcher_INCLUDED
+#define MarketPlaceDispatcher_INCLUDED
+
+
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/AutoPtr.h>
+#include <functional>
+
+
+#include "Bid.h"
+#include "Purchase.h"
+#include "Message.h"
+#include "ConnectionChannel.h"
+#include "ServerDispatcher.h"
+#include "WaitingSocketReactor.h"
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class MarketPlaceDispatcher: public ServerDispatcher
+/// Methods answered by the market place and the routing of their requests:
+/// the priority queues, the market shards, the snapshot queries and the
+/// handler executor. Every request is dispatched by the dispatch reactor
+/// thread of the network server.
+{
+public:
+	MarketPlaceDispatcher();
+
+	~MarketPlaceDispatcher();
+
+	void dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+				  unsigned sequence,
+				  Poco::Net::SocketAddress socketAddress,
+				  ChoiceNet::Eco::Message & message);
+		/// Queues the request by priority, or routes it right away when
+		/// there are no priority queues or the agent is not a listener.
+
+	void onReadBatch();
+		/// The changed services and listeners are visible to the query
+		/// threads from now on.
+
+	void onDisconnect(Poco::Net::SocketAddress socketAddress);
+
+	void route(Poco::AutoPtr<ConnectionChannel> channel,
+			   unsigned sequence,
+			   Poco::Net::SocketAddress socketAddress,
+			   ChoiceNet::Eco::Message & message);
+		/// Routes the request to the thread executing it.
+
+	void drainScheduler();
+		/// Dispatch reactor thread only. Dispatches a batch of the queued
+		/// requests by priority.
+
+	void executeOnOwner(Poco::AutoPtr<ConnectionChannel> channel,
+						unsigned sequence,
+						Poco::Net::SocketAddress socketAddress,
+						ChoiceNet::Eco::Message message);
+		/// Dispatch reactor thread only. Executes the request on the thread
+		/// owning its state: the shard of its service, or the reactor thread.
+
+	bool runInline(const std::function<void()> & task);
+		/// Dispatch reactor thread only. Runs the task in place, or after
+		/// the handlers offloaded before it when the handler executor is
+		/// busy. Returns true when it ran in place.
+
+	static bool getShardKey(ChoiceNet::Eco::Message & message,
+							std::string & serviceId);
+
+	static bool isQuery(ChoiceNet::Eco::Method method);
+		/// Read only methods that can be answered from the snapshots.
+
+	static void Connect(Poco::Net::SocketAddress socketAddress,
+						 ChoiceNet::Eco::Message & messageRequest,
+						 ChoiceNet::Eco::Message & messageResponse);
+
+	static void StartListening(Poco::Net::SocketAddress socketAddress,
+						ChoiceNet::Eco::Message & messageRequest,
+						ChoiceNet::Eco::Message & messageResponse);
+
+	static void initializePeriodSession(Poco::Net::SocketAddress socketAddress,
+								 ChoiceNet::Eco::Message & messageRequest,
+								 ChoiceNet::Eco::Message & messageResponse);
+
+	static void finalizePeriodSession(Poco::Net::SocketAddress socketAddress,
+							   ChoiceNet::Eco::Message & messageRequest,
+							   ChoiceNet::Eco::Message & messageResponse);
+
+	static void receiveBid(Poco::Net::SocketAddress socketAddress,
+					ChoiceNet::Eco::Message & messageRequest,
+					ChoiceNet::Eco::Message & messageResponse);
+
+	static void addPurchase( Poco::Net::SocketAddress socketAddress,
+					  ChoiceNet::Eco::Message & messageRequest,
+					  ChoiceNet::Eco::Message & messageResponse);
+
+	static void setProviderAvailability(Poco::Net::SocketAddress socketAddress,
+								 ChoiceNet::Eco::Message & messageRequest,
+								 ChoiceNet::Eco::Message & messageResponse);
+
+	static void getAvailability(Poco::Net::SocketAddress socketAddress,
+						  ChoiceNet::Eco::Message & messageRequest,
+						  ChoiceNet::Eco::Message & messageResponse);
+
+	static void getBestBids( Poco::Net::SocketAddress socketAddress,
+					  ChoiceNet::Eco::Message & messageRequest,
+					  ChoiceNet::Eco::Message & messageResponse);
+
+	static void getBid( Poco::Net::SocketAddress socketAddress,
+					  ChoiceNet::Eco::Message & messageRequest,
+					  ChoiceNet::Eco::Message & messageResponse);
+
+	static void getProviderChannel(Poco::Net::SocketAddress socketAddress,
+							ChoiceNet::Eco::Message & messageRequest,
+							ChoiceNet::Eco::Message & messageResponse);
+
+	static void requestSnapshot(Poco::Net::SocketAddress socketAddress,
+								ChoiceNet::Eco::Message & messageRequest,
+								ChoiceNet::Eco::Message & messageResponse);
+		/// The market state is checkpointed when the current period closes.
+
+	static void terminateProcess(Poco::Net::SocketAddress socketAddress,
+								 ChoiceNet::Eco::Message & messageRequest,
+								 ChoiceNet::Eco::Message & messageResponse);
+
+	static void missingParametersProcedure(ChoiceNet::Eco::Message & messageResponse);
+
+private:
+	bool _publish_pending;		// Dispatch reactor thread only
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // MarketPlaceDispatcher_INCLUDED
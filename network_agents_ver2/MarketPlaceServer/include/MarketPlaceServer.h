@@ -38,6 +38,8 @@
 #include <Poco/Util/HelpFormatter.h>
 #include <iostream>
 #include "MarketPlaceSys.h"
+#include "MarketPlaceDispatcher.h"
+#include "NetworkServer.h"
 
 
 namespace ChoiceNet
@@ -58,6 +60,9 @@ namespace Eco
 		/// Destroy the NetworkQualityServer
 
         MarketPlaceSys* getMarketPlaceSubsystem();
+
+        NetworkServer* getNetworkServer();
+        /// NULL when the server is not listening.
         
 	protected:	
 
@@ -72,13 +77,25 @@ namespace Eco
 		void handleHelp(const std::string& name, 
 						const std::string& value);
 		/// Handles the options for executing the http proxy
+
+		void handleLoadResults(const std::string& name,
+							   const std::string& value);
+		/// Copies the columnar result logs of the directory into the tables
+		/// instead of starting the server.
 		
 		int main(const std::vector<std::string>& args);
 		/// Put to execute the proxy servers with the configuration given
 
 	private:
 		bool _helpRequested;
+		std::string _load_results;
 		MarketPlaceSys * _marketSubsystemPtr;
+		MarketPlaceDispatcher * _dispatcher;
+		NetworkServer * _network;
+
+		int loadResults();
+		/// Writes every .col file of the directory given to --load-results
+		/// to the backend load_results_backend.
 
 	};
 
@@ -10,17 +10,33 @@
 #include <Poco/AutoPtr.h>
 #include <Poco/Types.h>
 #include <Poco/Data/SessionPool.h>
+#include <Poco/Mutex.h>
 #include <vector>
 #include <map>
+#include <set>
+#include <deque>
 #include <iostream>
 
 #include "Bid.h"
 #include "FoundationSys.h"
 #include "Listener.h"
+#include "ListenerRegistry.h"
 #include "BidInformation.h"
 #include "PurchaseInformation.h"
 #include "Provider.h"
 #include "Resource.h"
+#include "MarketShard.h"
+#include "MarketSnapshot.h"
+#include "ClosingPeriod.h"
+#include "PeriodRecord.h"
+#include "PersistenceWriter.h"
+#include "MarketJournal.h"
+#include "MarketCheckpoint.h"
+#include "PurchaseHistory.h"
+#include "HandlerExecutor.h"
+#include "MessageScheduler.h"
+#include "ClientChannel.h"
+#include "WaitingSocketReactor.h"
 
 
 namespace ChoiceNet
@@ -45,16 +61,6 @@ public:
 
 	bool isAlreadyListener(Poco::Net::SocketAddress socketAddress);
 
-	void getMessage(Poco::FIFOBuffer & fifoIn,
-					int len, Message &message );
-
-	bool getMessage(Poco::Net::SocketAddress socketAddress,
-					Message & message);
-
-	void addStagedData(Poco::Net::SocketAddress socketAddress,
-					   Poco::FIFOBuffer & fifoIn,
-					   int len);
-
     void insertListener(std::string idListener,
 					   Poco::Net::SocketAddress socketAddress,
 					   Message & messageResponse );
@@ -67,25 +73,39 @@ public:
 					   ProviderCapacityType capacity_type,
 					   Message & messageResponse );
 
-	void insertListenerBytype(std::string type, std::string listenerId);
 
-	void addAsClockListener(Poco::UInt16 port, std::string type);
+	void connectToClock(WaitingSocketReactor & reactor, Poco::UInt16 port, std::string type);
+		/// Registers the market with the clock server, gets the current
+		/// period and sends the port for the clock periods, without
+		/// waiting for the clock: the responses are handled by the reactor
+		/// thread, and a failure terminates the server.
+
+	void disconnectFromClock(void);
+
+	void acknowledgePeriod(unsigned period);
+		/// Tells the clock server the market completed the period, which
+		/// ends it early when the clock runs in barrier mode. Any thread.
 
 	void initializePeriodSession(unsigned period);
+		/// Acknowledges the period once the work of its start is done,
+		/// including the dissemination of the period it closes.
 
 	void broadCastInformation(Message & message, std::string type);
 
 	void finalizePeriodSession(unsigned  period, Message & messageResponse);
 
-	void sendProviderPurchaseInformation(void);
-
-	void storeCurrentPurchaseInformation(void);
+	void sendProviderPurchaseInformation(ClosingPeriod * closing);
 
-	void addBid(Bid * bidPtr, Message & messageResponse);
+	void addBid(Bid * bidPtr, const std::string & request, Message & messageResponse);
+		/// The request is the message of the bid, journaled under the lock
+		/// of the bids once it is added.
 
-	void deleteBid(Bid * bidPtr, Message & messageResponse);
+	void deleteBid(Bid * bidPtr, const std::string & request, Message & messageResponse);
 
-	void addPurchase(Purchase * purchasePtr, Message & messageResponse);
+	void addPurchase(Purchase * purchasePtr, const std::string & request, Message & messageResponse);
+		/// The request is journaled in the order the purchases draw on
+		/// the capacity: under the availability lock for bulk capacity,
+		/// by the thread owning the service otherwise.
 
 	void setProviderAvailability(std::string providerId,
 							     std::string resourceId,
@@ -111,72 +131,192 @@ public:
 
     Bid * getBid(std::string bidId);
 
-	void addPurchaseBulkCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, Message & messageResponse);
+    bool getBidService(std::string bidId, std::string & serviceId);
+
+    MarketShardPool * getShardPool(void);
+
+    void initializeShards(unsigned shards);
+
+    void quiesceShards(void);
+
+    MarketShardPool * getQueryPool(void);
+
+    HandlerExecutor * getHandlerExecutor(void);
+
+    MessageScheduler * getMessageScheduler(void);
+
+    void initializeSnapshots(unsigned query_threads);
+
+    void markServiceChanged(std::string serviceId);
+
+    void publishSnapshots(void);
+		/// Also publishes the listener directory when agents connected or
+		/// disconnected since the last call.
 
-	void addPurchaseByBidCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, Message & messageResponse);
+    void publishShardSnapshots(unsigned shard);
+
+    void publishListenerDirectory(void);
+
+    bool answerFromSnapshot(Message & messageRequest, Message & messageResponse);
+
+	void addPurchaseBulkCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, const std::string & request, Message & messageResponse);
+
+	void addPurchaseByBidCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, const std::string & request, Message & messageResponse);
 
 	// Specificates if the information should be transmited to the provider.
 	bool sendInformation(unsigned interval);
 
-	void saveInformation();
+	void saveInformation(ClosingPeriod * closing);
+		/// Builds the period record and hands it to the persistence
+		/// writer, or stores it in place when there is no writer.
 
-	void disseminateInformation();
+	void disseminateInformation(ClosingPeriod * closing);
 
 	void reinitiateDataContainers(MARKET_HISTORY_PERIOD subperiod);
 
-    void saveBidInformation(void);
+	ClosingPeriod * freezePeriod(bool activatePresenter);
+		/// Copies the state of the period being closed. Called by the
+		/// reactor thread with the shards quiesced.
 
-    void broadCastBidInformation(void);
+	void closePeriod(MARKET_HISTORY_PERIOD subperiod, bool activatePresenter);
+		/// Freezes the period, starts the next one and hands the frozen
+		/// period to the pipeline (or processes it in place when the
+		/// pipeline is disabled).
 
-    void activatePresenter(void);
+	void processClosingPeriod(ClosingPeriod * closing);
+
+    void broadCastBidInformation(ClosingPeriod * closing);
+
+    void activatePresenter(unsigned period);
 
     void getBulkAvailability(Provider *provider, Service *service, Message & messageResponse);
 
     void getBidAvailability(Provider *provider, Service *service, Bid *bid, Message & messageResponse);
 
+    void journal(char type, const std::vector<std::string> & fields);
+        /// Appends a record to the journal, when there is one. Called once
+        /// the operation changed the state of the market.
+
+    void requestCheckpoint(std::string path, Message & messageResponse);
+        /// The market state is written to the path, or to the configured
+        /// one when it is empty, once the current period is closed. Any
+        /// thread.
+
 protected:
     virtual const char* name() const;
-    void sendMessageToClock(Message & message, Message & response);
+
+    bool isClockResponseOk(bool received, Message & response, const std::string & request);
+        /// Terminates the server when the clock did not accept the request.
 
 private:
     std::string p_cName;
-    Poco::Net::StreamSocket *_clockSocket;
+    Poco::AutoPtr<ClientChannel> _clock;
 
-    // Container for listeners
-    typedef std::map<Poco::Net::SocketAddress, Listener*> Listeners;
-    Listeners _listeners;
+    // Container for listeners, indexed by address, id and type.
+    ListenerRegistry _listeners;
 
-    // These two containers act as indexes for the listeners container.
-    std::map<std::string, std::vector<std::string> > _listeners_by_type;
-    std::map<std::string, Listener *> _listeners_by_id;
     std::map<std::string, Provider *> _providers;
 
     BidInformation *_current_bids;
 
     PurchaseInformation *_current_purchases;
 
-    typedef std::map<std::string, Purchase *> PurchaseContainer;
-
 	// This map contains all purchases requested by users,
 	// with the number of trials to purchase. Every time that a new purchase arrive
 	// the system look for its id in this map, if already exists an entry,
 	// the system updates the number of request. Otherwise creates a new entry.
 	std::map<std::string, int> request_purchases;
 
-    PurchaseContainer _purchases;
-
     typedef std::map<std::string, Bid *> BidContainer;
     BidContainer _bids; // This Holds all bids
     BidContainer _bids_to_broadcast; // Bids received in the current period and need to be broadcasted
 
-    typedef std::map<std::string, PurchaseInformation*> PurchaseHistory;
     PurchaseHistory _purchase_history;
 
+	// Retention of the past periods, 0 keeps them all. Besides the
+	// purchase history, the bids out of the fronts and the purchase
+	// requests first seen more than _retention_periods periods ago are
+	// released when a period is closed.
+	unsigned _retention_periods;
+
+	struct DeletedBid
+	{
+		unsigned period;
+		std::string id;
+		Bid * request;		// Bid of the deletion request
+	};
+	std::deque<DeletedBid> _deleted_bids;		// Under _bids_mutex
+	std::deque<std::pair<unsigned, std::string> > _purchase_request_periods;	// Under _purchases_mutex
+
+	void releaseExpiredState(void);
+
 	unsigned _period;
 	unsigned _intervals_per_cycle;
 	unsigned _send_interval;
 
-	Poco::Data::SessionPool * _pool;
+	// Sharded execution. When it is enabled the per-service state is owned
+	// by the shard threads and these mutexes protect the containers that
+	// are shared between services.
+	MarketShardPool * _shards;
+	Poco::FastMutex _bids_mutex;		// _bids and _bids_to_broadcast
+	Poco::FastMutex _purchases_mutex;	// request_purchases
+	Poco::FastMutex _providers_mutex;	// _providers
+	Poco::FastMutex _availability_mutex; // Provider resource availability
+
+	// Read path. Query methods are answered by the query threads from the
+	// published snapshots. Changed services are recorded by the thread
+	// owning them (the shard, or the reactor when there are no shards)
+	// and republished when that thread finishes its batch of work.
+	MarketSnapshots * _snapshots;
+	MarketShardPool * _query_workers;
+	std::vector<std::set<std::string> > _changed_services;
+
+	void publishChangedServices(unsigned owner);
+
+	// Period pipeline. A single thread saving and disseminating the closed
+	// periods, while the reactor keeps taking the next period. The pipeline
+	// reads the listeners, which are modified by the reactor under
+	// _listeners_mutex.
+	MarketShardPool * _period_pipeline;
+	Poco::FastMutex _listeners_mutex;
+	bool _listeners_changed;			// Under _listeners_mutex
+
+	// Writer storing the closed periods in the database.
+	PersistenceWriter * _persistence;
+
+	// Rows of a closed period written by every insert statement.
+	std::size_t _insert_chunk;
+
+	// Write-ahead journal of the market state, compacted every
+	// _journal_compact_periods closed periods. While it is replayed
+	// nothing is journaled and the closed periods are not processed again.
+	MarketJournal * _journal;
+	unsigned _journal_compact_periods;
+	unsigned _periods_since_compaction;
+	bool _recovering;
+
+	void initializeJournal(const std::string & path, bool recover, long flushInterval);
+
+	void replay(const JournalRecord & record);
+
+	void compactJournal(void);
+
+	// Checkpoint requested, written by the next period closed.
+	Poco::FastMutex _checkpoint_mutex;
+	std::string _checkpoint_path;
+	std::string _checkpoint_request;
+
+	void writeCheckpoint(const std::string & path);
+		/// Called with the market quiesced, right after a period is closed.
+
+	void restoreCheckpoint(const std::string & path);
+		/// Throws a MarketPlaceException when the checkpoint is not valid.
+
+	// Threads executing the request handlers offloaded from the reactor.
+	HandlerExecutor * _handlers;
+
+	// Priority queues of the requests read by the reactor.
+	MessageScheduler * _scheduler;
 
 };
 
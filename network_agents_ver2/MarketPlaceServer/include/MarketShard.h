@@ -0,0 +1,108 @@
+#ifndef MarketShard_INCLUDED
+#define MarketShard_INCLUDED
+
+#include <Poco/Runnable.h>
+#include <Poco/Thread.h>
+#include <Poco/Notification.h>
+#include <Poco/NotificationQueue.h>
+#include <Poco/AtomicCounter.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class MarketShardTask: public Poco::Notification
+/// Unit of work queued to a market shard.
+{
+public:
+	typedef std::function<void()> Task;
+
+	MarketShardTask(const Task & task);
+
+	void execute();
+
+private:
+	Task _task;
+};
+
+
+class MarketShard: public Poco::Runnable
+/// Worker thread that owns the per-service state (bids and purchases)
+/// of the services hashed to it. Every request for those services is
+/// executed by this thread in arrival order.
+{
+public:
+	MarketShard(unsigned index);
+
+	~MarketShard();
+
+	void start();
+
+	void stop();
+
+	void post(const MarketShardTask::Task & task);
+
+	void setIdleHandler(const std::function<void(unsigned)> & handler);
+		/// The handler is called by the shard thread every time its queue
+		/// becomes empty, that is at the end of each batch of work.
+
+	int queued();
+
+	unsigned getIndex();
+
+	void run();
+
+private:
+	unsigned _index;
+	bool _stopped;
+	std::function<void(unsigned)> _idle_handler;
+	Poco::NotificationQueue _queue;
+	Poco::Thread _thread;
+};
+
+
+class MarketShardPool
+/// Set of market shards. Services are assigned to shards by hashing the
+/// service id, so a given service is always processed by the same thread.
+{
+public:
+	MarketShardPool(unsigned shards);
+
+	~MarketShardPool();
+
+	unsigned size();
+
+	unsigned getShardIndex(const std::string & serviceId);
+
+	void post(const std::string & serviceId, const MarketShardTask::Task & task);
+
+	void post(const MarketShardTask::Task & task);
+		/// Posts work that is not bound to a service, shards are taken
+		/// in round robin.
+
+	void setIdleHandler(const std::function<void(unsigned)> & handler);
+
+	void barrier();
+		/// Blocks until every shard has executed all the work queued
+		/// before the call. Used around period transitions, while the
+		/// caller is the only thread producing work for the shards.
+
+	void stop();
+
+private:
+	std::vector<MarketShard *> _shards;
+	bool _stopped;
+	Poco::AtomicCounter _next_shard;
+	std::hash<std::string> _hash;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MarketShard_INCLUDED
@@ -0,0 +1,114 @@
+#ifndef MarketSnapshot_INCLUDED
+#define MarketSnapshot_INCLUDED
+
+#include <memory>
+#include <string>
+#include <map>
+
+#include "Bid.h"
+#include "Message.h"
+#include "Provider.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ServiceSnapshot
+/// Immutable view of a service: the best bids message and the table of
+/// active bids. It is built by the thread owning the service and read
+/// by the query threads without any lock.
+{
+public:
+	ServiceSnapshot(std::string serviceId, std::string bestBids, int fronts);
+
+	void addBid(Bid * bidPtr);
+		/// Only used while the snapshot is being built.
+
+	std::string getServiceId() const;
+
+	const std::string & getBestBids() const;
+
+	int getFronts() const;
+
+	bool getBid(const std::string & bidId, Message & message) const;
+
+	bool getBidCapacity(const std::string & bidId, double & capacity) const;
+
+private:
+	struct BidEntry
+	{
+		Message message;
+		double capacity;
+	};
+
+	std::string _service_id;
+	std::string _best_bids;
+	int _fronts;
+	std::map<std::string, BidEntry> _bids;
+};
+
+
+class ListenerDirectory
+/// Immutable view of the listeners channels and provider capacity types.
+{
+public:
+	void addListener(std::string listenerId, std::string address,
+					 std::string port, bool connected);
+
+	void addProvider(std::string providerId, ProviderCapacityType capacityType);
+
+	bool getChannel(const std::string & listenerId,
+					std::string & address, std::string & port) const;
+
+	bool getCapacityType(const std::string & providerId,
+						 ProviderCapacityType & capacityType) const;
+
+private:
+	struct Channel
+	{
+		std::string address;
+		std::string port;
+		bool connected;
+	};
+
+	std::map<std::string, Channel> _channels;
+	std::map<std::string, ProviderCapacityType> _capacity_types;
+};
+
+
+class MarketSnapshots
+/// Holder of the last published snapshots. Writers replace a snapshot
+/// with an atomic store, readers keep the one they loaded alive through
+/// the shared pointer for as long as they use it.
+{
+public:
+	typedef std::shared_ptr<const ServiceSnapshot> ServiceSnapshotPtr;
+	typedef std::shared_ptr<const ListenerDirectory> ListenerDirectoryPtr;
+
+	MarketSnapshots();
+
+	~MarketSnapshots();
+
+	void addService(std::string serviceId);
+		/// Registers a service. Must be done before the readers start.
+
+	ServiceSnapshotPtr getService(const std::string & serviceId) const;
+
+	void publishService(const ServiceSnapshotPtr & snapshot);
+
+	ListenerDirectoryPtr getListeners() const;
+
+	void publishListeners(const ListenerDirectoryPtr & directory);
+
+private:
+	std::map<std::string, ServiceSnapshotPtr> _services;
+	ListenerDirectoryPtr _listeners;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MarketSnapshot_INCLUDED
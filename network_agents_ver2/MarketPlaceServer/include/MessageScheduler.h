@@ -0,0 +1,108 @@
+#ifndef MessageScheduler_INCLUDED
+#define MessageScheduler_INCLUDED
+
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Types.h>
+#include <functional>
+#include <deque>
+
+#include "Message.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+enum MessagePriority
+{
+	PRIORITY_CONTROL = 0,	// Clock and connection management.
+	PRIORITY_PURCHASE = 1,
+	PRIORITY_BID = 2,
+	PRIORITY_QUERY = 3,
+	PRIORITY_CLASSES = 4
+};
+
+class MessageScheduler
+/// Per priority class queues of the requests read by the reactor. The
+/// requests are dispatched by class, highest first, except that a request
+/// waiting longer than the maximum wait goes first to avoid starvation.
+/// The control class is never rejected, the other classes are bounded.
+///
+/// A period transition is a barrier: it is only dispatched once the
+/// requests of every class queued before it are, and nothing queued after
+/// it goes first. The orders sent during a period are so counted in it.
+/// While a barrier is queued the requests of the lower classes are
+/// rejected, so the transition waits at most for the bounded queues.
+{
+public:
+	typedef std::function<void()> Task;
+
+	MessageScheduler(std::size_t capacity, unsigned batch,
+					 Poco::Timestamp::TimeDiff maxWait);
+		/// maxWait is given in microseconds.
+
+	~MessageScheduler();
+
+	static MessagePriority classify(Method method);
+
+	static bool isBarrier(Method method);
+		/// True for the period transitions.
+
+	static std::string getClassName(MessagePriority priority);
+
+	bool push(MessagePriority priority, bool barrier, const Task & task);
+		/// Returns false when the queue of the class is full, or when a
+		/// barrier is queued and the class is not control. A barrier
+		/// must be in the control class.
+
+	bool pop(Task & task, MessagePriority & priority);
+		/// Takes the next request to dispatch, false when they are empty.
+
+	std::size_t size();
+
+	unsigned getBatch();
+
+	bool setDrainPending(bool pending);
+		/// Sets the flag and returns the previous value.
+
+	void logStats();
+		/// Logs the queue delay by class since the last call and resets it.
+
+private:
+	struct Entry
+	{
+		Task task;
+		Poco::Timestamp queued;
+		Poco::UInt64 sequence;
+		bool barrier;
+	};
+
+	struct ClassStats
+	{
+		unsigned long dispatched;
+		unsigned long rejected;
+		Poco::Timestamp::TimeDiff total_delay;
+		Poco::Timestamp::TimeDiff max_delay;
+	};
+
+	std::size_t _capacity;
+	unsigned _batch;
+	Poco::Timestamp::TimeDiff _max_wait;
+	bool _drain_pending;
+
+	Poco::FastMutex _mutex;
+	std::deque<Entry> _queues[PRIORITY_CLASSES];
+	ClassStats _stats[PRIORITY_CLASSES];
+	Poco::UInt64 _next_sequence;
+	std::deque<Poco::UInt64> _barriers;		// Sequences of the barriers queued
+
+	void resetStats();
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MessageScheduler_INCLUDED
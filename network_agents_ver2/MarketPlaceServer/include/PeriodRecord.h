@@ -0,0 +1,90 @@
+#ifndef PeriodRecord_INCLUDED
+#define PeriodRecord_INCLUDED
+
+#include <Poco/Timestamp.h>
+#include <string>
+#include <vector>
+
+#include "Bid.h"
+#include "PurchaseInformation.h"
+#include "BulkInsert.h"
+#include "StorageBackend.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class PeriodRecord
+/// Rows to store for a closed period: bids, their decision variables and
+/// the purchases by bid. The record is filled when the period closes and
+/// does not reference the market state afterwards, so it can be written
+/// by another thread at any later time. The rows go straight into their
+/// tables with multi-row inserts of at most insertChunk rows.
+{
+public:
+	PeriodRecord(unsigned period, int executionCount, std::size_t insertChunk);
+
+	~PeriodRecord();
+
+	unsigned getPeriod();
+
+	const Poco::Timestamp & getCreated();
+		/// Time the period was closed, used to measure the writer lag.
+
+	std::size_t size();
+		/// Number of rows in the record.
+
+	void addBid(Bid * bidPtr);
+
+	void addPurchases(PurchaseInformation * purchases);
+
+	void store(StorageBackend & storage);
+		/// Writes every row of the record in one transaction.
+
+private:
+	unsigned _period;
+	int _execution_count;
+	std::size_t _insert_chunk;
+	Poco::Timestamp _created;
+
+	// Bid rows, one vector per column.
+	std::vector<int> _bid_period;
+	std::vector<std::string> _bid_id;
+	std::vector<std::string> _bid_provider;
+	std::vector<int> _bid_status;
+	std::vector<int> _bid_pareto_status;
+	std::vector<int> _bid_dominated_count;
+	std::vector<int> _bid_execution_count;
+	std::vector<double> _bid_unitary_profit;
+	std::vector<double> _bid_unitary_cost;
+	std::vector<std::string> _bid_parent_id;
+	std::vector<double> _bid_capacity;
+	std::vector<double> _bid_init_capacity;
+	std::vector<int> _bid_creation_period;
+
+	// Decision variable rows.
+	std::vector<std::string> _dv_bid_id;
+	std::vector<std::string> _dv_variable_id;
+	std::vector<double> _dv_value;
+	std::vector<int> _dv_execution_count;
+
+	// Purchase rows.
+	std::vector<int> _pur_period;
+	std::vector<std::string> _pur_service_id;
+	std::vector<std::string> _pur_bid_id;
+	std::vector<double> _pur_quantity;
+	std::vector<double> _pur_quantity_backlog;
+	std::vector<int> _pur_execution_count;
+
+	void addBidInserts(std::vector<BulkInsert *> & inserts);
+
+	void addPurchaseInserts(std::vector<BulkInsert *> & inserts);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // PeriodRecord_INCLUDED
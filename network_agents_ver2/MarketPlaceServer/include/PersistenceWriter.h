@@ -0,0 +1,88 @@
+#ifndef PersistenceWriter_INCLUDED
+#define PersistenceWriter_INCLUDED
+
+#include <Poco/Runnable.h>
+#include <Poco/Thread.h>
+#include <Poco/Mutex.h>
+#include <Poco/Condition.h>
+#include <Poco/Timestamp.h>
+#include <deque>
+
+#include "PeriodRecord.h"
+#include "StorageBackend.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+enum PersistenceMode
+{
+	PERSISTENCE_BLOCK = 0,	// The producer waits while the queue is full.
+	PERSISTENCE_DROP = 1	// Records arriving with the queue full are discarded.
+};
+
+class PersistenceWriter: public Poco::Runnable
+/// Thread storing period records in the storage backend. Records are queued by
+/// the thread closing the periods, which never waits on the storage
+/// unless the queue is full and the mode is PERSISTENCE_BLOCK.
+{
+public:
+	PersistenceWriter(StorageBackend * storage, std::size_t capacity,
+					  PersistenceMode mode);
+
+	~PersistenceWriter();
+
+	void start();
+
+	void stop();
+		/// Writes every queued record and joins the thread.
+
+	bool enqueue(PeriodRecord * record);
+		/// Takes the ownership of the record. Returns false when the record
+		/// was dropped.
+
+	std::size_t queued();
+
+	unsigned long getWritten();
+
+	unsigned long getDropped();
+
+	unsigned long getFailed();
+
+	Poco::Timestamp::TimeDiff getLastLag();
+		/// Microseconds between the closing of the last written period and
+		/// the end of its write.
+
+	Poco::Timestamp::TimeDiff getMaxLag();
+
+	void run();
+
+private:
+	StorageBackend * _storage;
+	std::size_t _capacity;
+	PersistenceMode _mode;
+	bool _stopped;
+
+	Poco::Mutex _mutex;
+	Poco::Condition _not_empty;
+	Poco::Condition _not_full;
+	std::deque<PeriodRecord *> _queue;
+
+	unsigned long _written;
+	unsigned long _dropped;
+	unsigned long _failed;
+	Poco::Timestamp::TimeDiff _last_lag;
+	Poco::Timestamp::TimeDiff _max_lag;
+
+	Poco::Thread _thread;
+
+	void write(PeriodRecord * record);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // PersistenceWriter_INCLUDED
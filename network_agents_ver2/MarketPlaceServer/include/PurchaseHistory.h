@@ -0,0 +1,78 @@
+#ifndef PurchaseHistory_INCLUDED
+#define PurchaseHistory_INCLUDED
+
+#include <Poco/Types.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "PurchaseInformation.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class PurchaseHistory
+/// Purchases of the closed periods, keyed by period and subperiod. With a
+/// retention the last periods are kept in memory and the older ones are
+/// appended to a spill segment on disk, or released when there is none:
+/// their rows were already handed to the storage when they were closed.
+/// Reactor thread only.
+{
+public:
+	PurchaseHistory();
+
+	~PurchaseHistory();
+
+	void setRetention(unsigned periods, const std::string & spillPath);
+		/// 0 keeps every period in memory. At least two periods are kept,
+		/// the previous one may still be disseminated. The segment is
+		/// created empty; throws a MarketPlaceException when it cannot be.
+
+	void add(const std::string & key, PurchaseInformation * purchases);
+		/// Takes the purchases and spills or releases the periods beyond
+		/// the retention. A period added again hides the earlier one.
+
+	bool getPurchases(const std::string & key, std::vector<PurchaseServiceBidStruct> & rows);
+		/// Rows of the period, from memory or from the segment, without
+		/// their period and execution count. False when the period is
+		/// unknown or was released.
+
+	void getPeriods(std::vector<std::string> & keys);
+		/// Periods that can be looked up, in the order they were closed.
+
+	std::size_t getHotPeriods(void);
+
+	std::size_t getSpilledPeriods(void);
+
+private:
+	typedef std::pair<std::string, PurchaseInformation *> Entry;
+
+	struct Location
+	{
+		Poco::UInt64 offset;
+		Poco::UInt32 size;
+	};
+
+	unsigned _retention;
+	std::string _spill_path;
+	int _spill_fd;
+	Poco::UInt64 _spill_size;
+
+	std::deque<Entry> _hot;					// In closing order
+	std::vector<std::string> _spilled_order;
+	std::map<std::string, Location> _spilled;
+
+	void evict(void);
+
+	void spill(const Entry & entry);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // PurchaseHistory_INCLUDED
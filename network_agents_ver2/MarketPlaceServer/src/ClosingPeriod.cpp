@@ -0,0 +1,75 @@
+#include "ClosingPeriod.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ClosingPeriod::ClosingPeriod(unsigned period, int executionCount, bool activatePresenter):
+_period(period),
+_execution_count(executionCount),
+_activate_presenter(activatePresenter),
+_purchases(NULL)
+{
+}
+
+ClosingPeriod::~ClosingPeriod()
+{
+	std::vector<Bid *>::iterator it;
+	for (it = _bids.begin(); it != _bids.end(); ++it)
+	{
+		delete *it;
+	}
+	_bids.clear();
+	_purchases = NULL;
+}
+
+unsigned ClosingPeriod::getPeriod()
+{
+	return _period;
+}
+
+int ClosingPeriod::getExecutionCount()
+{
+	return _execution_count;
+}
+
+bool ClosingPeriod::getActivatePresenter()
+{
+	return _activate_presenter;
+}
+
+void ClosingPeriod::addBid(Bid * bidPtr)
+{
+	_bids.push_back(new Bid(*bidPtr));
+}
+
+std::vector<Bid *> & ClosingPeriod::getBids()
+{
+	return _bids;
+}
+
+void ClosingPeriod::setPurchases(PurchaseInformation * purchases)
+{
+	_purchases = purchases;
+}
+
+PurchaseInformation * ClosingPeriod::getPurchases()
+{
+	return _purchases;
+}
+
+void ClosingPeriod::addProviderBids(std::string providerId, const ProviderBids & bids)
+{
+	_provider_bids.insert(std::pair<std::string, ProviderBids>(providerId, bids));
+}
+
+std::map<std::string, ClosingPeriod::ProviderBids> & ClosingPeriod::getProviderBids()
+{
+	return _provider_bids;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
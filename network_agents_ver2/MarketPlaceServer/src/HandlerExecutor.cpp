@@ -0,0 +1,222 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Exception.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/Event.h>
+#include <memory>
+#include <exception>
+
+#include "HandlerExecutor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+HandlerExecutor::HandlerExecutor(unsigned threads):
+_running_shared(0),
+_running_exclusive(false),
+_stopped(false)
+{
+	for (unsigned i = 0; i < threads; ++i)
+	{
+		Poco::Thread * thread = new Poco::Thread("HandlerExecutor" + Poco::NumberFormatter::format(i));
+		_threads.push_back(thread);
+		thread->start(*this);
+	}
+}
+
+HandlerExecutor::~HandlerExecutor()
+{
+	stop();
+
+	std::vector<Poco::Thread *>::iterator it;
+	for (it = _threads.begin(); it != _threads.end(); ++it)
+	{
+		delete *it;
+	}
+	_threads.clear();
+}
+
+HandlerClass HandlerExecutor::classify(Method method)
+{
+	switch (method){
+	   case start_period:
+	   case end_period:
+		   return HANDLER_EXCLUSIVE;
+	   case get_best_bids:
+	   case get_bid:
+	   case get_availability:
+	   case get_provider_channel:
+		   return HANDLER_SHARED;
+	   default:
+		   return HANDLER_INLINE;
+	}
+}
+
+void HandlerExecutor::submit(HandlerClass handlerClass, const Task & task)
+{
+	Entry entry;
+	entry.handlerClass = handlerClass;
+	entry.task = task;
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_pending.push_back(entry);
+	_ready.broadcast();
+}
+
+bool HandlerExecutor::runInline(WaitingSocketReactor & reactor, const Task & task)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_stopped || !(_pending.empty() && (_running_shared == 0) && (_running_exclusive == false)))
+		{
+			// Take an exclusive slot and run the task on the reactor thread
+			// when the slot is reached.
+			std::shared_ptr<Poco::Event> done(new Poco::Event());
+			Entry entry;
+			entry.handlerClass = HANDLER_EXCLUSIVE;
+			entry.task = [this, &reactor, task, done]()
+			{
+				reactor.post([task, done]()
+				{
+					try
+					{
+						task();
+					}
+					catch (Poco::Exception &e)
+					{
+						Poco::Util::Application& app = Poco::Util::Application::instance();
+						app.logger().error(Poco::format("Inline handler failed: %s", e.displayText()));
+					}
+					catch (std::exception &e)
+					{
+						Poco::Util::Application& app = Poco::Util::Application::instance();
+						app.logger().error(Poco::format("Inline handler failed: %s", std::string(e.what())));
+					}
+					catch (...)
+					{
+						Poco::Util::Application& app = Poco::Util::Application::instance();
+						app.logger().error("Inline handler failed: unknown error");
+					}
+					done->set();
+				});
+
+				// Give up when the reactor is no longer running tasks.
+				while (!done->tryWait(100))
+				{
+					Poco::FastMutex::ScopedLock lock(_mutex);
+					if (_stopped)
+						break;
+				}
+			};
+			_pending.push_back(entry);
+			_ready.broadcast();
+			return false;
+		}
+		_running_exclusive = true;
+	}
+
+	try
+	{
+		task();
+	}
+	catch (Poco::Exception &e)
+	{
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		app.logger().error(Poco::format("Inline handler failed: %s", e.displayText()));
+	}
+	catch (std::exception &e)
+	{
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		app.logger().error(Poco::format("Inline handler failed: %s", std::string(e.what())));
+	}
+	catch (...)
+	{
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		app.logger().error("Inline handler failed: unknown error");
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_running_exclusive = false;
+	_ready.broadcast();
+	return true;
+}
+
+void HandlerExecutor::stop()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_stopped)
+			return;
+		_stopped = true;
+		_ready.broadcast();
+	}
+
+	std::vector<Poco::Thread *>::iterator it;
+	for (it = _threads.begin(); it != _threads.end(); ++it)
+	{
+		(*it)->join();
+	}
+}
+
+bool HandlerExecutor::canStart()
+{
+	if (_pending.empty() || _running_exclusive)
+		return false;
+	if (_pending.front().handlerClass == HANDLER_SHARED)
+		return true;
+	return (_running_shared == 0);
+}
+
+void HandlerExecutor::run()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	for (;;)
+	{
+		while (!canStart() && !(_stopped && _pending.empty()))
+			_ready.wait(_mutex);
+
+		if (_pending.empty())
+			break;
+
+		Entry entry = _pending.front();
+		_pending.pop_front();
+		if (entry.handlerClass == HANDLER_SHARED)
+			++_running_shared;
+		else
+			_running_exclusive = true;
+
+		_mutex.unlock();
+		try
+		{
+			entry.task();
+		}
+		catch (Poco::Exception &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(Poco::format("Handler failed: %s", e.displayText()));
+		}
+		catch (std::exception &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(Poco::format("Handler failed: %s", std::string(e.what())));
+		}
+		catch (...)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error("Handler failed: unknown error");
+		}
+		_mutex.lock();
+
+		if (entry.handlerClass == HANDLER_SHARED)
+			--_running_shared;
+		else
+			_running_exclusive = false;
+		_ready.broadcast();
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
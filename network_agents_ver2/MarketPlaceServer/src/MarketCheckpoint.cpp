@@ -0,0 +1,189 @@
+#include "MarketCheckpoint.h"
+#include "SnapshotFile.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+static const char MARKET_CHECKPOINT_MAGIC[8] = { 'E', 'C', 'O', 'M', 'K', 'T', '0', '1' };
+
+void MarketCheckpoint::encode(const MarketState & state, std::string & payload)
+{
+	SnapshotWriter out(payload);
+
+	out.putInt((int) state.period);
+
+	out.putCount(state.providers.size());
+	for (std::size_t i = 0; i < state.providers.size(); ++i)
+	{
+		const CheckpointProvider & provider = state.providers[i];
+		out.putString(provider.id);
+		out.putInt(provider.capacity_type);
+		out.putCount(provider.resources.size());
+		for (std::size_t j = 0; j < provider.resources.size(); ++j)
+		{
+			const CheckpointResource & resource = provider.resources[j];
+			out.putString(resource.id);
+			out.putDouble(resource.initial);
+			out.putCount(resource.periods.size());
+			std::map<unsigned, double>::const_iterator it;
+			for (it = resource.periods.begin(); it != resource.periods.end(); ++it)
+			{
+				out.putInt((int) it->first);
+				out.putDouble(it->second);
+			}
+		}
+	}
+
+	out.putCount(state.bids.size());
+	for (std::size_t i = 0; i < state.bids.size(); ++i)
+	{
+		const CheckpointBid & bid = state.bids[i];
+		out.putString(bid.id);
+		out.putString(bid.provider);
+		out.putString(bid.service);
+		out.putString(bid.status);
+		out.putInt(bid.active ? 1 : 0);
+		out.putDouble(bid.unitary_profit);
+		out.putDouble(bid.unitary_cost);
+		out.putString(bid.parent_bid_id);
+		out.putDouble(bid.capacity);
+		out.putDouble(bid.init_capacity);
+		out.putInt(bid.creation_period);
+		out.putCount(bid.decision_variables.size());
+		std::map<std::string, double>::const_iterator it;
+		for (it = bid.decision_variables.begin(); it != bid.decision_variables.end(); ++it)
+		{
+			out.putString(it->first);
+			out.putDouble(it->second);
+		}
+	}
+
+	out.putCount(state.purchase_requests.size());
+	std::map<std::string, int>::const_iterator it_requests;
+	for (it_requests = state.purchase_requests.begin(); it_requests != state.purchase_requests.end(); ++it_requests)
+	{
+		out.putString(it_requests->first);
+		out.putInt(it_requests->second);
+	}
+
+	out.putCount(state.purchase_history.size());
+	std::map<std::string, std::vector<CheckpointPurchase> >::const_iterator it_history;
+	for (it_history = state.purchase_history.begin(); it_history != state.purchase_history.end(); ++it_history)
+	{
+		out.putString(it_history->first);
+		out.putCount(it_history->second.size());
+		for (std::size_t i = 0; i < it_history->second.size(); ++i)
+		{
+			const CheckpointPurchase & purchase = it_history->second[i];
+			out.putString(purchase.service_id);
+			out.putString(purchase.bid_id);
+			out.putDouble(purchase.quantity);
+			out.putDouble(purchase.quantity_backlog);
+		}
+	}
+}
+
+bool MarketCheckpoint::decode(const char * begin, const char * end, MarketState & state)
+{
+	SnapshotReader in(begin, end);
+
+	state.period = (unsigned) in.getInt();
+
+	// The smallest encoding of an entry bounds the count read before it.
+	state.providers.resize(in.getCount(12));
+	for (std::size_t i = 0; i < state.providers.size(); ++i)
+	{
+		CheckpointProvider & provider = state.providers[i];
+		provider.id = in.getString();
+		provider.capacity_type = in.getInt();
+		provider.resources.resize(in.getCount(16));
+		for (std::size_t j = 0; j < provider.resources.size(); ++j)
+		{
+			CheckpointResource & resource = provider.resources[j];
+			resource.id = in.getString();
+			resource.initial = in.getDouble();
+			std::size_t periods = in.getCount(12);
+			for (std::size_t k = 0; k < periods; ++k)
+			{
+				unsigned period = (unsigned) in.getInt();
+				resource.periods[period] = in.getDouble();
+			}
+		}
+	}
+
+	state.bids.resize(in.getCount(64));
+	for (std::size_t i = 0; i < state.bids.size(); ++i)
+	{
+		CheckpointBid & bid = state.bids[i];
+		bid.id = in.getString();
+		bid.provider = in.getString();
+		bid.service = in.getString();
+		bid.status = in.getString();
+		bid.active = (in.getInt() != 0);
+		bid.unitary_profit = in.getDouble();
+		bid.unitary_cost = in.getDouble();
+		bid.parent_bid_id = in.getString();
+		bid.capacity = in.getDouble();
+		bid.init_capacity = in.getDouble();
+		bid.creation_period = in.getInt();
+		std::size_t variables = in.getCount(12);
+		for (std::size_t k = 0; k < variables; ++k)
+		{
+			std::string variable = in.getString();
+			bid.decision_variables[variable] = in.getDouble();
+		}
+	}
+
+	std::size_t requests = in.getCount(8);
+	for (std::size_t i = 0; i < requests; ++i)
+	{
+		std::string purchaseId = in.getString();
+		state.purchase_requests[purchaseId] = in.getInt();
+	}
+
+	std::size_t periods = in.getCount(8);
+	for (std::size_t i = 0; i < periods; ++i)
+	{
+		std::vector<CheckpointPurchase> & purchases = state.purchase_history[in.getString()];
+		purchases.resize(in.getCount(24));
+		for (std::size_t j = 0; j < purchases.size(); ++j)
+		{
+			purchases[j].service_id = in.getString();
+			purchases[j].bid_id = in.getString();
+			purchases[j].quantity = in.getDouble();
+			purchases[j].quantity_backlog = in.getDouble();
+		}
+	}
+
+	return in.done();
+}
+
+void MarketCheckpoint::write(const std::string & path, const MarketState & state)
+{
+	std::string payload;
+	encode(state, payload);
+	SnapshotFile::write(path, MARKET_CHECKPOINT_MAGIC, VERSION, payload, "market checkpoint");
+}
+
+bool MarketCheckpoint::read(const std::string & path, MarketState & state,
+							std::string & reason)
+{
+	std::string payload;
+	if (SnapshotFile::read(path, MARKET_CHECKPOINT_MAGIC, VERSION, "market checkpoint",
+						   payload, reason) == false)
+		return false;
+
+	if (decode(payload.data(), payload.data() + payload.size(), state) == false)
+	{
+		reason = "malformed state";
+		return false;
+	}
+	return true;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
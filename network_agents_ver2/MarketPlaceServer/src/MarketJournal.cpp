@@ -0,0 +1,390 @@
+#include <Poco/Util/Application.h>
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+#include <Poco/Checksum.h>
+#include <Poco/Exception.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+
+#include "MarketJournal.h"
+#include "MarketPlaceException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+MarketJournal::MarketJournal(const std::string & path, long flushInterval):
+_path(path),
+_flush_interval(flushInterval),
+_fd(-1),
+_stopped(true),
+_buffered(0),
+_generation(0),
+_written(0),
+_syncs(0),
+_thread("MarketJournal")
+{
+}
+
+MarketJournal::~MarketJournal()
+{
+	stop();
+	if (_fd >= 0)
+		::close(_fd);
+}
+
+std::size_t MarketJournal::read(const std::string & path, std::vector<JournalRecord> & records)
+{
+	Poco::File file(path);
+	if ((file.exists() == false) || (file.getSize() == 0))
+		return 0;
+
+	Poco::SharedMemory mapping(file, Poco::SharedMemory::AM_READ);
+	const char * begin = mapping.begin();
+	std::size_t size = mapping.end() - mapping.begin();
+
+	std::size_t offset = 0;
+	while (size - offset >= 2 * sizeof(Poco::UInt32))
+	{
+		Poco::UInt32 length, checksum;
+		memcpy(&length, begin + offset, sizeof(length));
+		memcpy(&checksum, begin + offset + sizeof(length), sizeof(checksum));
+		const char * payload = begin + offset + 2 * sizeof(Poco::UInt32);
+		if ((length == 0) || (length > size - offset - 2 * sizeof(Poco::UInt32)))
+			break;
+
+		Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+		crc.update(payload, length);
+		if (crc.checksum() != checksum)
+			break;
+
+		JournalRecord record;
+		record.type = payload[0];
+		std::size_t pos = 1;
+		bool valid = true;
+		while (pos < length)
+		{
+			Poco::UInt32 fieldLength;
+			if (length - pos < sizeof(fieldLength))
+			{
+				valid = false;
+				break;
+			}
+			memcpy(&fieldLength, payload + pos, sizeof(fieldLength));
+			pos += sizeof(fieldLength);
+			if (length - pos < fieldLength)
+			{
+				valid = false;
+				break;
+			}
+			record.fields.push_back(std::string(payload + pos, fieldLength));
+			pos += fieldLength;
+		}
+		if (valid == false)
+			break;
+
+		records.push_back(record);
+		offset += 2 * sizeof(Poco::UInt32) + length;
+	}
+	return offset;
+}
+
+void MarketJournal::open(std::size_t size)
+{
+	Poco::FastMutex::ScopedLock fileLock(_file_mutex);
+
+	if (_fd >= 0)
+		::close(_fd);
+	_fd = ::open(_path.c_str(), O_WRONLY | O_CREAT, 0644);
+	if (_fd < 0)
+		throw MarketPlaceException("Could not open the journal " + _path + ": " + strerror(errno), 345);
+
+	// A record cut by the crash is dropped.
+	if ((::ftruncate(_fd, (off_t) size) != 0) || (::lseek(_fd, 0, SEEK_END) < 0))
+		throw MarketPlaceException("Could not truncate the journal " + _path + ": " + strerror(errno), 345);
+}
+
+void MarketJournal::start()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	if (_stopped)
+	{
+		_stopped = false;
+		_thread.start(*this);
+	}
+}
+
+void MarketJournal::stop()
+{
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+		if (_stopped)
+			return;
+		_stopped = true;
+		_not_empty.broadcast();
+	}
+	_thread.join();
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Market journal stopped written:%lu syncs:%lu",
+							 _written, _syncs));
+}
+
+void MarketJournal::encode(const JournalRecord & record, std::string & out)
+{
+	std::string payload(1, record.type);
+	for (std::size_t i = 0; i < record.fields.size(); ++i)
+	{
+		Poco::UInt32 length = (Poco::UInt32) record.fields[i].size();
+		payload.append((const char *) &length, sizeof(length));
+		payload.append(record.fields[i]);
+	}
+
+	Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+	crc.update(payload.data(), (unsigned) payload.size());
+	Poco::UInt32 length = (Poco::UInt32) payload.size();
+	Poco::UInt32 checksum = crc.checksum();
+	out.append((const char *) &length, sizeof(length));
+	out.append((const char *) &checksum, sizeof(checksum));
+	out.append(payload);
+}
+
+void MarketJournal::append(char type, const std::vector<std::string> & fields)
+{
+	JournalRecord record;
+	record.type = type;
+	record.fields = fields;
+
+	std::string data;
+	encode(record, data);
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+	keep(record);
+	bool wasEmpty = _buffer.empty();
+	_buffer.append(data);
+	++_buffered;
+	// Only the first record wakes the writer, the others join its sync.
+	if (wasEmpty)
+		_not_empty.signal();
+}
+
+void MarketJournal::track(const JournalRecord & record)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	keep(record);
+}
+
+void MarketJournal::keep(const JournalRecord & record)
+{
+	switch (record.type)
+	{
+	case JOURNAL_PROVIDER:
+		_providers[record.fields[0]] = record;
+		break;
+	case JOURNAL_REMOVE_PROVIDER:
+		{
+			// Neither the provider nor its availabilities are compacted.
+			_providers.erase(record.fields[0]);
+			std::map<std::pair<std::string, std::string>, JournalRecord>::iterator it;
+			it = _availabilities.lower_bound(std::pair<std::string, std::string>(record.fields[0], ""));
+			while ((it != _availabilities.end()) && (it->first.first == record.fields[0]))
+				_availabilities.erase(it++);
+		}
+		break;
+	case JOURNAL_AVAILABILITY:
+		_availabilities[std::pair<std::string, std::string>(record.fields[0], record.fields[1])] = record;
+		break;
+	case JOURNAL_ADD_BID:
+		_bids.push_back(record);
+		break;
+	case JOURNAL_DELETE_BID:
+		{
+			std::map<std::string, std::size_t>::iterator it = _bid_deletes.find(record.fields[0]);
+			if (it != _bid_deletes.end())
+			{
+				// A bid deleted again, the earlier deletion is not replayed.
+				_bids[it->second].type = 0;
+				it->second = _bids.size();
+			}
+			else
+			{
+				_bid_deletes.insert(std::pair<std::string, std::size_t>(record.fields[0], _bids.size()));
+			}
+			_bids.push_back(record);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void MarketJournal::getAvailabilities(std::vector<std::pair<std::string, std::string> > & availabilities)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	std::map<std::pair<std::string, std::string>, JournalRecord>::iterator it;
+	for (it = _availabilities.begin(); it != _availabilities.end(); ++it)
+		availabilities.push_back(it->first);
+}
+
+void MarketJournal::forgetBids(const std::set<std::string> & bidIds)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	std::vector<JournalRecord> bids;
+	_bid_deletes.clear();
+	for (std::size_t i = 0; i < _bids.size(); ++i)
+	{
+		if ((_bids[i].type == 0) || (bidIds.count(_bids[i].fields[0]) > 0))
+			continue;
+		if (_bids[i].type == JOURNAL_DELETE_BID)
+			_bid_deletes[_bids[i].fields[0]] = bids.size();
+		bids.push_back(_bids[i]);
+	}
+	_bids.swap(bids);
+}
+
+void MarketJournal::compact(const std::vector<JournalRecord> & state)
+{
+	Poco::FastMutex::ScopedLock fileLock(_file_mutex);
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	std::string data;
+	std::map<std::string, JournalRecord>::iterator it_provider;
+	for (it_provider = _providers.begin(); it_provider != _providers.end(); ++it_provider)
+		encode(it_provider->second, data);
+
+	std::map<std::pair<std::string, std::string>, JournalRecord>::iterator it_availability;
+	for (it_availability = _availabilities.begin(); it_availability != _availabilities.end(); ++it_availability)
+		encode(it_availability->second, data);
+
+	for (std::size_t i = 0; i < _bids.size(); ++i)
+	{
+		if (_bids[i].type != 0)
+			encode(_bids[i], data);
+	}
+
+	for (std::size_t i = 0; i < state.size(); ++i)
+		encode(state[i], data);
+
+	// The new journal replaces the old one only once it is on disk.
+	std::string tmpPath = _path + ".tmp";
+	int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw MarketPlaceException("Could not create the journal " + tmpPath + ": " + strerror(errno), 345);
+	try
+	{
+		writeAll(fd, data);
+	}
+	catch (MarketPlaceException &e)
+	{
+		::close(fd);
+		throw;
+	}
+	::fsync(fd);
+	::close(fd);
+
+	if (::rename(tmpPath.c_str(), _path.c_str()) != 0)
+		throw MarketPlaceException("Could not replace the journal " + _path + ": " + strerror(errno), 345);
+
+	if (_fd >= 0)
+		::close(_fd);
+	_fd = ::open(_path.c_str(), O_WRONLY | O_APPEND);
+	if (_fd < 0)
+		throw MarketPlaceException("Could not open the journal " + _path + ": " + strerror(errno), 345);
+
+	// The records buffered are part of the state compacted.
+	_buffer.clear();
+	_buffered = 0;
+	++_generation;
+}
+
+void MarketJournal::writeAll(int fd, const std::string & data)
+{
+	const char * pos = data.data();
+	std::size_t left = data.size();
+	while (left > 0)
+	{
+		ssize_t written = ::write(fd, pos, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw MarketPlaceException("Could not write the journal " + _path + ": " + strerror(errno), 345);
+		}
+		pos += written;
+		left -= (std::size_t) written;
+	}
+}
+
+unsigned long MarketJournal::getWritten()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _written;
+}
+
+unsigned long MarketJournal::getSyncs()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _syncs;
+}
+
+void MarketJournal::run()
+{
+	for (;;)
+	{
+		std::string data;
+		unsigned long records;
+		unsigned long generation;
+		{
+			Poco::Mutex::ScopedLock lock(_mutex);
+			while (_buffer.empty() && (_stopped == false))
+				_not_empty.wait(_mutex);
+
+			// Group commit: the records arriving meanwhile share the sync.
+			if ((_stopped == false) && (_flush_interval > 0))
+				_not_empty.tryWait(_mutex, _flush_interval);
+
+			// When stopping the buffer is flushed before leaving.
+			if (_buffer.empty())
+				break;
+
+			data.swap(_buffer);
+			records = _buffered;
+			_buffered = 0;
+			generation = _generation;
+		}
+
+		Poco::FastMutex::ScopedLock fileLock(_file_mutex);
+		{
+			Poco::Mutex::ScopedLock lock(_mutex);
+			if (generation != _generation)
+				continue;
+		}
+
+		try
+		{
+			if (_fd < 0)
+				throw MarketPlaceException("The journal " + _path + " is not open", 345);
+			writeAll(_fd, data);
+			::fsync(_fd);
+
+			Poco::Mutex::ScopedLock lock(_mutex);
+			_written += records;
+			++_syncs;
+		}
+		catch (MarketPlaceException &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(e.message());
+		}
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
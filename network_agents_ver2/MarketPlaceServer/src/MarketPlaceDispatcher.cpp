@@ -0,0 +1,669 @@
+//
+// MarketPlaceDispatcher.cpp
+//
+// Definition of the MarketPlaceDispatcher class.
+//
+// Copyright (c) 2014, ChoiceNet Project.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <Poco/Util/Application.h>
+#include <Poco/Exception.h>
+#include <Poco/Types.h>
+#include <Poco/NumberParser.h>
+#include <Poco/NumberFormatter.h>
+#include <iostream>
+#include <memory>
+
+#include "Provider.h"
+#include "MarketPlaceDispatcher.h"
+#include "ConnectionChannel.h"
+#include "NetworkServer.h"
+#include "MarketShard.h"
+#include "HandlerExecutor.h"
+#include "MessageScheduler.h"
+#include "WaitingSocketReactor.h"
+#include "MarketPlaceServer.h"
+#include "MarketPlaceSys.h"
+#include "Message.h"
+#include "MarketPlaceException.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+MarketPlaceDispatcher::MarketPlaceDispatcher():
+_publish_pending(false)
+{
+	addMethod(connect, &MarketPlaceDispatcher::Connect);
+	addMethod(send_port, &MarketPlaceDispatcher::StartListening);
+	addMethod(start_period, &MarketPlaceDispatcher::initializePeriodSession);
+	// Period, no longer required.
+	addMethod(end_period, [](Poco::Net::SocketAddress socketAddress,
+							 Message & messageRequest, Message & messageResponse) { });
+	addMethod(receive_bid, &MarketPlaceDispatcher::receiveBid);
+	addMethod(get_best_bids, &MarketPlaceDispatcher::getBestBids);
+	addMethod(receive_purchase, &MarketPlaceDispatcher::addPurchase);
+	addMethod(send_availability, &MarketPlaceDispatcher::setProviderAvailability);
+	addMethod(get_bid, &MarketPlaceDispatcher::getBid);
+	addMethod(get_provider_channel, &MarketPlaceDispatcher::getProviderChannel);
+	addMethod(get_availability, &MarketPlaceDispatcher::getAvailability);
+	addMethod(disconnect, &MarketPlaceDispatcher::terminateProcess);
+	addMethod(snapshot, &MarketPlaceDispatcher::requestSnapshot);
+}
+
+MarketPlaceDispatcher::~MarketPlaceDispatcher()
+{
+}
+
+void MarketPlaceDispatcher::dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+									 unsigned sequence,
+									 Poco::Net::SocketAddress socketAddress,
+									 Message & message)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	app.logger().debug(Poco::format("do processing: %s", message.to_string()) );
+
+	MessageScheduler *scheduler = (*sys).getMessageScheduler();
+
+	// Not queued until the connection is registered.
+	if ((scheduler == NULL) || ((*sys).isAlreadyListener(socketAddress) == false))
+	{
+		route(channel, sequence, socketAddress, message);
+		return;
+	}
+
+	// The request waits in the queue of its class, the response keeps
+	// its place in the connection through the sequence number.
+	MarketPlaceDispatcher * dispatcher = this;
+	MessagePriority priority = MessageScheduler::classify(message.getMethod());
+	bool barrier = MessageScheduler::isBarrier(message.getMethod());
+	bool queued = scheduler->push(priority, barrier, [dispatcher, channel, sequence, socketAddress, message]() mutable
+	{
+		if (channel->isAttached())
+			dispatcher->route(channel, sequence, socketAddress, message);
+	});
+
+	if (queued == false)
+	{
+		Message messageResponse;
+		messageResponse.setMethod(message.getMethod());
+		messageResponse.setParameter("Status_Code", "330");
+		messageResponse.setParameter("Status_Description", "The market place is overloaded");
+		channel->deliver(sequence, messageResponse.to_string());
+		return;
+	}
+
+	if (scheduler->setDrainPending(true) == false)
+	{
+		getReactor().post([dispatcher]() { dispatcher->drainScheduler(); });
+	}
+}
+
+void MarketPlaceDispatcher::onReadBatch()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	(*sys).publishSnapshots();
+}
+
+void MarketPlaceDispatcher::onDisconnect(Poco::Net::SocketAddress socketAddress)
+{
+	runInline([socketAddress]()
+	{
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+		MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+		ChoiceNet::Eco::Message messageResponse;
+		try
+		{
+			sys->deleteListener(socketAddress, messageResponse);
+		}
+		catch (Poco::Exception &e)
+		{
+			// The agent never registered as a listener.
+		}
+	});
+
+	// No read batch follows the disconnections, they are published once
+	// after those queued with this one.
+	if (_publish_pending == false)
+	{
+		_publish_pending = true;
+		MarketPlaceDispatcher * dispatcher = this;
+		getReactor().post([dispatcher]()
+		{
+			dispatcher->_publish_pending = false;
+			dispatcher->onReadBatch();
+		});
+	}
+}
+
+void MarketPlaceDispatcher::drainScheduler()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+	MessageScheduler *scheduler = (*sys).getMessageScheduler();
+
+	scheduler->setDrainPending(false);
+
+	// A bounded batch, so the sockets are read again before the next one
+	// and late control messages can get ahead of the queued traffic.
+	MessageScheduler::Task task;
+	MessagePriority priority;
+	unsigned dispatched = 0;
+	while ((dispatched < scheduler->getBatch()) && scheduler->pop(task, priority))
+	{
+		task();
+		++dispatched;
+	}
+
+	(*sys).publishSnapshots();
+
+	if ((scheduler->size() > 0) && (scheduler->setDrainPending(true) == false))
+	{
+		MarketPlaceDispatcher * dispatcher = this;
+		getReactor().post([dispatcher]() { dispatcher->drainScheduler(); });
+	}
+}
+
+void MarketPlaceDispatcher::route(Poco::AutoPtr<ConnectionChannel> channel,
+								  unsigned sequence,
+								  Poco::Net::SocketAddress socketAddress,
+								  Message & message)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	MarketPlaceDispatcher * dispatcher = this;
+	MarketShardPool *shards = (*sys).getShardPool();
+	MarketShardPool *queries = (*sys).getQueryPool();
+	HandlerExecutor *executor = (*sys).getHandlerExecutor();
+	std::string serviceId;
+
+	if ((queries != NULL) && isQuery(message.getMethod()))
+	{
+		// Read only requests are answered from the published snapshots.
+		queries->post([dispatcher, channel, sequence, socketAddress, message]() mutable
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+			MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+			Message messageResponse;
+			messageResponse.setMethod(message.getMethod());
+			if ((*sys).answerFromSnapshot(message, messageResponse))
+			{
+				channel->deliver(sequence, messageResponse.to_string());
+			}
+			else
+			{
+				dispatcher->getReactor().post([dispatcher, channel, sequence, socketAddress, message]()
+				{
+					dispatcher->runInline([dispatcher, channel, sequence, socketAddress, message]()
+					{
+						dispatcher->executeOnOwner(channel, sequence, socketAddress, message);
+					});
+				});
+			}
+		});
+		return;
+	}
+
+	if ((shards != NULL) && getShardKey(message, serviceId))
+	{
+		// The request is executed by the shard owning the service, the
+		// response comes back through the channel in request order.
+		runInline([dispatcher, channel, sequence, socketAddress, message]()
+		{
+			dispatcher->executeOnOwner(channel, sequence, socketAddress, message);
+		});
+		return;
+	}
+
+	if (executor != NULL)
+	{
+		HandlerClass handlerClass = HandlerExecutor::classify(message.getMethod());
+		if (handlerClass != HANDLER_INLINE)
+		{
+			executor->submit(handlerClass, [dispatcher, channel, sequence, socketAddress, message]() mutable
+			{
+				Message messageResponse;
+				dispatcher->execute(socketAddress, message, messageResponse);
+				channel->deliver(sequence, messageResponse.to_string());
+			});
+			return;
+		}
+	}
+
+	runInline([dispatcher, channel, sequence, socketAddress, message]() mutable
+	{
+		Message messageResponse;
+		dispatcher->execute(socketAddress, message, messageResponse);
+		channel->deliver(sequence, messageResponse.to_string());
+	});
+}
+
+bool MarketPlaceDispatcher::runInline(const std::function<void()> & task)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	HandlerExecutor *executor = (*sys).getHandlerExecutor();
+	if (executor != NULL)
+		return executor->runInline(getReactor(), task);
+
+	task();
+	return true;
+}
+
+void MarketPlaceDispatcher::executeOnOwner(Poco::AutoPtr<ConnectionChannel> channel,
+										   unsigned sequence,
+										   Poco::Net::SocketAddress socketAddress,
+										   Message message)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	MarketShardPool *shards = (*sys).getShardPool();
+	std::string serviceId;
+
+	if ((shards != NULL) && getShardKey(message, serviceId))
+	{
+		MarketPlaceDispatcher * dispatcher = this;
+		shards->post(serviceId, [dispatcher, channel, sequence, socketAddress, message]() mutable
+		{
+			Message messageResponse;
+			dispatcher->execute(socketAddress, message, messageResponse);
+			channel->deliver(sequence, messageResponse.to_string());
+		});
+	}
+	else
+	{
+		Message messageResponse;
+		execute(socketAddress, message, messageResponse);
+		channel->deliver(sequence, messageResponse.to_string());
+	}
+}
+
+bool MarketPlaceDispatcher::isQuery(Method method)
+{
+	return ((method == get_best_bids) || (method == get_bid)
+			 || (method == get_availability) || (method == get_provider_channel));
+}
+
+bool MarketPlaceDispatcher::getShardKey(Message & message, std::string & serviceId)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	bool val_return = false;
+	switch (message.getMethod()){
+	   case receive_bid:
+	   case receive_purchase:
+	   case get_best_bids:
+	   case get_availability:
+		 {
+			if (message.existsParameter("Service"))
+			{
+				serviceId = message.getParameter("Service");
+				val_return = true;
+			}
+			break;
+		 }
+	   case get_bid:
+		 {
+			// The bid is read by the shard that owns its service.
+			if (message.existsParameter("Bid"))
+			{
+				val_return = (*sys).getBidService(message.getParameter("Bid"), serviceId);
+			}
+			break;
+		 }
+	   default:
+		   break;
+	}
+	return val_return;
+}
+
+
+void MarketPlaceDispatcher::Connect(Poco::Net::SocketAddress socketAddress,
+									    Message & messageRequest,
+									    Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	std::string listenerId = messageRequest.getParameter("Agent");
+
+	app.logger().debug(Poco::format("Connect %s", listenerId));
+
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+	sys->insertListener(listenerId, socketAddress, messageResponse);
+}
+
+void MarketPlaceDispatcher::StartListening(Poco::Net::SocketAddress socketAddress,
+									   ChoiceNet::Eco::Message & messageRequest,
+									   ChoiceNet::Eco::Message & messageResponse)
+{
+	unsigned  Uport;
+	ProviderCapacityType capacityType;
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Start Listening");
+
+
+	std::string port = messageRequest.getParameter("Port");
+
+	bool v_result = Poco::NumberParser::tryParseUnsigned(port, Uport);
+	std::string type = messageRequest.getParameter("Type");
+	if (type.compare("provider") ==  0){
+		std::string capacity = messageRequest.getParameter("CapacityType");
+		if (capacity.compare("bid") == 0){
+			capacityType = BID_BY_BID;
+		}
+		else if (capacity.compare("bulk") == 0){
+			capacityType = BULK_CAPACITY;
+		}
+		else {
+			capacityType = UNDEFINED_CAPACITY_TYPE;
+		}
+	}
+	else{
+		capacityType = UNDEFINED_CAPACITY_TYPE;
+	}
+	if ( Uport <= 0xFFFF){
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+		MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+		Poco::UInt16 u16Port = (Poco::UInt16) Uport;
+		(*sys).startListening(socketAddress, u16Port, type, capacityType, messageResponse);
+	}
+	else
+	{
+		throw MarketPlaceException("Invalid Port", 301);
+	}
+	app.logger().debug("Ending Listening");
+}
+
+void MarketPlaceDispatcher::initializePeriodSession(Poco::Net::SocketAddress socketAddress,
+												Message & messageRequest,
+												Message & messageResponse)
+{
+    // Create a new structure to hold listeners bids and put it as current
+    // the structure is as follows:
+    // a service has a best bid
+    //           has many providers
+    //           		     each provider could have many bids
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	unsigned  period;
+	std::string periodStr = messageRequest.getParameter("Period");
+
+	bool v_result = Poco::NumberParser::tryParseUnsigned(periodStr, period);
+	if (v_result)
+	{
+		(*sys).initializePeriodSession((unsigned) period);
+		messageResponse.setResponseOk();
+		app.logger().information("Starting a new offering for interval" + periodStr);
+
+		// The network counters are reported once per period.
+		NetworkServer *network = server.getNetworkServer();
+		if (network != NULL)
+			network->logStats();
+	}
+	else
+	{
+		throw MarketPlaceException("Invalid period", 305);
+	}
+}
+
+void MarketPlaceDispatcher::finalizePeriodSession(Poco::Net::SocketAddress socketAddress,
+											  Message & messageRequest,
+											  Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Starting finalize period session");
+
+	unsigned  period;
+	std::string periodStr = messageRequest.getParameter("Period");
+	bool v_result = Poco::NumberParser::tryParseUnsigned(periodStr, period);
+
+	if (v_result)
+	{
+		MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+		MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+		(*sys).finalizePeriodSession(period, messageResponse);
+
+		app.logger().debug("Ending finalize period session");
+	}
+	else
+	{
+		throw MarketPlaceException("Invalid period", 305);
+	}
+
+}
+
+
+void MarketPlaceDispatcher::receiveBid(Poco::Net::SocketAddress socketAddress,
+								   Message & messageRequest,
+								   Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Adding bid in the market place");
+
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+	std::string serviceId = messageRequest.getParameter("Service");
+	try{
+		Service * service = (*sys).getService(serviceId);
+		Bid * bidPtr = new Bid(service, messageRequest);
+		if (bidPtr->isActive())
+		{
+			(*sys).addBid(bidPtr, messageRequest.to_string(), messageResponse);
+			app.logger().debug("Bid added in the market place");
+		}
+		else
+		{
+			(*sys).deleteBid(bidPtr, messageRequest.to_string(), messageResponse);
+			app.logger().debug("Bid deleted in the market place");
+		}
+	} catch (FoundationException &e){
+		app.logger().error(e.message());
+	}
+}
+
+void MarketPlaceDispatcher::addPurchase(Poco::Net::SocketAddress socketAddress,
+									Message & messageRequest,
+									Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Adding purchase in the market place");
+	try{
+		MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+		MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+		Service * service = (*sys).getService(messageRequest.getParameter("Service"));
+		// Only its quantities are kept by the period purchases.
+		Purchase purchase(service, messageRequest);
+		purchase.setQuantityBacklog(0);
+		(*sys).addPurchase(&purchase, messageRequest.to_string(), messageResponse);
+		app.logger().debug("Purchase added in the market place");
+	} catch (FoundationException &e){
+		app.logger().error(e.message());
+	}
+}
+
+void MarketPlaceDispatcher::setProviderAvailability(Poco::Net::SocketAddress socketAddress,
+												Message & messageRequest,
+												Message & messageResponse)
+{
+	double quantity=0;
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Set provider availability in the market place");
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	std::string providerId = messageRequest.getParameter("Provider");
+	std::string resourceId = messageRequest.getParameter("Resource");
+	std::string quantityStr = messageRequest.getParameter("Quantity");
+	bool v_result = Poco::NumberParser::tryParseFloat(quantityStr, quantity);
+	if (v_result){
+		(*sys).setProviderAvailability(providerId, resourceId, quantity, messageResponse);
+		app.logger().debug("End set provider availability in the market place");
+	}
+	else
+	{
+		throw MarketPlaceException("Invalid quantity", 316);
+	}
+}
+
+
+void MarketPlaceDispatcher::getAvailability(Poco::Net::SocketAddress socketAddress,
+										Message & messageRequest,
+										Message & messageResponse)
+{
+	double quantity=0;
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Get provider availability in the market place");
+
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	std::string providerId = messageRequest.getParameter("Provider");
+	std::string serviceId = messageRequest.getParameter("Service");
+	std::string bidId = messageRequest.getParameter("Bid");
+	(*sys).getProviderAvailability(providerId, serviceId, bidId, messageResponse);
+	app.logger().debug("End set provider availability in the market place");
+}
+
+void MarketPlaceDispatcher::getBestBids(Poco::Net::SocketAddress socketAddress,
+									Message & messageRequest,
+									Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Request for best bid");
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+	std::string providerId = messageRequest.getParameter("Provider");
+	std::string serviceId = messageRequest.getParameter("Service");
+	// Verifies if the sender sets the provider and service.
+	if ((providerId.empty()) || (serviceId.empty())){
+		missingParametersProcedure(messageResponse);
+	}
+	else
+	{
+		(*sys).getBestBids(providerId, serviceId, messageResponse);
+	}
+	app.logger().debug("End request for best bid");
+}
+
+
+void MarketPlaceDispatcher::getBid(Poco::Net::SocketAddress socketAddress,
+												Message & messageRequest,
+												Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("get Bid");
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	std::string bidId = messageRequest.getParameter("Bid");
+	(*sys).sendBid(bidId, messageResponse);
+	app.logger().information("End Get Bid");
+
+}
+
+
+void MarketPlaceDispatcher::getProviderChannel(Poco::Net::SocketAddress socketAddress,
+												Message & messageRequest,
+												Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("get Provider Channel");
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	std::string providerId = messageRequest.getParameter("ProviderId");
+	(*sys).sendProviderChannel(providerId, messageResponse);
+	app.logger().information("End Provider Channel");
+
+}
+
+void MarketPlaceDispatcher::requestSnapshot(Poco::Net::SocketAddress socketAddress,
+											Message & messageRequest,
+											Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	MarketPlaceSys *sys = server.getMarketPlaceSubsystem();
+
+	std::string path;
+	if (messageRequest.existsParameter("Path"))
+		path = messageRequest.getParameter("Path");
+	(*sys).requestCheckpoint(path, messageResponse);
+}
+
+void MarketPlaceDispatcher::terminateProcess(Poco::Net::SocketAddress socketAddress,
+											 Message & messageRequest,
+											 Message & messageResponse)
+{
+	std::cout << "Terminating the server processing" << std::endl;
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information("Terminating the server processing");
+	MarketPlaceServer &server = dynamic_cast<MarketPlaceServer&>(app);
+	server.terminate();
+	app.logger().information("Server processing finished");
+}
+
+void MarketPlaceDispatcher::missingParametersProcedure(Message & messageResponse)
+{
+	messageResponse.setParameter("Status_Code", "308");
+	messageResponse.setParameter("Status_Description", "Missing Parameters");
+}
+
+
+
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
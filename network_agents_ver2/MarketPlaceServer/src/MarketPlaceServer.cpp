@@ -1,6 +1,3 @@
-#include <Poco/Net/SocketReactor.h>
-#include <Poco/Net/SocketAcceptor.h>
-#include <Poco/Thread.h>
 #include <Poco/Util/ServerApplication.h>
 #include <Poco/Util/Option.h>
 #include <Poco/Util/Application.h>
@@ -19,13 +16,20 @@
 #include <Poco/AutoPtr.h>
 #include <Poco/FormattingChannel.h>
 #include <Poco/PatternFormatter.h>
+#include <Poco/Data/MySQL/Connector.h>
+#include <Poco/Data/SQLite/Connector.h>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <algorithm>
 
 
 #include "MarketPlaceServer.h"
 #include "MarketPlaceSys.h"
-#include "ConnectionHandler.h"
-#include "WaitingSocketReactor.h"
+#include "MarketPlaceDispatcher.h"
+#include "NetworkServer.h"
 #include "FoundationException.h"
+#include "StorageBackend.h"
+#include "ColumnarLog.h"
 #include "MarketPlaceException.h"
 
 
@@ -43,7 +47,9 @@ namespace Eco
 
     MarketPlaceServer::MarketPlaceServer():
     _helpRequested(false),
-    _marketSubsystemPtr(NULL)
+    _marketSubsystemPtr(NULL),
+    _dispatcher(new MarketPlaceDispatcher()),
+    _network(NULL)
     {
     }
 
@@ -52,6 +58,8 @@ namespace Eco
 		std::cout << "terminating MarketPlaceServer" << std::endl;
 		if (_marketSubsystemPtr != NULL)
 			delete _marketSubsystemPtr;
+		// After the subsystem, its threads hold tasks of the dispatcher.
+		delete _dispatcher;
     }
 
     void MarketPlaceServer::initialize(Poco::Util::Application& self)
@@ -76,6 +84,14 @@ namespace Eco
             .repeatable(false)
             .callback(Poco::Util::OptionCallback<MarketPlaceServer>(
                 this, &MarketPlaceServer::handleHelp)));
+
+        options.addOption(
+        Poco::Util::Option("load-results", "l", "load the columnar result logs of a directory into the database")
+            .required(false)
+            .repeatable(false)
+            .argument("directory")
+            .callback(Poco::Util::OptionCallback<MarketPlaceServer>(
+                this, &MarketPlaceServer::handleLoadResults)));
     }
 
     void MarketPlaceServer::handleHelp(const std::string& name,
@@ -91,12 +107,67 @@ namespace Eco
         _helpRequested = true;
     }
 
+    void MarketPlaceServer::handleLoadResults(const std::string& name,
+                    const std::string& value)
+    {
+        _load_results = value;
+    }
+
+    int MarketPlaceServer::loadResults()
+    {
+        Poco::Data::MySQL::Connector::registerConnector();
+        Poco::Data::SQLite::Connector::registerConnector();
+
+        int result = Poco::Util::ServerApplication::EXIT_OK;
+        StorageBackend * target = NULL;
+        try
+        {
+            target = StorageBackend::create(config(),
+                        config().getString("load_results_backend", "mysql"));
+            std::size_t chunk = (std::size_t) config().getInt("db_insert_chunk", 500);
+
+            // In name order, the executions of a table one after the other.
+            std::vector<std::string> files;
+            Poco::File(_load_results).list(files);
+            std::sort(files.begin(), files.end());
+
+            for (std::size_t i = 0; i < files.size(); ++i)
+            {
+                if (Poco::Path(files[i]).getExtension().compare("col") != 0)
+                    continue;
+
+                Poco::Path path(_load_results);
+                path.makeDirectory();
+                path.setFileName(files[i]);
+
+                std::size_t rows = ColumnarLog::load(path.toString(), *target, chunk);
+                logger().information(Poco::format("Loaded %z rows from %s", rows, path.toString()));
+            }
+        } catch (FoundationException &e){
+            std::cout << e.message() << std::endl;
+            result = Poco::Util::ServerApplication::EXIT_SOFTWARE;
+        } catch (Poco::Exception &e){
+            std::cout << e.displayText() << std::endl;
+            result = Poco::Util::ServerApplication::EXIT_SOFTWARE;
+        }
+
+        delete target;
+        Poco::Data::MySQL::Connector::unregisterConnector();
+        Poco::Data::SQLite::Connector::unregisterConnector();
+        return result;
+    }
+
     MarketPlaceSys * MarketPlaceServer::getMarketPlaceSubsystem()
     {
 		return _marketSubsystemPtr;
 		throw Poco::NotFoundException("The subsystem has not been registered", typeid(MarketPlaceSys).name());
 	}
 
+    NetworkServer * MarketPlaceServer::getNetworkServer()
+    {
+		return _network;
+	}
+
     int MarketPlaceServer::main(const std::vector<std::string>& args)
     {
 
@@ -111,6 +182,12 @@ namespace Eco
 		logger.setLevel(Poco::Message::PRIO_INFORMATION);
 
 
+        if (_load_results.empty() == false)
+        {
+        	loadConfiguration();
+        	return loadResults();
+        }
+
         // Initialize the system.
         try
         {
@@ -136,27 +213,47 @@ namespace Eco
 		unsigned short port = (unsigned short)
 						config().getInt("listening_port", 5555);
 
-		// Server Socket
-		Poco::Net::ServerSocket svs(port);
-		// Reactor-Notifier
-		WaitingSocketReactor reactor;
-		// Server-Acceptor
-		Poco::Net::SocketAcceptor<ConnectionHandler> acceptor(svs, reactor);
-		// Threaded Reactor
-		Poco::Thread thread;
-		thread.start(reactor);
+		// Reactors reading and writing the connections, the first one
+		// dispatches every request.
+		unsigned reactors = (unsigned) config().getInt("reactor_threads", 1);
+
+		NetworkServer network("Market_Place", *_dispatcher, reactors);
+
+		// Unix domain socket for the agents on this host
+		std::string local_path = config().getString("local_socket_path", "");
+		if (local_path.empty() == false)
+			network.listenLocal(local_path);
+
+		// Shared memory rings for the C++ agents and load generators
+		std::string shared_name = config().getString("shared_memory_name", "");
+		if (shared_name.empty() == false)
+			network.listenSharedMemory(shared_name,
+						(unsigned) config().getInt("shared_memory_slots", 16),
+						(std::size_t) config().getInt("shared_memory_ring_size", 1048576));
+
+		network.start(port);
+		_network = &network;
 
 		// Sends the port for start listening for clock periods
 		std::string type = config().getString("type", "market_place");
 
 		MarketPlaceSys *sys = getMarketPlaceSubsystem();
-		(*sys).addAsClockListener((Poco::UInt16) port, type);
+		try
+		{
+			// Answered on the dispatch reactor, the start does not wait.
+			(*sys).connectToClock(network.getDispatchReactor(), (Poco::UInt16) port, type);
+		} catch (MarketPlaceException &e){
+			std::cout << e.message() << std::endl;
+			terminate();
+		}
+
 		// Wait for CTRL+C
 		waitForTerminationRequest();
 
-		// Stop reactor
-		reactor.stop();
-		thread.join();
+		// Stop reactors
+		network.stop();
+		(*sys).disconnectFromClock();
+		_network = NULL;
 		return Poco::Util::ServerApplication::Application::EXIT_OK;
 		return Poco::Util::ServerApplication::EXIT_OK;
     }
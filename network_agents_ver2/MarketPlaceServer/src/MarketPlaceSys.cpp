@@ -2,6 +2,8 @@
 #include <Poco/Net/SocketAddress.h>
 #include <Poco/Exception.h>
 #include <Poco/Net/NetException.h>
+#include <Poco/Net/IPAddress.h>
+#include <Poco/Util/ServerApplication.h>
 #include <Poco/NumberParser.h>
 #include <Poco/NumberFormatter.h>
 #include <Poco/Types.h>
@@ -22,14 +24,17 @@
 #include <Poco/Data/Session.h>
 #include <Poco/Data/SQLite/Connector.h>
 #include <Poco/Data/SessionFactory.h>
+#include <cstdio>
 
 
 #include "Bid.h"
+#include "BulkInsert.h"
 #include "MarketPlaceException.h"
 #include "FoundationException.h"
 #include "MarketPlaceSys.h"
 #include "Message.h"
 #include "Purchase.h"
+#include "NetworkServer.h"
 
 
 namespace ChoiceNet
@@ -42,17 +47,37 @@ using namespace Poco::Data::Keywords;
 using Poco::Data::Session;
 using Poco::Data::Statement;
 
+static std::string formatJournalDouble(double value)
+{
+	// Enough digits to replay the exact value.
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.17g", value);
+	return std::string(buffer);
+}
+
 
 MarketPlaceSys::MarketPlaceSys(void):
 FoundationSys(MARKET_SERVER),
-_clockSocket(NULL),
 _current_bids(NULL),
 _current_purchases(NULL),
+_retention_periods(0),
 _intervals_per_cycle(0),
 _send_interval(0),
-_pool(NULL)
+_shards(NULL),
+_snapshots(NULL),
+_query_workers(NULL),
+_period_pipeline(NULL),
+_listeners_changed(false),
+_persistence(NULL),
+_insert_chunk(BulkInsert::DEFAULT_CHUNK),
+_journal(NULL),
+_journal_compact_periods(10),
+_periods_since_compaction(0),
+_recovering(false),
+_handlers(NULL),
+_scheduler(NULL)
 {
-	Poco::Data::MySQL::Connector::registerConnector();
+	// The connectors are registered by the foundation.
 }
 
 MarketPlaceSys::~MarketPlaceSys(void)
@@ -60,12 +85,41 @@ MarketPlaceSys::~MarketPlaceSys(void)
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().information("Eliminating the market place system");
 
-	// Release the memory assigned to socket and current bids pointers
+	// No request handler runs from now on.
+	if (_handlers != NULL)
+		delete _handlers;
+
+	if (_scheduler != NULL)
+		delete _scheduler;
+
+	// Stop the shards before releasing the state they work on. The tasks
+	// still queued run, and journal, before they stop.
+	if (_query_workers != NULL)
+		delete _query_workers;
+
+	if (_shards != NULL)
+		delete _shards;
+
+	// Let the last closed period be disseminated while the listeners
+	// are still connected.
+	if (_period_pipeline != NULL)
+		delete _period_pipeline;
+
+	// Syncs the records still buffered, nothing is journaled anymore.
+	if (_journal != NULL)
+	{
+		delete _journal;
+		_journal = NULL;
+	}
+
+	// Flush the periods not stored yet.
+	if (_persistence != NULL)
+		delete _persistence;
+
+	if (_snapshots != NULL)
+		delete _snapshots;
 
-	if (_clockSocket != NULL)
-		(*_clockSocket).shutdown();
-		(*_clockSocket).close();
-		delete _clockSocket;
+	// Release the memory assigned to current bids pointers
 
 	if (_current_bids != NULL)
 		delete _current_bids;
@@ -89,18 +143,9 @@ MarketPlaceSys::~MarketPlaceSys(void)
 		_bids.erase(it_container_bid);
 	}
 
+	// The registry disconnects and releases the agents listener when it
+	// is destroyed.
 	app.logger().information("Eliminating listeners registered");
-	// Release the memory assigned to agents listener
-	Listeners::iterator it_listeners;
-	it_listeners = _listeners.begin();
-	while( (it_listeners != _listeners.end())  )
-	{
-		// Disconnect the sockets to agents.
-		(*(it_listeners->second)).Disconnect();
-		delete it_listeners->second;
-		_listeners.erase(it_listeners);
-		++it_listeners;
-	}
 
 
 	app.logger().information("Eliminating providers registered");
@@ -115,60 +160,19 @@ MarketPlaceSys::~MarketPlaceSys(void)
 	}
 
 
-	app.logger().information("Eliminating purchases registered");
-	// Release the memory assigned to purchase objects
-	PurchaseHistory::iterator it_history;
-	it_history = _purchase_history.begin();
-	while( (it_history != _purchase_history.end())  )
-	{
-		delete it_history->second;
-		_purchase_history.erase(it_history);
-		++it_history;
-	}
-
-	app.logger().debug("Disconnecting from the database");
-	if (_pool != NULL)
-		delete _pool;
-
-	Poco::Data::MySQL::Connector::unregisterConnector();
+	// The purchase history releases the purchases of the closed periods.
 
 	app.logger().information("Eliminating the market sys - Finished");
 }
 
-void MarketPlaceSys::sendMessageToClock(Message & message, Message & response)
-{
-
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Starting sendMessageToClock");
-
-	std::string msgStr = message.to_string();
-	char * message_char = new char [msgStr.length()];
-	strcpy (message_char, msgStr.c_str() );
-	(*_clockSocket).sendBytes(message_char, msgStr.length());
-
-	// Receive the response and based on that continues
-	char buffer[1024];
-	int bytes_received = (*_clockSocket).receiveBytes(buffer, sizeof(buffer)-1);
-	std::string recvline(buffer);
-	response.setData(recvline);
-
-	app.logger().debug("ending sendMessageToClock");
-}
-
 void MarketPlaceSys::initialize()
 {
-    int statusCd = 0;
 	Poco::Util::Application& app = Poco::Util::Application::instance();
     app.logger().debug("Initialization market place System");
 
-    unsigned short port = (unsigned short)
-                app.config().getInt("clock_port", 3333);
-
     unsigned pareto_fronts_to_send = (unsigned)
                 app.config().getInt("pareto_fronts_to_send", 3);
 
-    Poco::UInt16 u16Port = (Poco::UInt16) port;
-
 	// Get the interval to send information
 	unsigned short send_interval = (unsigned short)
 					app.config().getInt("send_information_on_interval", 1);
@@ -183,97 +187,131 @@ void MarketPlaceSys::initialize()
 	// initialize variable
 	_intervals_per_cycle = intervals_per_cycle;
 
-	try{//
-		// Connection string to POCO
-		std::string db_host = (std::string)
-					app.config().getString("db_host");
-
-		unsigned short db_port = (unsigned short)
-					app.config().getInt("db_port",3306);
-
-		std::string db_user = (std::string)
-					app.config().getString("db_user","root");
-
-		std::string db_password = (std::string)
-					app.config().getString("db_password","password");
-
-		std::string db_name = (std::string)
-					app.config().getString("db_name","Network_Simulation");
+	// Number of shard threads for the per-service state, 0 keeps every
+	// request on the reactor thread.
+	unsigned market_shards = (unsigned)
+					app.config().getInt("market_shards", 0);
+
+	// Number of threads answering queries from snapshots, 0 disables the
+	// read path.
+	unsigned query_threads = (unsigned)
+					app.config().getInt("query_threads", 0);
+
+	// Save and disseminate closed periods in a background thread, so the
+	// market keeps taking bids and purchases meanwhile.
+	bool period_pipeline = app.config().getBool("period_pipeline", false);
+
+	// Number of closed periods waiting to be stored by the persistence
+	// writer, 0 stores them in the thread closing the period. When the
+	// queue is full "block" waits for the writer and "drop" discards the
+	// period.
+	unsigned persistence_queue = (unsigned)
+					app.config().getInt("persistence_queue", 0);
+	std::string persistence_mode = app.config().getString("persistence_mode", "block");
+
+	// Rows written by each multi-row insert of a closed period.
+	_insert_chunk = (std::size_t)
+					app.config().getInt("db_insert_chunk", BulkInsert::DEFAULT_CHUNK);
+
+	// Number of threads executing the expensive request handlers, 0 keeps
+	// every handler on the reactor thread.
+	unsigned handler_threads = (unsigned)
+					app.config().getInt("handler_threads", 0);
+
+	// Priority dispatch of the requests read. priority_queue_size bounds
+	// the queue of every class but the control one, 0 dispatches the
+	// requests as they are read. priority_batch requests are dispatched
+	// before reading the sockets again, and a request waiting more than
+	// priority_max_wait milliseconds goes ahead of any class.
+	unsigned priority_queue_size = (unsigned)
+					app.config().getInt("priority_queue_size", 0);
+	unsigned priority_batch = (unsigned)
+					app.config().getInt("priority_batch", 64);
+	unsigned priority_max_wait = (unsigned)
+					app.config().getInt("priority_max_wait", 100);
+
+	// Write-ahead journal of the market state, none when the path is
+	// empty. journal_recover rebuilds the state from the journal left by
+	// a previous run instead of starting empty. The records are synced
+	// every journal_flush_interval milliseconds, and the journal is
+	// compacted every journal_compact_periods closed periods.
+	std::string journal_path = app.config().getString("journal_path", "");
+	bool journal_recover = app.config().getBool("journal_recover", false);
+	long journal_flush_interval = (long)
+					app.config().getInt("journal_flush_interval", 10);
+	_journal_compact_periods = (unsigned)
+					app.config().getInt("journal_compact_periods", 10);
+
+	// Checkpoint written when a snapshot is requested without a path, and
+	// checkpoint to start from instead of an empty market.
+	_checkpoint_path = app.config().getString("market_checkpoint_path", "market.ckpt");
+	std::string market_restore = app.config().getString("market_restore", "");
+
+	// Periods of purchase history, bids out of the fronts and purchase
+	// requests kept in memory, 0 keeps them all. The older purchase
+	// history is appended to purchase_history_spill, or released when it
+	// is empty. The period closing in the pipeline still uses the previous
+	// one, so at least two are kept.
+	_retention_periods = (unsigned)
+					app.config().getInt("retention_periods", 0);
+	if (_retention_periods == 1)
+		_retention_periods = 2;
+	std::string purchase_history_spill = app.config().getString("purchase_history_spill", "");
+
+	if (_current_bids == NULL){
+		_current_bids = new BidInformation();
+	}
 
-		std::string sPort = Poco::NumberFormatter::format(db_port);
-		std::string connectionStr = "host=" + db_host + ";port=" + sPort + ";user=" + db_user + ";password=" + db_password + ";db=" + db_name;
+	// The results are stored in the storage backend of the foundation.
+	FoundationSys::initialize(app, 0, pareto_fronts_to_send);
 
-		std::cout << "connectionStr:" << connectionStr << std::endl;
-		app.logger().information("Connecting with the database");
-		_pool = new Poco::Data::SessionPool("MySQL", connectionStr);
+	if (market_shards > 0)
+		initializeShards(market_shards);
 
-		if (_current_bids == NULL){
-			_current_bids = new BidInformation();
-		}
+	// Before the journal, the periods replayed are retained too.
+	_purchase_history.setRetention(_retention_periods, purchase_history_spill);
 
+	// Before the snapshots, so they are published with the state recovered.
+	if (journal_path.empty() == false)
+		initializeJournal(journal_path, journal_recover, journal_flush_interval);
 
-	} catch (Poco::NotFoundException &e) {
-    	throw MarketPlaceException("Database connection information not found");
-	} catch (Poco::InvalidArgumentException &e) {
-		throw MarketPlaceException(e.what(), e.code());
+	// After the journal, so the restored state is journaled. A journal
+	// replayed is newer than any checkpoint.
+	if (market_restore.empty() == false)
+	{
+		if (_providers.empty() && _bids.empty())
+			restoreCheckpoint(market_restore);
+		else
+			app.logger().warning("Market recovered from the journal, checkpoint not restored: " + market_restore);
 	}
 
+	if (query_threads > 0)
+		initializeSnapshots(query_threads);
 
-	FoundationSys::initialize(app, 0, pareto_fronts_to_send);
-
-    try{
-    	std::string clock_address = app.config().getString("clock_server_address");
+	if (period_pipeline)
+		_period_pipeline = new MarketShardPool(1);
 
-    	// Establish the connection with the clock server.
-    	Poco::Net::IPAddress ipadd(clock_address, Poco::Net::IPAddress::IPv4);
-    	Poco::Net::SocketAddress sockadd(ipadd, u16Port);
+	if (persistence_queue > 0)
+	{
+		PersistenceMode mode = PERSISTENCE_BLOCK;
+		if (persistence_mode.compare("drop") == 0)
+			mode = PERSISTENCE_DROP;
+		_persistence = new PersistenceWriter(_storage, persistence_queue, mode);
+		_persistence->start();
+	}
 
-		_clockSocket = new Poco::Net::StreamSocket(sockadd);
+	if (handler_threads > 0)
+		_handlers = new HandlerExecutor(handler_threads);
 
-    } catch (Poco::NotFoundException &e) {
-    	throw MarketPlaceException("Clock server address not found");
-	} catch (Poco::InvalidArgumentException &e) {
-		throw MarketPlaceException(e.what(), e.code());
-	} catch (Poco::Net::ConnectionRefusedException &e) {
-		throw MarketPlaceException("Connection refused by ClockServer", e.code());
-	}
+	if (priority_queue_size > 0)
+		_scheduler = new MessageScheduler(priority_queue_size, priority_batch,
+										  (Poco::Timestamp::TimeDiff) priority_max_wait * 1000);
 
     try {
     	std::string name = app.config().getString("name");
 		// Initialize the name of the market place
 		p_cName = name;
 
-
-		Message connect_msg;
-		Message response;
-		Method method = connect;
-		connect_msg.setMethod(method);
-		connect_msg.setParameter("Agent", p_cName);
-		sendMessageToClock(connect_msg, response);
-
-		// If the message is not ok, show the message description and raise an exception
-		if (!(response.isMessageStatusOk())){
-			std::string statusDescr = response.getParameter("Status_Description");
-			throw MarketPlaceException(statusDescr, statusCd);
-		}
-		// Finally get the current period
-		Message current_period_msg;
-		Message response2;
-		Method meth_cur = get_current_period;
-		current_period_msg.setMethod(meth_cur);
-		sendMessageToClock(current_period_msg, response2);
-
-		// If the message is not ok, show the message description and raise an exception
-		if (!(response.isMessageStatusOk())){
-			std::string statusDescr = response2.getParameter("Status_Description");
-			throw MarketPlaceException(statusDescr, statusCd);
-		}
-		else{
-			// get the parameter from the response and put it on the variable
-			 int period = atoi((response2.getParameter("Period")).c_str());
-			 initializePeriodSession(period);
-		}
-
     } catch (Poco::NotFoundException &e) {
     	throw MarketPlaceException("name not found");
 	}
@@ -282,107 +320,147 @@ void MarketPlaceSys::initialize()
 
 }
 
-void MarketPlaceSys::addAsClockListener(Poco::UInt16 port, std::string type)
+void MarketPlaceSys::connectToClock(WaitingSocketReactor & reactor,
+									Poco::UInt16 port, std::string type)
 {
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	long timeout = (long) app.config().getInt("clock_timeout", 5000);
+	Poco::UInt16 clock_port = (Poco::UInt16) app.config().getInt("clock_port", 3333);
+
+	try
+	{
+		std::string clock_path = app.config().getString("clock_socket_path", "");
+		if (clock_path.empty() == false)
+		{
+			// The clock server runs on this host.
+			Poco::Net::SocketAddress sockadd(Poco::Net::SocketAddress::UNIX_LOCAL, clock_path);
+			_clock = new ClientChannel(reactor, sockadd, timeout);
+		}
+		else
+		{
+			std::string clock_address = app.config().getString("clock_server_address");
+
+			// Establish the connection with the clock server.
+			Poco::Net::IPAddress ipadd(clock_address, Poco::Net::IPAddress::IPv4);
+			Poco::Net::SocketAddress sockadd(ipadd, clock_port);
+			_clock = new ClientChannel(reactor, sockadd, timeout);
+		}
+	} catch (Poco::NotFoundException &e) {
+		throw MarketPlaceException("Clock server address not found");
+	} catch (Poco::InvalidArgumentException &e) {
+		throw MarketPlaceException(e.what(), e.code());
+	}
+	_clock->open();
+
+	// The requests are pipelined, the clock answers them in order.
+	MarketPlaceSys * sys = this;
+
+	Message connect_msg;
+	Method method = connect;
+	connect_msg.setMethod(method);
+	connect_msg.setParameter("Agent", p_cName);
+	_clock->request(connect_msg, [sys](bool received, Message & response)
+	{
+		sys->isClockResponseOk(received, response, "connect");
+	});
+
+	// Finally get the current period
+	Message current_period_msg;
+	Method meth_cur = get_current_period;
+	current_period_msg.setMethod(meth_cur);
+	_clock->request(current_period_msg, [sys, &reactor](bool received, Message & response)
+	{
+		if (sys->isClockResponseOk(received, response, "get_current_period"))
+		{
+			// get the parameter from the response and put it on the variable
+			unsigned period = (unsigned) atoi((response.getParameter("Period")).c_str());
+			HandlerExecutor * handlers = sys->getHandlerExecutor();
+			if (handlers != NULL)
+				handlers->runInline(reactor, [sys, period]() { sys->initializePeriodSession(period); });
+			else
+				sys->initializePeriodSession(period);
+		}
+	});
 
-	int statusCd = 0;
+	// Sends the port for start listening for clock periods
 	Message port_msg;
-	Message messageResponse;
-	Method method = send_port;
+	method = send_port;
 	port_msg.setMethod(method);
 	std::string portStr = Poco::NumberFormatter::format(port);
 	port_msg.setParameter("Port", portStr);
 	port_msg.setParameter("Type", type);
-	sendMessageToClock(port_msg, messageResponse);
-
-    // If the message is not ok, show the message description and rise an exception
-    if (!(messageResponse.isMessageStatusOk())){
-		std::string statusDescr = messageResponse.getParameter("Status_Description");
-		throw MarketPlaceException(statusDescr, statusCd);
-	}
+	_clock->request(port_msg, [sys](bool received, Message & response)
+	{
+		sys->isClockResponseOk(received, response, "send_port");
+	});
 }
 
-const char* MarketPlaceSys::name() const
+void MarketPlaceSys::disconnectFromClock(void)
 {
-    if (p_cName.size() > 0)
-		p_cName.c_str();
-    else
-		return "Subsystem Market Place ";
+	if (_clock.isNull() == false)
+	{
+		_clock->close();
+		_clock = NULL;
+	}
 }
 
-bool MarketPlaceSys::isAlreadyListener(std::string idListener)
+void MarketPlaceSys::acknowledgePeriod(unsigned period)
 {
-	bool val_return;
-	if (_listeners_by_id.count(idListener) > 0)
-	    val_return = true;
-	else
-		val_return = false;
-	return val_return;
+	if (_clock.isNull() == true)
+		return;
+
+	Message done_msg;
+	Method method = period_done;
+	done_msg.setMethod(method);
+	done_msg.setParameter("Period", Poco::NumberFormatter::format(period));
+	_clock->request(done_msg, [period](bool received, Message & response)
+	{
+		// Only paces the clock, the market goes on without it.
+		if ((received == false) || (response.isMessageStatusOk() == false))
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().warning(Poco::format("Clock server did not accept period_done %u", period));
+		}
+	});
 }
 
-bool MarketPlaceSys::isAlreadyListener(Poco::Net::SocketAddress socketAddress)
+bool MarketPlaceSys::isClockResponseOk(bool received, Message & response,
+									   const std::string & request)
 {
-	bool found = false;
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		found = true;
-	}
-	return found;
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	if ((received == true) && response.isMessageStatusOk())
+		return true;
+
+	// If the message is not ok, show the message description and stop.
+	std::string statusDescr = "No response";
+	if (received == true)
+		statusDescr = response.getParameter("Status_Description");
+	app.logger().error(Poco::format("Clock server %s failed: %s", request, statusDescr));
+	std::cout << statusDescr << std::endl;
+
+	Poco::Util::ServerApplication &server = dynamic_cast<Poco::Util::ServerApplication&>(app);
+	server.terminate();
+	return false;
 }
 
-void MarketPlaceSys::getMessage(Poco::FIFOBuffer & fifoIn,
-						  int len, Message &message )
+const char* MarketPlaceSys::name() const
 {
-	// If the socket address corresponds to a listener, then the message size
-	// could be unlimited, when it is not a listener then we have as its
-	// limit 1024.
-	std::string receiveString;
-	std::size_t i = 0;
-	for (; i < fifoIn.used() ; ++i){
-		receiveString += (*(fifoIn.begin() + i));
-	}
-	fifoIn.drain(len);
-	message.setData(receiveString);
+    if (p_cName.size() > 0)
+		p_cName.c_str();
+    else
+		return "Subsystem Market Place ";
 }
 
-bool MarketPlaceSys::getMessage(Poco::Net::SocketAddress socketAddress, Message & message)
+bool MarketPlaceSys::isAlreadyListener(std::string idListener)
 {
-	bool val_return = false;
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		val_return = (*(it->second)).getMessage(message);
-	}
-	else
-	{
-		throw MarketPlaceException("The agent is not a listener", 303);
-	}
-	return val_return;
+	return (_listeners.find(idListener) != NULL);
 }
 
-
-void MarketPlaceSys::addStagedData(Poco::Net::SocketAddress socketAddress,
-								   Poco::FIFOBuffer & fifoIn,
-								   int len)
+bool MarketPlaceSys::isAlreadyListener(Poco::Net::SocketAddress socketAddress)
 {
-	// If the socket address corresponds to a listener, then the message size
-	// could be unlimited, when it is not a listener then we have as its
-	// limit 1024.
-
-	bool found = false;
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if ( it != _listeners.end())
-	{
-		(*(it->second)).addStreamStagedForProcessing(fifoIn,len);
-	}
-	else
-	{
-		throw MarketPlaceException("The agent is not a listener", 303);
-	}
+	return (_listeners.find(socketAddress) != NULL);
 }
 
 void MarketPlaceSys::insertListener(std::string idListener,
@@ -399,10 +477,11 @@ void MarketPlaceSys::insertListener(std::string idListener,
 	}
 	else
 	{
-		Listener *listener = new Listener(idListener, socketAddress);
-
-		_listeners.insert( std::pair<Poco::Net::SocketAddress, Listener *>(socketAddress,listener));
-		_listeners_by_id.insert( std::pair<std::string, Listener *>(idListener,listener));
+		Poco::FastMutex::ScopedLock lock(_listeners_mutex);
+		if (_listeners.add(idListener, socketAddress) == NULL)
+		{
+			throw MarketPlaceException("The agent is already a listener", 302);
+		}
 
 		messageResponse.setResponseOk();
 		app.logger().information(Poco::format("listener %s inserted", idListener));
@@ -419,29 +498,39 @@ void MarketPlaceSys::startListening(Poco::Net::SocketAddress socketAddress,
 	app.logger().information(Poco::format("Start Listening by port:%d, type:%s", (int) port, type ));
 
 
-	Listeners::iterator it;
-	it = _listeners.find(socketAddress);
-	if (it != _listeners.end())
+	Listener * listener = _listeners.find(socketAddress);
+	if (listener != NULL)
 	{
-		Poco::Net::SocketAddress sa = (*(it->second)).getSocketAddress();
+		Poco::Net::SocketAddress sa = listener->getSocketAddress();
 		try
 		{
-			Poco::Net::SocketAddress sockadd(sa.host(), port);
+			Poco::Net::SocketAddress sockadd(NetworkServer::getCallbackHost(sa), port);
 
 			app.logger().debug("Socket address:" + sa.toString());
 
-			(*(it->second)).Connect(sockadd);
-			(*(it->second)).setListeningPort(port);
-			(*(it->second)).setType(type);
+			Poco::FastMutex::ScopedLock lock(_listeners_mutex);
+			listener->Connect(sockadd);
+			listener->setListeningPort(port);
+			_listeners.setType(listener, type);
 			// If the listener is a provider, we added to the list of providers.
 			if (type.compare("provider") == 0 )
 			{
-				std::string providerId = (it->second)->getId();
+				std::string providerId = listener->getId();
 				app.logger().debug(Poco::format("Connecting provider with Id: %s", providerId) );
-				Provider * provider = new Provider(providerId, capacity_type);
-				_providers.insert(std::pair<std::string, Provider *>( providerId, provider));
+				Poco::FastMutex::ScopedLock lock(_providers_mutex);
+				// A recovered provider keeps its state when it connects again.
+				if (_providers.find(providerId) == _providers.end())
+				{
+					Provider * provider = new Provider(providerId, capacity_type);
+					_providers.insert(std::pair<std::string, Provider *>( providerId, provider));
+
+					std::vector<std::string> fields;
+					fields.push_back(providerId);
+					fields.push_back(Poco::NumberFormatter::format((int) capacity_type));
+					journal(JOURNAL_PROVIDER, fields);
+				}
 			}
-			insertListenerBytype(type, (*(it->second)).getId());
+			_listeners_changed = true;
 			messageResponse.setParameter("Period", (int) _period);
 			messageResponse.setResponseOk();
 
@@ -460,27 +549,12 @@ void MarketPlaceSys::startListening(Poco::Net::SocketAddress socketAddress,
 	app.logger().information(Poco::format("Ending Start Listening by port:%d, type:%s", (int) port, type ));
 }
 
-void MarketPlaceSys::insertListenerBytype(std::string type, std::string listenerId)
-{
-	std::map<std::string, std::vector<std::string> >::iterator it;
-	it = _listeners_by_type.find(type);
-	if (it == _listeners_by_type.end())
-	{
-		std::vector<std::string> list;
-		_listeners_by_type.insert(std::pair<std::string, std::vector<std::string> > (type, list));
-
-	}
-	it = _listeners_by_type.find(type);
-	(it->second).push_back(listenerId);
-}
-
 void MarketPlaceSys::reinitiateDataContainers(MARKET_HISTORY_PERIOD subperiod)
 {
 
-	BidContainer::iterator it;
-	for (it = _bids_to_broadcast.begin(); it != _bids_to_broadcast.end() ; ++it)
 	{
-		_bids_to_broadcast.erase(it);
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		_bids_to_broadcast.clear();
 	}
 
     if (_current_purchases != NULL){
@@ -488,7 +562,7 @@ void MarketPlaceSys::reinitiateDataContainers(MARKET_HISTORY_PERIOD subperiod)
 		std::string subPeriodStd = Poco::NumberFormatter::format((int) subperiod);
 		periodStd = periodStd + subPeriodStd;
 
-	 	_purchase_history.insert( std::pair< std::string, PurchaseInformation *> (periodStd, _current_purchases) );
+	 	_purchase_history.add(periodStd, _current_purchases);
 		// Initialize again current purchases
 		_current_purchases = NULL;
 
@@ -511,6 +585,17 @@ void MarketPlaceSys::initializePeriodSession(unsigned interval)
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug(Poco::format("initialize interval session -----------------  : %d", (int) interval));
 
+	// Period transitions are a barrier across shards: the bids and
+	// purchases queued are done, and journaled, in the period they
+	// arrived in, and no shard reads _period while it changes.
+	quiesceShards();
+
+	// Journaled before the period is closed, a compaction while closing
+	// it replaces the record.
+	std::vector<std::string> fields;
+	fields.push_back(Poco::NumberFormatter::format(interval));
+	journal(JOURNAL_START_PERIOD, fields);
+
 	if (_intervals_per_cycle > 0)
 		_period = interval / _intervals_per_cycle;
 	else
@@ -518,10 +603,21 @@ void MarketPlaceSys::initializePeriodSession(unsigned interval)
 
 	app.logger().information(Poco::format("initialize Period session -----------------  : %d", (int) _period));
 
+	if (_scheduler != NULL)
+		_scheduler->logStats();
+
 	if (sendInformation(interval)) {
-		saveInformation();
-		disseminateInformation();
-		reinitiateDataContainers(START);
+		closePeriod(START, false);
+	}
+
+	// The clock is told once the periods closed are disseminated, so the
+	// providers have their purchase feedback before the period can end.
+	if (_recovering == false)
+	{
+		if (_period_pipeline != NULL)
+			_period_pipeline->post([this, interval]() { acknowledgePeriod(interval); });
+		else
+			acknowledgePeriod(interval);
 	}
 
 	app.logger().information(Poco::format("Ending initialize interval session: %d", (int) interval));
@@ -534,223 +630,53 @@ void MarketPlaceSys::broadCastInformation(Message & message, std::string type)
 	app.logger().information("starting broadCastInformation");
 	app.logger().debug(Poco::format("message: %s", message.to_string()));
 
-	std::map<std::string, std::vector<std::string> >::iterator it_type;
+	// Called by the period pipeline while the reactor registers listeners.
+	Poco::FastMutex::ScopedLock lock(_listeners_mutex);
 
-	it_type = _listeners_by_type.find(type);
-	if ( it_type != _listeners_by_type.end() )
-	{
-		// std::cout << "Type is listening" << type << std::endl;
-		std::vector<std::string> list = it_type->second;
-		std::vector<std::string>::iterator it_strings;
-		it_strings = list.begin();
+	std::vector<Listener *> list;
+	_listeners.getListeners(type, list);
 
-		while (it_strings != list.end())
+	std::vector<Listener *>::iterator it;
+	for (it = list.begin(); it != list.end(); ++it)
+	{
+		if ((*it)->getStatus() == 1 ) // the listener is connected
 		{
-			std::map<std::string, Listener *>::iterator it = _listeners_by_id.find(*it_strings);
-			if( it != _listeners_by_id.end() )
+			try
 			{
-				if ((*(it->second)).getStatus() == 1 ) // the listener is connected
-				{
-					try
-					{
-						(*(it->second)).write(message.to_string());
-
-						app.logger().information(Poco::format("broadCastInformation performed to listener: %s", (it->second)->getId() ) );
-					}
-					catch (FoundationException &e)
-					{
-						std::string msg = "Ther listener: ";
-						msg.append(it->first);
-						msg.append("is not listening anymore");
-						app.logger().error(msg);
-
-						// Remove the listener from the list.
-					}
-				}
-			}
-			++it_strings;
-		}
-	}
-
-	app.logger().information("ending broadCastInformation");
-}
-
-/*
-void MarketPlaceSys::saveBidInformation(void)
-{
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information("Starting saveBidInformation");
-
-	if (_period > 0){
-
-		BidContainer::iterator it;
-		for (it = _bids_to_broadcast.begin(); it != _bids_to_broadcast.end() ; ++it)
-		{
-
-			app.logger().information("saving Bid information");
-
-			Bid * bid = (it->second);
-			// It saves the information at the start of the following period.
-			bid->toDatabase(_pool, FoundationSys::getExecutionCount(), (int) _period - 1);
-		}
-	}
-	else {
-		app.logger().debug("Invalid period during saveBidInformation - period 0");
-	}
-	app.logger().information("Ending saveBidInformation");
-
-}
-*/
-
-void MarketPlaceSys::saveBidInformation(void)
-{
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information("Starting saveBidInformation");
-
-	std::vector<int> bVal1;							  // period,
-	std::vector<std::string> bVal2;					  // bidId,
-	std::vector<std::string> bVal3;					  // providerId,
-	std::vector<int> bVal4;							  // status,
-	std::vector<int> bVal5;							  // paretoStatus,
-	std::vector<int> bVal6;							  // dominatedCount,
-	std::vector<int> bVal7;							  // execution_count,
-	std::vector<double> bVal8;						  // unitary_profit,
-	std::vector<double> bVal9;						  // unitary_cost,
-	std::vector<std::string> bVal10;				   // parentBidId,
-	std::vector<double> bVal11;						   // capacity,
-	std::vector<double> bVal12;						   // init_capacity,
-	std::vector<int> bVal13;						   // creation_period
-
-
-	std::vector<std::string> dvbidIds;
-	std::vector<std::string> dvvariableIds;
-	std::vector<double> dvdecisionvalues;
-	std::vector<int> dvexecutionCount;
-
-	if (_period > 0){
-
-		BidContainer::iterator it;
-		for (it = _bids_to_broadcast.begin(); it != _bids_to_broadcast.end() ; ++it)
-		{
+				(*it)->write(message.to_string());
 
-			app.logger().information("saving Bid information");
-
-			std::map<std::string, double > decVars;
-
-			Bid * bid = (it->second);
-			BidStruct bidS = bid->getDBBidStructure(FoundationSys::getExecutionCount(), (int) _period - 1);
-			bVal1.push_back(bidS._period);
-			bVal2.push_back(bidS._id);
-			bVal3.push_back(bidS._provider);
-			bVal4.push_back(bidS._status);
-			bVal5.push_back(bidS._paretoStatus);
-			bVal6.push_back((int) bidS._dominatedCount);
-			bVal7.push_back(bidS._execution_count);
-			bVal8.push_back(bidS._unitary_profit);
-			bVal9.push_back(bidS._unitary_cost);
-			bVal10.push_back(bidS._parent_bid_id);
-			bVal11.push_back(bidS._capacity);
-			bVal12.push_back(bidS._init_capacity);
-			bVal13.push_back(bidS._creation_period);
-
-			bid->getDBDecisionVariables(&decVars);
-			std::map<std::string, double >::iterator itDes;
-			for (itDes = decVars.begin(); itDes != decVars.end() ; ++itDes)
-			{
-				dvbidIds.push_back(bid->getId());
-				dvvariableIds.push_back(itDes->first);
-				dvdecisionvalues.push_back(itDes->second);
-				dvexecutionCount.push_back(FoundationSys::getExecutionCount());
+				app.logger().information(Poco::format("broadCastInformation performed to listener: %s", (*it)->getId() ) );
 			}
+			catch (FoundationException &e)
+			{
+				std::string msg = "Ther listener: ";
+				msg.append((*it)->getId());
+				msg.append("is not listening anymore");
+				app.logger().error(msg);
 
+				// Remove the listener from the list.
+			}
 		}
-
-		app.logger().information("It is going to put in the DB");
-
-		if (bVal1.size() > 0)
-		{
-			Poco::Data::Session session2(_pool->get());
-
-			// Perform the inserts in bulk.
-			Poco::Data::Statement insertBids(session2);
-			insertBids << "insert into simulation_bid_tmp (period, bidId, providerId, status, paretoStatus, dominatedCount, execution_count, unitary_profit, unitary_cost, parentBidId, capacity, init_capacity, creation_period) values (?,?,?,?,?,?,?,?,?,?,?,?,?)",
-								use(bVal1), // period,
-								use(bVal2), // bidId,
-								use(bVal3), // providerId,
-								use(bVal4), // status,
-								use(bVal5), // paretoStatus,
-								use(bVal6), // dominatedCount,
-								use(bVal7), // execution_count,
-								use(bVal8), // unitary_profit,
-								use(bVal9), // unitary_cost,
-								use(bVal10), // parentBidId,
-								use(bVal11), // capacity,
-								use(bVal12), // init_capacity,
-								use(bVal13); // creation_period
-
-			insertBids.execute();
-
-			Poco::Data::Statement inserttmpbid(session2);
-			inserttmpbid << "insert into simulation_bid(period, bidId, providerId, status, paretoStatus, dominatedCount, execution_count, unitary_profit, unitary_cost, parentBidId, capacity, init_capacity, creation_period) select period, bidId, providerId, status, paretoStatus, dominatedCount, execution_count, unitary_profit, unitary_cost, parentBidId, capacity, init_capacity, creation_period from simulation_bid_tmp";
-			inserttmpbid.execute();
-
-			Poco::Data::Statement deletetmpbid(session2);
-			deletetmpbid << "truncate simulation_bid_tmp";
-			deletetmpbid.execute();
-
-			session2.commit();
-
-			app.logger().information("After inserting Bid headers");
-
-			Poco::Data::Session session(_pool->get());
-
-			Poco::Data::Statement insertDecisionVariable(session);
-			insertDecisionVariable << "insert into simulation_bid_decision_variable_tmp (parentId, decisionVariableName, value, execution_count ) values(?,?,?,?)",
-								use(dvbidIds),
-								use(dvvariableIds),
-								use(dvdecisionvalues),
-								use(dvexecutionCount);
-
-			insertDecisionVariable.execute();
-
-			Poco::Data::Statement inserttmp(session);
-			inserttmp << "insert into simulation_bid_decision_variable(parentId, decisionVariableName, value, execution_count) select parentId, decisionVariableName, value, execution_count from simulation_bid_decision_variable_tmp";
-			inserttmp.execute();
-
-			Poco::Data::Statement deletetmp(session);
-			deletetmp << "truncate simulation_bid_decision_variable_tmp";
-			deletetmp.execute();
-
-			session.commit();
-		}
-
-		app.logger().information("After the DB is updated");
-	}
-	else {
-		app.logger().debug("Invalid period during saveBidInformation - period 0");
 	}
 
-	app.logger().information("Ending saveBidInformation");
-
+	app.logger().information("ending broadCastInformation");
 }
 
-
-void MarketPlaceSys::broadCastBidInformation(void)
+void MarketPlaceSys::broadCastBidInformation(ClosingPeriod * closing)
 {
 
 	Message message;
 	Method method = receive_bid_information;
 	message.setMethod(method);
-	message.setParameter("Period", (int) _period);
+	message.setParameter("Period", (int) closing->getPeriod());
 
 	Poco::XML::AutoPtr<Poco::XML::Document> pDoc = new Poco::XML::Document;
 	Poco::XML::AutoPtr<Poco::XML::Element> pCompetitorBids = pDoc->createElement("New_Bids");
 
-	BidContainer::iterator it;
-	for (it = _bids_to_broadcast.begin(); it != _bids_to_broadcast.end() ; ++it)
+	std::vector<Bid *>::iterator it;
+	for (it = closing->getBids().begin(); it != closing->getBids().end() ; ++it)
 	{
-		Bid * bid = (it->second);
-		bid->to_XML(pDoc, pCompetitorBids);
+		(*it)->to_XML(pDoc, pCompetitorBids);
 	}
 
 	pDoc->appendChild(pCompetitorBids);
@@ -768,132 +694,295 @@ void MarketPlaceSys::broadCastBidInformation(void)
 }
 
 
-void MarketPlaceSys::sendProviderPurchaseInformation(void)
+void MarketPlaceSys::sendProviderPurchaseInformation(ClosingPeriod * closing)
 {
 
+	if (closing->getPurchases() == NULL)
+		return;
+
 	// Iterate over the providers and send the information of purchases for the period.
-    std::map<std::string, Provider *>::iterator it_provider;
-    for(it_provider = _providers.begin(); it_provider != _providers.end(); it_provider++)
-    {
-		// std::cout << "In sendProviderPurchaseInformation: Provider" << it_provider->first << std::endl;
-		std::map<std::string, Listener *>::iterator it_listeners;
-		it_listeners = _listeners_by_id.find(it_provider->first);
-		if (it_listeners != _listeners_by_id.end())
+	std::map<std::string, ClosingPeriod::ProviderBids>::iterator it_provider;
+	for (it_provider = closing->getProviderBids().begin(); it_provider != closing->getProviderBids().end(); ++it_provider)
+	{
+		Poco::XML::AutoPtr<Poco::XML::Document> pDoc = new Poco::XML::Document;
+		Poco::XML::AutoPtr<Poco::XML::Element> pParentPurchaseUsage = pDoc->createElement("Receive_Purchases");
+
+		(*(closing->getPurchases())).getPurchasesForProvider(pDoc, pParentPurchaseUsage, it_provider->second);
+
+		pDoc->appendChild(pParentPurchaseUsage);
+		Poco::XML::DOMWriter writer;
+		writer.setNewLine("\n");
+		writer.setOptions(Poco::XML::XMLWriter::PRETTY_PRINT);
+		std::stringstream  output;
+		writer.writeNode(output, pDoc);
+		Message message;
+		Method method = receive_purchase_feedback;
+		message.setMethod(method);
+		message.setParameter("Period", (int) closing->getPeriod());
+		message.setBody(output.str());
 		{
-
-			if (_current_bids != NULL)
+			// The provider could have left since the period was closed.
+			Poco::FastMutex::ScopedLock lock(_listeners_mutex);
+			Listener * listener = _listeners.find(it_provider->first);
+			if (listener != NULL)
 			{
-				Poco::XML::AutoPtr<Poco::XML::Document> pDoc = new Poco::XML::Document;
-				Poco::XML::AutoPtr<Poco::XML::Element> pParentPurchaseUsage = pDoc->createElement("Receive_Purchases");
-
-				// Get provider's bids and for each of them gets its neighbors
-				std::map<std::string, std::vector<std::string> > bids;
-
-				(*_current_bids).getProviderBids(it_provider->first, bids);
-
-				(*_current_purchases).getPurchasesForProvider(pDoc, pParentPurchaseUsage, bids);
-
-				pDoc->appendChild(pParentPurchaseUsage);
-				Poco::XML::DOMWriter writer;
-				writer.setNewLine("\n");
-				writer.setOptions(Poco::XML::XMLWriter::PRETTY_PRINT);
-				std::stringstream  output;
-				writer.writeNode(output, pDoc);
-				Message message;
-				Method method = receive_purchase_feedback;
-				message.setMethod(method);
-				message.setParameter("Period", (int) _period);
-				message.setBody(output.str());
-				// std::cout << "Message Receive Purchases to send:" << message.to_string() << std::endl;
 				try
 				{
-					(*(it_listeners->second)).write(message.to_string());
+					listener->write(message.to_string());
 				}
 				catch (FoundationException &e)
 				{
 					Poco::Util::Application& app = Poco::Util::Application::instance();
 					std::string msg = "Ther listener: ";
-					msg.append(it_listeners->first);
+					msg.append(it_provider->first);
 					msg.append("is not listening anymore");
 					app.logger().error(msg);
 				}
-
-				broadCastInformation(message, "presenter");
 			}
 		}
+
+		broadCastInformation(message, "presenter");
 	}
 }
 
-void MarketPlaceSys::activatePresenter(void)
+void MarketPlaceSys::activatePresenter(unsigned period)
 {
 	Message message;
 	Method method = activate_presenter;
 	message.setMethod(method);
-	message.setParameter("Period", (int) _period);
+	message.setParameter("Period", (int) period);
 	broadCastInformation(message, "presenter");
 }
 
-void MarketPlaceSys::saveInformation()
+void MarketPlaceSys::saveInformation(ClosingPeriod * closing)
 {
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	if (closing->getPeriod() == 0){
+		app.logger().debug("Invalid period during saveInformation - period 0");
+		return;
+	}
+
+	PeriodRecord * record = new PeriodRecord(closing->getPeriod(), closing->getExecutionCount(),
+											 _insert_chunk);
+
+	std::vector<Bid *>::iterator it;
+	for (it = closing->getBids().begin(); it != closing->getBids().end() ; ++it)
+	{
+		record->addBid(*it);
+	}
 
-	saveBidInformation();
-	storeCurrentPurchaseInformation();
+	if (closing->getPurchases() != NULL)
+		record->addPurchases(closing->getPurchases());
 
+	if (_persistence != NULL)
+	{
+		_persistence->enqueue(record);
+	}
+	else
+	{
+		try
+		{
+			record->store(*_storage);
+		}
+		catch (Poco::Exception &e)
+		{
+			delete record;
+			throw;
+		}
+		delete record;
+	}
 }
 
-void MarketPlaceSys::disseminateInformation()
+void MarketPlaceSys::disseminateInformation(ClosingPeriod * closing)
 {
 
-	broadCastBidInformation();
-	sendProviderPurchaseInformation();
+	broadCastBidInformation(closing);
+	sendProviderPurchaseInformation(closing);
 
 }
 
-void MarketPlaceSys::finalizePeriodSession(unsigned  period,  Message & messageResponse)
+ClosingPeriod * MarketPlaceSys::freezePeriod(bool activatePresenter)
 {
+	ClosingPeriod * closing = new ClosingPeriod(_period, FoundationSys::getExecutionCount(),
+												activatePresenter);
 
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information(Poco::format("finalize period session ------------current_period:%d given_eriod:%d", (int) _period, (int) period));
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		BidContainer::iterator it;
+		for (it = _bids_to_broadcast.begin(); it != _bids_to_broadcast.end() ; ++it)
+		{
+			closing->addBid(it->second);
+		}
+	}
 
-	saveInformation();
-	disseminateInformation();
-	reinitiateDataContainers(END);
+	// Reinitiating the containers moves the purchases to the history,
+	// where they are not modified anymore.
+	closing->setPurchases(_current_purchases);
 
-	activatePresenter();
-	messageResponse.setResponseOk();
+	// Get provider's bids and for each of them gets its neighbors
+	if (_current_bids != NULL)
+	{
+		Poco::FastMutex::ScopedLock lock(_providers_mutex);
+		std::map<std::string, Provider *>::iterator it_provider;
+		for (it_provider = _providers.begin(); it_provider != _providers.end(); ++it_provider)
+		{
+			if (_listeners.find(it_provider->first) != NULL)
+			{
+				ClosingPeriod::ProviderBids bids;
+				(*_current_bids).getProviderBids(it_provider->first, bids);
+				closing->addProviderBids(it_provider->first, bids);
+			}
+		}
+	}
+
+	return closing;
 }
 
-void MarketPlaceSys::addBid(Bid * bidPtr, Message & messageResponse)
+void MarketPlaceSys::processClosingPeriod(ClosingPeriod * closing)
 {
-
 	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information(Poco::format("Starting add Bid: %s", bidPtr->getId() ));
-
-	// First verify that the bid was not included
-	std::map<std::string, Bid *>::iterator it;
+	app.logger().information(Poco::format("Processing closed period:%d", (int) closing->getPeriod()));
 
-	it = _bids.find((*bidPtr).getId());
-	if (it == _bids.end())
+	try
 	{
-		// Verify if the service exist
-		bool exist = (*_current_bids).existService((*bidPtr).getService());
+		saveInformation(closing);
+	}
+	catch (Poco::Exception &e)
+	{
+		app.logger().error(Poco::format("Period %d could not be saved: %s",
+							(int) closing->getPeriod(), e.displayText()));
+	}
 
-		if (!exist){
-			// When it does not exist then creates the service
-			// std::cout << "adding service in the market place" << std::endl;
-			(*_current_bids).addService((*bidPtr).getService());
-		}
+	disseminateInformation(closing);
 
-		// In any case inserts the bid into the service container, this part
-		// also verifies whether or not the bid given belongs to the best bids.
-		(*_current_bids).addBidToService(bidPtr);
-		// std::cout << "Bid inserted in the market place" << std::endl;
+	if (closing->getActivatePresenter())
+		activatePresenter(closing->getPeriod());
 
-		// Insert the bid in the container
-		_bids.insert(std::pair<std::string, Bid *> ((*bidPtr).getId(), bidPtr));
+	delete closing;
+}
 
-		// Insert in the brodcast container
-		_bids_to_broadcast.insert(std::pair<std::string, Bid *> ((*bidPtr).getId(), bidPtr));
+void MarketPlaceSys::closePeriod(MARKET_HISTORY_PERIOD subperiod, bool activatePresenter)
+{
+	ClosingPeriod * closing = freezePeriod(activatePresenter);
+
+	// From here the market takes the traffic of the next period.
+	reinitiateDataContainers(subperiod);
+
+	// A replayed period was processed before the restart.
+	if (_recovering)
+	{
+		delete closing;
+		return;
+	}
+
+	releaseExpiredState();
+
+	if ((_journal != NULL) && (++_periods_since_compaction >= _journal_compact_periods))
+	{
+		try
+		{
+			compactJournal();
+		}
+		catch (MarketPlaceException &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(e.message());
+		}
+	}
+
+	std::string checkpointPath;
+	{
+		Poco::FastMutex::ScopedLock lock(_checkpoint_mutex);
+		checkpointPath.swap(_checkpoint_request);
+	}
+	if (checkpointPath.empty() == false)
+	{
+		try
+		{
+			writeCheckpoint(checkpointPath);
+		}
+		catch (Poco::Exception &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(Poco::format("Market checkpoint not written: %s", e.displayText()));
+		}
+	}
+
+	if (_period_pipeline != NULL)
+	{
+		// Only one closed period is in flight, the previous one must be
+		// completely disseminated before the next one is handed over.
+		_period_pipeline->barrier();
+		_period_pipeline->post([this, closing]() { processClosingPeriod(closing); });
+	}
+	else
+	{
+		processClosingPeriod(closing);
+	}
+}
+
+void MarketPlaceSys::finalizePeriodSession(unsigned  period,  Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("finalize period session ------------current_period:%d given_eriod:%d", (int) _period, (int) period));
+
+	quiesceShards();
+
+	std::vector<std::string> fields;
+	fields.push_back(Poco::NumberFormatter::format(period));
+	journal(JOURNAL_END_PERIOD, fields);
+
+	closePeriod(END, true);
+	messageResponse.setResponseOk();
+}
+
+void MarketPlaceSys::addBid(Bid * bidPtr, const std::string & request, Message & messageResponse)
+{
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Starting add Bid: %s", bidPtr->getId() ));
+
+	// First verify that the bid was not included
+	bool found;
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		found = (_bids.find((*bidPtr).getId()) != _bids.end());
+	}
+
+	if (found == false)
+	{
+		// Verify if the service exist
+		bool exist = (*_current_bids).existService((*bidPtr).getService());
+
+		if (!exist){
+			// When it does not exist then creates the service
+			// std::cout << "adding service in the market place" << std::endl;
+			(*_current_bids).addService((*bidPtr).getService());
+		}
+
+		// In any case inserts the bid into the service container, this part
+		// also verifies whether or not the bid given belongs to the best bids.
+		(*_current_bids).addBidToService(bidPtr);
+		markServiceChanged(bidPtr->getService());
+		// std::cout << "Bid inserted in the market place" << std::endl;
+
+		{
+			Poco::FastMutex::ScopedLock lock(_bids_mutex);
+
+			// Insert the bid in the container
+			_bids.insert(std::pair<std::string, Bid *> ((*bidPtr).getId(), bidPtr));
+
+			// Insert in the brodcast container
+			_bids_to_broadcast.insert(std::pair<std::string, Bid *> ((*bidPtr).getId(), bidPtr));
+
+			// Still under the lock, in the order the bids are registered.
+			std::vector<std::string> fields;
+			fields.push_back(bidPtr->getId());
+			fields.push_back(request);
+			journal(JOURNAL_ADD_BID, fields);
+		}
 
 		app.logger().information("New Bid added");
 
@@ -907,7 +996,7 @@ void MarketPlaceSys::addBid(Bid * bidPtr, Message & messageResponse)
 	}
 }
 
-void MarketPlaceSys::deleteBid(Bid * bidPtr, Message & messageResponse)
+void MarketPlaceSys::deleteBid(Bid * bidPtr, const std::string & request, Message & messageResponse)
 {
 	// First verify that the bid was not included
 	std::map<std::string, Bid *>::iterator it;
@@ -915,17 +1004,26 @@ void MarketPlaceSys::deleteBid(Bid * bidPtr, Message & messageResponse)
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().information(Poco::format("Starting delete Bid: %s", bidPtr->getId() ));
 
-	it = _bids.find((*bidPtr).getId());
-	if (it != _bids.end())
+	Bid * bidSearched = NULL;
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		it = _bids.find((*bidPtr).getId());
+		if (it != _bids.end())
+			bidSearched = it->second;
+	}
+
+	if (bidSearched != NULL)
 	{
 
 		// In any case deletes the bid into the service container, so the bid
 		// does not continue in the pareto front.
 		(*_current_bids).deleteBidToService(bidPtr);
+		markServiceChanged(bidPtr->getService());
 		// std::cout << "Bid inserted in the market place" << std::endl;
 
-		// Deletes all the neighbors of the bid
-		Bid * bidSearched = it->second;
+		// Deletes all the neighbors of the bid. Neighbors belong to the
+		// same service, so they are owned by this thread too.
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
 		std::vector<std::string> neigbors;
 		(*bidSearched).getNeighbors(neigbors);
 		std::vector<std::string>::iterator it_neighbors;
@@ -943,6 +1041,21 @@ void MarketPlaceSys::deleteBid(Bid * bidPtr, Message & messageResponse)
 		// Insert in the brodcast container
 		_bids_to_broadcast.insert(std::pair<std::string, Bid *> ((*bidPtr).getId(), bidPtr));
 
+		// Released with the bid once the retention is over.
+		if (_retention_periods > 0)
+		{
+			DeletedBid deleted;
+			deleted.period = _period;
+			deleted.id = bidPtr->getId();
+			deleted.request = bidPtr;
+			_deleted_bids.push_back(deleted);
+		}
+
+		std::vector<std::string> fields;
+		fields.push_back(bidPtr->getId());
+		fields.push_back(request);
+		journal(JOURNAL_DELETE_BID, fields);
+
 		app.logger().information("Ending delete Bid");
 
 		// set the response as Ok
@@ -954,7 +1067,7 @@ void MarketPlaceSys::deleteBid(Bid * bidPtr, Message & messageResponse)
 	}
 }
 
-void MarketPlaceSys::addPurchaseBulkCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, Message & messageResponse)
+void MarketPlaceSys::addPurchaseBulkCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, const std::string & request, Message & messageResponse)
 {
 
 	Poco::Util::Application& app = Poco::Util::Application::instance();
@@ -963,6 +1076,9 @@ void MarketPlaceSys::addPurchaseBulkCapacity(Provider *provider, Service *servic
 	double availability;
 	double qtyPurchased;
 
+	// Bulk capacity is shared by all the services of the provider.
+	Poco::FastMutex::ScopedLock lock(_availability_mutex);
+
 	availability = provider->getBulkAvailability(_period, service, bid);
 
 	app.logger().information(Poco::format("Availability: %f", availability) );
@@ -984,8 +1100,6 @@ void MarketPlaceSys::addPurchaseBulkCapacity(Provider *provider, Service *servic
 		(*_current_purchases).addPurchaseToService(purchasePtr, purchaseFound);
 
 		// std::cout << "Purchase inserted in the market place" << std::endl;
-		_purchases.insert(std::pair<std::string, Purchase *>((*purchasePtr).getId(), purchasePtr) );
-
 		// Deducts from the availability
 		provider->deductAvailability(_period, service, purchasePtr, bid);
 
@@ -1008,23 +1122,30 @@ void MarketPlaceSys::addPurchaseBulkCapacity(Provider *provider, Service *servic
 		qtyPurchased = 0;
 	}
 
+	// Under the availability lock, purchases of every service of the
+	// provider are replayed in the order they drew on its capacity.
+	std::vector<std::string> fields;
+	fields.push_back(request);
+	journal(JOURNAL_PURCHASE, fields);
+
 	app.logger().information(Poco::format("Ending addPurchaseBulkCapacity %f", qtyPurchased));
 
 }
 
-void MarketPlaceSys::addPurchaseByBidCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound,  Message & messageResponse)
+void MarketPlaceSys::addPurchaseByBidCapacity(Provider *provider, Service *service, Bid * bid, Purchase * purchasePtr, bool purchaseFound, const std::string & request, Message & messageResponse)
 {
 
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().debug("Entering addPurchaseByBidCapacity");
 
+	// The capacity of the bid changes in every branch.
+	markServiceChanged(bid->getService());
+
 	if (bid->getCapacity() >= purchasePtr->getQuantity())
 	{
 		// In any case inserts the purchase into the service container.
 		(*_current_purchases).addPurchaseToService(purchasePtr, purchaseFound);
 
-		_purchases.insert(std::pair<std::string, Purchase *>((*purchasePtr).getId(), purchasePtr) );
-
 		bid->setCapacity(bid->getCapacity() - purchasePtr->getQuantity());
 
 		messageResponse.setParameter("Quantity_Purchased", purchasePtr->getQuantityStr());
@@ -1043,15 +1164,18 @@ void MarketPlaceSys::addPurchaseByBidCapacity(Provider *provider, Service *servi
 		(*_current_purchases).addPurchaseToService(purchasePtr, purchaseFound);
 
 		// std::cout << "Purchase inserted in the market place" << std::endl;
-		_purchases.insert(std::pair<std::string, Purchase *>((*purchasePtr).getId(), purchasePtr) );
-
 		bid->setCapacity(bid->getCapacity() - purchasePtr->getQuantity());
 		messageResponse.setParameter("Quantity_Purchased", purchasePtr->getQuantityStr());
 
 	}
+
+	// The capacity of the bid is only used by the thread owning its service.
+	std::vector<std::string> fields;
+	fields.push_back(request);
+	journal(JOURNAL_PURCHASE, fields);
 }
 
-void MarketPlaceSys::addPurchase(Purchase * purchasePtr, Message & messageResponse)
+void MarketPlaceSys::addPurchase(Purchase * purchasePtr, const std::string & request, Message & messageResponse)
 {
 	Poco::Util::Application& app = Poco::Util::Application::instance();
 	app.logger().information(Poco::format("Add Purchase Id:%s :Period:%d :BidId:%s qtyRequested:%f", purchasePtr->getId(), (int) _period, purchasePtr->getBid(), purchasePtr->getQuantity() ));
@@ -1062,13 +1186,18 @@ void MarketPlaceSys::addPurchase(Purchase * purchasePtr, Message & messageRespon
 		// Search if the purchased has already sent for another bid.
 		bool purchaseFound = false;
 
-		std::map<std::string, int >::iterator it;
-		it = request_purchases.find(purchasePtr->getId());
-		if ( it !=  request_purchases.end()){
-			it->second = it->second + 1;
-			purchaseFound = true;
-		} else {
-			request_purchases.insert(std::pair<std::string,int>(purchasePtr->getId(),1));
+		{
+			Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+			std::map<std::string, int >::iterator it;
+			it = request_purchases.find(purchasePtr->getId());
+			if ( it !=  request_purchases.end()){
+				it->second = it->second + 1;
+				purchaseFound = true;
+			} else {
+				request_purchases.insert(std::pair<std::string,int>(purchasePtr->getId(),1));
+				if (_retention_periods > 0)
+					_purchase_request_periods.push_back(std::pair<unsigned, std::string>(_period, purchasePtr->getId()));
+			}
 		}
 
 		Bid * bid = getBid(purchasePtr->getBid());
@@ -1080,9 +1209,9 @@ void MarketPlaceSys::addPurchase(Purchase * purchasePtr, Message & messageRespon
 			Provider * provider = getProvider(bid->getProvider());
 
 			if (provider->getCapacityType() == BULK_CAPACITY)
-				addPurchaseBulkCapacity(provider, service, bid, purchasePtr, purchaseFound, messageResponse);
+				addPurchaseBulkCapacity(provider, service, bid, purchasePtr, purchaseFound, request, messageResponse);
 			else
-				addPurchaseByBidCapacity(provider, service, bid, purchasePtr, purchaseFound, messageResponse);
+				addPurchaseByBidCapacity(provider, service, bid, purchasePtr, purchaseFound, request, messageResponse);
 
 			app.logger().information("purchase message processed");
 
@@ -1096,6 +1225,11 @@ void MarketPlaceSys::addPurchase(Purchase * purchasePtr, Message & messageRespon
 			messageResponse.setParameter("Quantity_Purchased", "0");
 			// set the response as Ok
 			messageResponse.setResponseOk();
+
+			// Counted in the purchase requests.
+			std::vector<std::string> fields;
+			fields.push_back(request);
+			journal(JOURNAL_PURCHASE, fields);
 		}
 	} catch (MarketPlaceException &e) {
 		app.logger().error(Poco::format("could not purchase -raise exception error:%s", e.message()) );
@@ -1114,7 +1248,17 @@ void MarketPlaceSys::setProviderAvailability(std::string providerId,
 
 	Provider * provider = getProvider(providerId);
 	Resource * resource = getResource(resourceId);
-	provider->setInitialAvailability(resource, quantity);
+	{
+		Poco::FastMutex::ScopedLock lock(_availability_mutex);
+		provider->setInitialAvailability(resource, quantity);
+
+		// Under the lock, before any purchase deducting from it.
+		std::vector<std::string> fields;
+		fields.push_back(providerId);
+		fields.push_back(resourceId);
+		fields.push_back(formatJournalDouble(quantity));
+		journal(JOURNAL_AVAILABILITY, fields);
+	}
 	messageResponse.setResponseOk();
 	app.logger().information("Ending -------- MarketPlaceSys - setProviderAvailability");
 }
@@ -1132,6 +1276,7 @@ void MarketPlaceSys::getProviderAvailability(std::string providerId,
 
 	if (provider->getCapacityType() == BULK_CAPACITY)
 	{
+		Poco::FastMutex::ScopedLock lock(_availability_mutex);
 		getBulkAvailability(provider, service, messageResponse);
 	}
 	else{
@@ -1268,15 +1413,15 @@ void MarketPlaceSys::sendBid(std::string bidId, Message & messageResponse)
 
 void MarketPlaceSys::sendProviderChannel(std::string providerId, Message & messageResponse)
 {
-	std::map<std::string, Listener *>::iterator it = _listeners_by_id.find(providerId);
-	if( it != _listeners_by_id.end() )
+	Listener * listener = _listeners.find(providerId);
+	if (listener != NULL)
 	{
-		if ((*(it->second)).getStatus() == 1 ) // the listener is connected
+		if (listener->getStatus() == 1 ) // the listener is connected
 		{
 			messageResponse.setResponseOk();
-			Poco::Net::SocketAddress socketAddress = (*(it->second)).getSocketAddress();
-			std::string address = (socketAddress.host()).toString();
-			std::string portString = Poco::NumberFormatter::format((*(it->second)).getListeningPort());
+			Poco::Net::SocketAddress socketAddress = listener->getSocketAddress();
+			std::string address = NetworkServer::getCallbackHost(socketAddress).toString();
+			std::string portString = Poco::NumberFormatter::format(listener->getListeningPort());
 			messageResponse.setParameter("Address", address);
 			messageResponse.setParameter("Port", portString);
 		}
@@ -1293,6 +1438,7 @@ void MarketPlaceSys::sendProviderChannel(std::string providerId, Message & messa
 
 Provider * MarketPlaceSys::getProvider(std::string providerId)
 {
+	Poco::FastMutex::ScopedLock lock(_providers_mutex);
 	std::map<std::string, Provider *>::iterator it;
 	it = _providers.find(providerId);
 	if(it != _providers.end()) {
@@ -1308,6 +1454,7 @@ Provider * MarketPlaceSys::getProvider(std::string providerId)
 
 Bid * MarketPlaceSys::getBid(std::string bidId)
 {
+	Poco::FastMutex::ScopedLock lock(_bids_mutex);
 	BidContainer::iterator it;
 	it = _bids.find(bidId);
 	if ( it != _bids.end())
@@ -1322,24 +1469,285 @@ Bid * MarketPlaceSys::getBid(std::string bidId)
 	}
 }
 
-void MarketPlaceSys::storeCurrentPurchaseInformation()
+bool MarketPlaceSys::getBidService(std::string bidId, std::string & serviceId)
+{
+	Poco::FastMutex::ScopedLock lock(_bids_mutex);
+	BidContainer::iterator it;
+	it = _bids.find(bidId);
+	if ( it != _bids.end())
+	{
+		serviceId = (it->second)->getService();
+		return true;
+	}
+	return false;
+}
+
+MarketShardPool * MarketPlaceSys::getShardPool(void)
+{
+	return _shards;
+}
+
+void MarketPlaceSys::initializeShards(unsigned shards)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Starting %u market shards", shards));
+
+	// All services are registered upfront, so the service containers are
+	// never modified while the shards work on the service information.
+	ServiceContainer::iterator it_services;
+	for (it_services = _services.begin(); it_services != _services.end(); ++it_services)
+	{
+		if ((*_current_bids).existService(it_services->first) == false)
+			(*_current_bids).addService(it_services->first);
+	}
+
+	if (_current_purchases == NULL)
+		_current_purchases = new PurchaseInformation();
+
+	for (it_services = _services.begin(); it_services != _services.end(); ++it_services)
+		_current_purchases->addService(it_services->first);
+
+	_shards = new MarketShardPool(shards);
+}
+
+void MarketPlaceSys::quiesceShards(void)
+{
+	if (_shards != NULL)
+		_shards->barrier();
+}
+
+HandlerExecutor * MarketPlaceSys::getHandlerExecutor(void)
+{
+	return _handlers;
+}
+
+MessageScheduler * MarketPlaceSys::getMessageScheduler(void)
+{
+	return _scheduler;
+}
+
+MarketShardPool * MarketPlaceSys::getQueryPool(void)
+{
+	return _query_workers;
+}
+
+void MarketPlaceSys::initializeSnapshots(unsigned query_threads)
 {
 	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().information("Starting storeCurrentPurchaseInformation");
+	app.logger().information(Poco::format("Starting %u query threads", query_threads));
+
+	_snapshots = new MarketSnapshots();
+
+	unsigned owners = 1;
+	if (_shards != NULL)
+		owners = _shards->size();
+	_changed_services.resize(owners);
+
+	// Every service gets its first snapshot before any reader starts.
+	ServiceContainer::iterator it_services;
+	for (it_services = _services.begin(); it_services != _services.end(); ++it_services)
+	{
+		_snapshots->addService(it_services->first);
+		markServiceChanged(it_services->first);
+	}
 
-	if (_period > 0){
-		if (_current_purchases != NULL)
+	for (unsigned owner = 0; owner < owners; ++owner)
+		publishChangedServices(owner);
+
+	publishListenerDirectory();
+
+	if (_shards != NULL)
+	{
+		_shards->setIdleHandler([this](unsigned shard) { publishShardSnapshots(shard); });
+	}
+
+	_query_workers = new MarketShardPool(query_threads);
+}
+
+void MarketPlaceSys::markServiceChanged(std::string serviceId)
+{
+	if (_snapshots == NULL)
+		return;
+
+	unsigned owner = 0;
+	if (_shards != NULL)
+		owner = _shards->getShardIndex(serviceId);
+
+	_changed_services[owner].insert(serviceId);
+}
+
+void MarketPlaceSys::publishSnapshots(void)
+{
+	// With shards the services are republished by the shard threads.
+	if ((_snapshots != NULL) && (_shards == NULL))
+		publishChangedServices(0);
+
+	// The directory is rebuilt once for the agents connected or gone.
+	Poco::FastMutex::ScopedLock lock(_listeners_mutex);
+	if (_listeners_changed == true)
+	{
+		_listeners_changed = false;
+		publishListenerDirectory();
+	}
+}
+
+void MarketPlaceSys::publishShardSnapshots(unsigned shard)
+{
+	if (_snapshots != NULL)
+		publishChangedServices(shard);
+}
+
+void MarketPlaceSys::publishChangedServices(unsigned owner)
+{
+	int fronts = getParetoFrontsToExchange();
+
+	std::set<std::string>::iterator it;
+	for (it = _changed_services[owner].begin(); it != _changed_services[owner].end(); ++it)
+	{
+		std::shared_ptr<ServiceSnapshot> snapshot(
+				new ServiceSnapshot(*it, (*_current_bids).getBestBids(*it, fronts), fronts));
+
+		std::vector<Bid *> bids;
+		(*_current_bids).getActiveBids(*it, bids);
+		std::vector<Bid *>::iterator it_bids;
+		for (it_bids = bids.begin(); it_bids != bids.end(); ++it_bids)
 		{
-			_current_purchases->toDatabase(_pool, FoundationSys::getExecutionCount() , (int) _period -1 );
+			snapshot->addBid(*it_bids);
 		}
-		else{
-			app.logger().debug(Poco::format("no current purchases to store - Period:%d", (int) _period) );
+
+		_snapshots->publishService(snapshot);
+	}
+	_changed_services[owner].clear();
+}
+
+void MarketPlaceSys::publishListenerDirectory(void)
+{
+	if (_snapshots == NULL)
+		return;
+
+	std::shared_ptr<ListenerDirectory> directory(new ListenerDirectory());
+
+	std::vector<Listener *> list;
+	_listeners.getListeners(list);
+
+	std::vector<Listener *>::iterator it;
+	for (it = list.begin(); it != list.end(); ++it)
+	{
+		Poco::Net::SocketAddress socketAddress = (*it)->getSocketAddress();
+		directory->addListener((*it)->getId(),
+							   NetworkServer::getCallbackHost(socketAddress).toString(),
+							   Poco::NumberFormatter::format((*it)->getListeningPort()),
+							   ((*it)->getStatus() == 1));
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_providers_mutex);
+		std::map<std::string, Provider *>::iterator it_providers;
+		for (it_providers = _providers.begin(); it_providers != _providers.end(); ++it_providers)
+		{
+			directory->addProvider(it_providers->first, (it_providers->second)->getCapacityType());
 		}
 	}
-	else {
-		app.logger().debug(Poco::format("invalid period - Period:%d", (int) _period) );
+
+	_snapshots->publishListeners(directory);
+}
+
+bool MarketPlaceSys::answerFromSnapshot(Message & messageRequest, Message & messageResponse)
+{
+	// Returns false when the snapshot cannot answer the request, in which
+	// case it is executed by the regular path that also builds the errors.
+	if (_snapshots == NULL)
+		return false;
+
+	switch (messageRequest.getMethod())
+	{
+	   case get_best_bids:
+		 {
+			if ((messageRequest.existsParameter("Provider") == false)
+				  || (messageRequest.existsParameter("Service") == false))
+				return false;
+
+			std::string serviceId = messageRequest.getParameter("Service");
+			if ((messageRequest.getParameter("Provider")).empty() || serviceId.empty())
+				return false;
+
+			MarketSnapshots::ServiceSnapshotPtr snapshot = _snapshots->getService(serviceId);
+			if (!snapshot)
+				return false;
+
+			messageResponse.setResponseOk();
+			messageResponse.setParameter("Service", serviceId);
+			messageResponse.setParameter("Fronts", snapshot->getFronts());
+			messageResponse.setBody(snapshot->getBestBids());
+			return true;
+		 }
+	   case get_bid:
+		 {
+			if (messageRequest.existsParameter("Bid") == false)
+				return false;
+
+			std::string bidId = messageRequest.getParameter("Bid");
+			std::string serviceId;
+			if (getBidService(bidId, serviceId) == false)
+				return false;
+
+			MarketSnapshots::ServiceSnapshotPtr snapshot = _snapshots->getService(serviceId);
+			Message bidMessage;
+			if ((!snapshot) || (snapshot->getBid(bidId, bidMessage) == false))
+				return false;
+
+			Method method = messageResponse.getMethod();
+			messageResponse = bidMessage;
+			messageResponse.setMethod(method);
+			messageResponse.setResponseOk();
+			return true;
+		 }
+	   case get_availability:
+		 {
+			if ((messageRequest.existsParameter("Provider") == false)
+				  || (messageRequest.existsParameter("Service") == false)
+				  || (messageRequest.existsParameter("Bid") == false))
+				return false;
+
+			// Bulk availability is shared between services, it is always
+			// computed by the regular path.
+			ProviderCapacityType capacityType;
+			MarketSnapshots::ListenerDirectoryPtr directory = _snapshots->getListeners();
+			if ((directory->getCapacityType(messageRequest.getParameter("Provider"), capacityType) == false)
+				  || (capacityType == BULK_CAPACITY))
+				return false;
+
+			MarketSnapshots::ServiceSnapshotPtr snapshot = _snapshots->getService(messageRequest.getParameter("Service"));
+			double capacity = 0;
+			if ((!snapshot) || (snapshot->getBidCapacity(messageRequest.getParameter("Bid"), capacity) == false))
+				return false;
+
+			std::ostringstream sstream;
+			sstream << capacity;
+			messageResponse.setParameter("Quantity", sstream.str());
+			messageResponse.setResponseOk();
+			return true;
+		 }
+	   case get_provider_channel:
+		 {
+			if (messageRequest.existsParameter("ProviderId") == false)
+				return false;
+
+			std::string address;
+			std::string port;
+			MarketSnapshots::ListenerDirectoryPtr directory = _snapshots->getListeners();
+			if (directory->getChannel(messageRequest.getParameter("ProviderId"), address, port) == false)
+				return false;
+
+			messageResponse.setResponseOk();
+			messageResponse.setParameter("Address", address);
+			messageResponse.setParameter("Port", port);
+			return true;
+		 }
+	   default:
+		   break;
 	}
-	app.logger().information("Ending storeCurrentPurchaseInformation");
+	return false;
 }
 
 void MarketPlaceSys::deleteListener( Poco::Net::SocketAddress socketAddress,
@@ -1350,71 +1758,40 @@ void MarketPlaceSys::deleteListener( Poco::Net::SocketAddress socketAddress,
 	lstr << "Start deleteListener" << std::endl;
 	Listener *list = NULL;
 
-
-	// Find the listener
-	Listeners::iterator it;
-	bool found = false;
-
 	lstr << "Nbr Listeners:" << _listeners.size() << std::endl;
+	lstr << "Sock Address Par:" << socketAddress.toString() << std::endl;
 
-    std::string sockAddrPar = socketAddress.toString();
+	Poco::FastMutex::ScopedLock lock_listeners(_listeners_mutex);
 
-    lstr << "Sock Address Par:" << sockAddrPar << std::endl;
-	it = _listeners.begin();
-	while( (it!=_listeners.end()) && (found ==false) )
-	{
-		Poco::Net::SocketAddress sa = (*(it->second)).getSocketAddress();
-		std::string sockAddrStr = sa.toString();
+	// Take the listener out of every index.
+	list = _listeners.remove(socketAddress);
 
-		lstr << "Ssock Address:" << sockAddrStr << std::endl;
+	lstr << "address found:" << (list != NULL) << std::endl;
 
-		if ( sockAddrPar.compare(sockAddrStr) == 0 ){
-		   found = true;
-		   break;
-		}
-		++it;
-	}
-
-    lstr << "address found:" << found << std::endl;
-
-    if (found == true){
-		list = it->second;
-		_listeners.erase(it);
+	if (list != NULL){
 		std::string idListener = list->getId();
-		std::string type = list->getTypeStr();
-
-    	// Delete the listener from the list of listeners by type.
-		std::map<std::string, std::vector<std::string> >::iterator it2;
-		it2 = _listeners_by_type.find(type);
-		if (it2 != _listeners_by_type.end()){
-			std::vector<std::string>::iterator it3;
-			for (it3 = (it2->second).begin(); it3 != (it2->second).end(); ++it3 ){
-				if (it3->compare(idListener) == 0){
-					(it2->second).erase(it3);
-					break;
-				}
-			}
-		}
-
-		// These two containers act as indexes for the listeners container.
-		std::map<std::string, Listener *>::iterator it4;
-		it4 = _listeners_by_id.find(idListener);
-		if (it4 != _listeners_by_id.end()){
-			_listeners_by_id.erase(it4);
-		}
 
 		// Delete from  provider.
 		if ( list->getType() == PROVIDER){
+			// No shard can be using the provider while it is removed.
+			quiesceShards();
+			Poco::FastMutex::ScopedLock lock(_providers_mutex);
 			std::map<std::string, Provider *>::iterator it5;
-			for (it5 = _providers.begin(); it5 != _providers.end(); ++it5){
+			it5 = _providers.find(idListener);
+			if (it5 != _providers.end()){
 				delete (it5->second);
 				_providers.erase(it5);
-				break;
+
+				// Not brought back when the journal is replayed.
+				std::vector<std::string> fields;
+				fields.push_back(idListener);
+				journal(JOURNAL_REMOVE_PROVIDER, fields);
 			}
 		}
 
 		// Disconnect the socket.
 		list->Disconnect();
+		_listeners_changed = true;
 
 		// Finally dispose the listener object
 		delete list;
@@ -1424,6 +1801,495 @@ void MarketPlaceSys::deleteListener( Poco::Net::SocketAddress socketAddress,
 
 }
 
+void MarketPlaceSys::journal(char type, const std::vector<std::string> & fields)
+{
+	if ((_journal != NULL) && (_recovering == false))
+		_journal->append(type, fields);
+}
+
+void MarketPlaceSys::initializeJournal(const std::string & path, bool recover, long flushInterval)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	std::vector<JournalRecord> records;
+	std::size_t size = 0;
+	if (recover)
+	{
+		size = MarketJournal::read(path, records);
+		app.logger().information(Poco::format("Recovering %z records (%z bytes) from the journal %s",
+								 records.size(), size, path));
+	}
+
+	_journal = new MarketJournal(path, flushInterval);
+
+	if (records.size() > 0)
+	{
+		_recovering = true;
+		unsigned failed = 0;
+		std::vector<JournalRecord>::iterator it;
+		for (it = records.begin(); it != records.end(); ++it)
+		{
+			try
+			{
+				replay(*it);
+				_journal->track(*it);
+			}
+			catch (Poco::Exception &e)
+			{
+				// It failed the same way before the restart.
+				++failed;
+				app.logger().debug(Poco::format("Journal record %c not replayed: %s",
+								   it->type, e.displayText()));
+			}
+		}
+		_recovering = false;
+		app.logger().information(Poco::format("Journal replayed period:%d bids:%z records failed:%u",
+								 (int) _period, _bids.size(), failed));
+	}
+
+	// A recovered journal goes on after its last complete record, it is
+	// compacted when the next period is closed. Otherwise it starts empty.
+	if (recover)
+		_journal->open(size);
+	else
+		compactJournal();
+	_journal->start();
+}
+
+void MarketPlaceSys::replay(const JournalRecord & record)
+{
+	Message messageResponse;
+
+	switch (record.type)
+	{
+	case JOURNAL_PROVIDER:
+		{
+			Poco::FastMutex::ScopedLock lock(_providers_mutex);
+			if (_providers.find(record.fields[0]) == _providers.end())
+			{
+				ProviderCapacityType capacity_type = (ProviderCapacityType)
+							Poco::NumberParser::parse(record.fields[1]);
+				_providers.insert(std::pair<std::string, Provider *>(record.fields[0],
+								  new Provider(record.fields[0], capacity_type)));
+			}
+		}
+		break;
+	case JOURNAL_REMOVE_PROVIDER:
+		{
+			Poco::FastMutex::ScopedLock lock(_providers_mutex);
+			std::map<std::string, Provider *>::iterator it = _providers.find(record.fields[0]);
+			if (it != _providers.end())
+			{
+				delete it->second;
+				_providers.erase(it);
+			}
+		}
+		break;
+	case JOURNAL_AVAILABILITY:
+		setProviderAvailability(record.fields[0], record.fields[1],
+								Poco::NumberParser::parseFloat(record.fields[2]), messageResponse);
+		break;
+	case JOURNAL_ADD_BID:
+	case JOURNAL_DELETE_BID:
+		{
+			Message request(record.fields[1]);
+			Service * service = getService(request.getParameter("Service"));
+			Bid * bidPtr = new Bid(service, request);
+			if (record.type == JOURNAL_ADD_BID)
+				addBid(bidPtr, record.fields[1], messageResponse);
+			else
+				deleteBid(bidPtr, record.fields[1], messageResponse);
+		}
+		break;
+	case JOURNAL_PURCHASE:
+		{
+			Message request(record.fields[0]);
+			Service * service = getService(request.getParameter("Service"));
+			Purchase purchase(service, request);
+			purchase.setQuantityBacklog(0);
+			addPurchase(&purchase, record.fields[0], messageResponse);
+		}
+		break;
+	case JOURNAL_START_PERIOD:
+		initializePeriodSession(Poco::NumberParser::parseUnsigned(record.fields[0]));
+		break;
+	case JOURNAL_END_PERIOD:
+		finalizePeriodSession(Poco::NumberParser::parseUnsigned(record.fields[0]), messageResponse);
+		break;
+	case JOURNAL_PERIOD:
+		{
+			// Ends the bids of a compacted journal, written when a period
+			// was closed: none of them is waiting to be broadcast.
+			_period = Poco::NumberParser::parseUnsigned(record.fields[0]);
+			Poco::FastMutex::ScopedLock lock(_bids_mutex);
+			_bids_to_broadcast.clear();
+		}
+		break;
+	case JOURNAL_BID_CAPACITY:
+		getBid(record.fields[0])->setCapacity(Poco::NumberParser::parseFloat(record.fields[1]));
+		break;
+	case JOURNAL_PURCHASE_REQUESTS:
+		{
+			Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+			if ((_retention_periods > 0) && (request_purchases.count(record.fields[0]) == 0))
+				_purchase_request_periods.push_back(std::pair<unsigned, std::string>(_period, record.fields[0]));
+			request_purchases[record.fields[0]] = Poco::NumberParser::parse(record.fields[1]);
+		}
+		break;
+	case JOURNAL_PERIOD_AVAILABILITY:
+		{
+			Provider * provider = getProvider(record.fields[0]);
+			Poco::FastMutex::ScopedLock lock(_availability_mutex);
+			provider->setResourceAvailability(Poco::NumberParser::parseUnsigned(record.fields[2]),
+											  record.fields[1],
+											  Poco::NumberParser::parseFloat(record.fields[3]));
+		}
+		break;
+	default:
+		throw MarketPlaceException("Unknown journal record", 345);
+	}
+}
+
+void MarketPlaceSys::compactJournal(void)
+{
+	// The providers, availabilities and bids are kept by the journal, the
+	// market adds what the purchases of the closed periods changed.
+	std::vector<JournalRecord> state;
+
+	JournalRecord period;
+	period.type = JOURNAL_PERIOD;
+	period.fields.push_back(Poco::NumberFormatter::format(_period));
+	state.push_back(period);
+
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		BidContainer::iterator it;
+		for (it = _bids.begin(); it != _bids.end(); ++it)
+		{
+			Bid * bid = it->second;
+			if (bid->getCapacity() != bid->getInitCapacity())
+			{
+				JournalRecord capacity;
+				capacity.type = JOURNAL_BID_CAPACITY;
+				capacity.fields.push_back(it->first);
+				capacity.fields.push_back(formatJournalDouble(bid->getCapacity()));
+				state.push_back(capacity);
+			}
+		}
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+		std::map<std::string, int>::iterator it;
+		for (it = request_purchases.begin(); it != request_purchases.end(); ++it)
+		{
+			JournalRecord requests;
+			requests.type = JOURNAL_PURCHASE_REQUESTS;
+			requests.fields.push_back(it->first);
+			requests.fields.push_back(Poco::NumberFormatter::format(it->second));
+			state.push_back(requests);
+		}
+	}
+
+	// The purchases of the current period already deducted from it.
+	std::vector<std::pair<std::string, std::string> > availabilities;
+	_journal->getAvailabilities(availabilities);
+	std::vector<std::pair<std::string, std::string> >::iterator it;
+	for (it = availabilities.begin(); it != availabilities.end(); ++it)
+	{
+		Poco::FastMutex::ScopedLock lock(_providers_mutex);
+		std::map<std::string, Provider *>::iterator it_provider = _providers.find(it->first);
+		if (it_provider == _providers.end())
+			continue;
+
+		Poco::FastMutex::ScopedLock availabilityLock(_availability_mutex);
+		JournalRecord availability;
+		availability.type = JOURNAL_PERIOD_AVAILABILITY;
+		availability.fields.push_back(it->first);
+		availability.fields.push_back(it->second);
+		availability.fields.push_back(Poco::NumberFormatter::format(_period));
+		availability.fields.push_back(formatJournalDouble(
+				it_provider->second->getResourceAvailability(_period, it->second)));
+		state.push_back(availability);
+	}
+
+	_journal->compact(state);
+	_periods_since_compaction = 0;
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Journal compacted at period %d, %z state records",
+							 (int) _period, state.size()));
+}
+
+void MarketPlaceSys::releaseExpiredState(void)
+{
+	if (_retention_periods == 0)
+		return;
+
+	// Out of the fronts, a bid is only looked up by the late purchases.
+	std::set<std::string> released;
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		while ((_deleted_bids.empty() == false)
+				&& (_deleted_bids.front().period + _retention_periods <= _period))
+		{
+			DeletedBid & deleted = _deleted_bids.front();
+			BidContainer::iterator it = _bids.find(deleted.id);
+			if (it != _bids.end())
+			{
+				released.insert(deleted.id);
+				if (it->second != deleted.request)
+					delete it->second;
+				_bids.erase(it);
+			}
+			delete deleted.request;
+			_deleted_bids.pop_front();
+		}
+	}
+
+	unsigned long requests = 0;
+	{
+		Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+		while ((_purchase_request_periods.empty() == false)
+				&& (_purchase_request_periods.front().first + _retention_periods <= _period))
+		{
+			request_purchases.erase(_purchase_request_periods.front().second);
+			_purchase_request_periods.pop_front();
+			++requests;
+		}
+	}
+
+	if ((_journal != NULL) && (released.empty() == false))
+		_journal->forgetBids(released);
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Period %d retention released bids:%z purchase requests:%lu history hot:%z spilled:%z",
+							 (int) _period, released.size(), requests,
+							 _purchase_history.getHotPeriods(), _purchase_history.getSpilledPeriods()));
+}
+
+void MarketPlaceSys::requestCheckpoint(std::string path, Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	if (path.empty())
+		path = _checkpoint_path;
+
+	{
+		Poco::FastMutex::ScopedLock lock(_checkpoint_mutex);
+		_checkpoint_request = path;
+	}
+
+	app.logger().information(Poco::format("Market checkpoint requested at period %d: %s",
+							 (int) _period, path));
+	messageResponse.setParameter("Path", path);
+	messageResponse.setResponseOk();
+}
+
+void MarketPlaceSys::writeCheckpoint(const std::string & path)
+{
+	MarketState state;
+	state.period = _period;
+
+	{
+		Poco::FastMutex::ScopedLock lock(_providers_mutex);
+		Poco::FastMutex::ScopedLock availabilityLock(_availability_mutex);
+		std::map<std::string, Provider *>::iterator it;
+		for (it = _providers.begin(); it != _providers.end(); ++it)
+		{
+			CheckpointProvider provider;
+			provider.id = it->first;
+			provider.capacity_type = (int) it->second->getCapacityType();
+
+			std::vector<std::string> resourceIds;
+			it->second->getResources(resourceIds);
+			for (std::size_t i = 0; i < resourceIds.size(); ++i)
+			{
+				CheckpointResource resource;
+				resource.id = resourceIds[i];
+				resource.initial = 0;
+				it->second->getAvailabilities(resource.id, resource.initial, resource.periods);
+				provider.resources.push_back(resource);
+			}
+			state.providers.push_back(provider);
+		}
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		BidContainer::iterator it;
+		for (it = _bids.begin(); it != _bids.end(); ++it)
+		{
+			Bid * bidPtr = it->second;
+			CheckpointBid bid;
+			bid.id = it->first;
+			bid.provider = bidPtr->getProvider();
+			bid.service = bidPtr->getService();
+			bid.status = bidPtr->getStatus();
+			bid.active = (*_current_bids).isBidActive(bid.service, bid.provider, bid.id);
+			bid.unitary_profit = bidPtr->getUnitaryProfit();
+			bid.unitary_cost = bidPtr->getUnitaryCost();
+			bid.parent_bid_id = bidPtr->getParentBidId();
+			bid.capacity = bidPtr->getCapacity();
+			bid.init_capacity = bidPtr->getInitCapacity();
+			bid.creation_period = bidPtr->getCreationPeriod();
+			bidPtr->getDBDecisionVariables(&bid.decision_variables);
+			state.bids.push_back(bid);
+		}
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+		state.purchase_requests = request_purchases;
+	}
+
+	// The closed periods are not modified anymore. The ones released by
+	// the retention are not in the checkpoint.
+	std::vector<std::string> periods;
+	_purchase_history.getPeriods(periods);
+	std::vector<std::string>::iterator it_period;
+	for (it_period = periods.begin(); it_period != periods.end(); ++it_period)
+	{
+		std::vector<PurchaseServiceBidStruct> rows;
+		if (_purchase_history.getPurchases(*it_period, rows) == false)
+			continue;
+		std::vector<CheckpointPurchase> & purchases = state.purchase_history[*it_period];
+		for (std::size_t i = 0; i < rows.size(); ++i)
+		{
+			CheckpointPurchase purchase;
+			purchase.service_id = rows[i]._serviceId;
+			purchase.bid_id = rows[i]._bidId;
+			purchase.quantity = rows[i]._quantity;
+			purchase.quantity_backlog = rows[i]._quantity_backlog;
+			purchases.push_back(purchase);
+		}
+	}
+
+	MarketCheckpoint::write(path, state);
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Market checkpoint written at period %d: %s providers:%z bids:%z",
+							 (int) _period, path, state.providers.size(), state.bids.size()));
+}
+
+void MarketPlaceSys::restoreCheckpoint(const std::string & path)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	MarketState state;
+	std::string reason;
+	if (MarketCheckpoint::read(path, state, reason) == false)
+		throw MarketPlaceException("Market checkpoint " + path + " not restored: " + reason, 346);
+
+	Message messageResponse;
+	_period = state.period;
+
+	// Through the operations of the agents, so the journal, when there is
+	// one, tracks the providers, availabilities and bids restored.
+	std::vector<CheckpointProvider>::iterator it_provider;
+	for (it_provider = state.providers.begin(); it_provider != state.providers.end(); ++it_provider)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_providers_mutex);
+			_providers.insert(std::pair<std::string, Provider *>(it_provider->id,
+							  new Provider(it_provider->id, (ProviderCapacityType) it_provider->capacity_type)));
+		}
+		std::vector<std::string> fields;
+		fields.push_back(it_provider->id);
+		fields.push_back(Poco::NumberFormatter::format(it_provider->capacity_type));
+		journal(JOURNAL_PROVIDER, fields);
+
+		Provider * provider = getProvider(it_provider->id);
+		std::vector<CheckpointResource>::iterator it_resource;
+		for (it_resource = it_provider->resources.begin(); it_resource != it_provider->resources.end(); ++it_resource)
+		{
+			setProviderAvailability(it_provider->id, it_resource->id, it_resource->initial, messageResponse);
+
+			Poco::FastMutex::ScopedLock lock(_availability_mutex);
+			std::map<unsigned, double>::iterator it_period;
+			for (it_period = it_resource->periods.begin(); it_period != it_resource->periods.end(); ++it_period)
+				provider->setResourceAvailability(it_period->first, it_resource->id, it_period->second);
+		}
+	}
+
+	std::vector<CheckpointBid>::iterator it_bid;
+	for (it_bid = state.bids.begin(); it_bid != state.bids.end(); ++it_bid)
+	{
+		// The bid as the provider sent it.
+		Message request;
+		request.setMethod(receive_bid);
+		request.setParameter("Id", it_bid->id);
+		request.setParameter("Provider", it_bid->provider);
+		request.setParameter("Service", it_bid->service);
+		request.setParameter("Status", it_bid->status);
+		request.setParameter("UnitaryProfit", formatJournalDouble(it_bid->unitary_profit));
+		request.setParameter("UnitaryCost", formatJournalDouble(it_bid->unitary_cost));
+		request.setParameter("ParentBid", it_bid->parent_bid_id);
+		request.setParameter("Capacity", formatJournalDouble(it_bid->init_capacity));
+		request.setParameter("CreationPeriod", Poco::NumberFormatter::format(it_bid->creation_period));
+		std::map<std::string, double>::iterator it_variable;
+		for (it_variable = it_bid->decision_variables.begin(); it_variable != it_bid->decision_variables.end(); ++it_variable)
+			request.setParameter(it_variable->first, formatJournalDouble(it_variable->second));
+
+		Service * service = getService(it_bid->service);
+		Bid * bidPtr = new Bid(service, request);
+		bidPtr->setCapacity(it_bid->capacity);
+
+		addBid(bidPtr, request.to_string(), messageResponse);
+
+		// Out of the fronts, but still purchasable by id.
+		if (it_bid->active == false)
+			deleteBid(bidPtr, request.to_string(), messageResponse);
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_purchases_mutex);
+		request_purchases = state.purchase_requests;
+		if (_retention_periods > 0)
+		{
+			std::map<std::string, int>::iterator it;
+			for (it = request_purchases.begin(); it != request_purchases.end(); ++it)
+				_purchase_request_periods.push_back(std::pair<unsigned, std::string>(_period, it->first));
+		}
+	}
+
+	// The keys are the period followed by the subperiod, added in the
+	// order they were closed so the retention keeps the last ones.
+	std::map<Poco::UInt64, std::string> closed;
+	std::map<std::string, std::vector<CheckpointPurchase> >::iterator it_history;
+	for (it_history = state.purchase_history.begin(); it_history != state.purchase_history.end(); ++it_history)
+	{
+		Poco::UInt64 order = 0;
+		Poco::NumberParser::tryParseUnsigned64(it_history->first, order);
+		closed[order] = it_history->first;
+	}
+
+	std::map<Poco::UInt64, std::string>::iterator it_closed;
+	for (it_closed = closed.begin(); it_closed != closed.end(); ++it_closed)
+	{
+		std::vector<CheckpointPurchase> & rows = state.purchase_history[it_closed->second];
+		PurchaseInformation * purchases = new PurchaseInformation();
+		std::vector<CheckpointPurchase>::iterator it_purchase;
+		for (it_purchase = rows.begin(); it_purchase != rows.end(); ++it_purchase)
+			purchases->setPurchaseQuantities(it_purchase->service_id, it_purchase->bid_id,
+											 it_purchase->quantity, it_purchase->quantity_backlog);
+		_purchase_history.add(it_closed->second, purchases);
+	}
+
+	// Restored at a period boundary, nothing is waiting to be broadcast.
+	{
+		Poco::FastMutex::ScopedLock lock(_bids_mutex);
+		_bids_to_broadcast.clear();
+	}
+
+	// The capacities and availabilities left are only in the compaction.
+	if (_journal != NULL)
+		compactJournal();
+
+	app.logger().information(Poco::format("Market checkpoint restored at period %d: %s providers:%z bids:%z",
+							 (int) _period, path, state.providers.size(), state.bids.size()));
+}
+
 bool MarketPlaceSys::sendInformation(unsigned interval)
 {
 
@@ -0,0 +1,220 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Semaphore.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Exception.h>
+#include <Poco/NumberFormatter.h>
+#include <exception>
+
+#include "MarketShard.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+MarketShardTask::MarketShardTask(const Task & task):
+_task(task)
+{
+}
+
+void MarketShardTask::execute()
+{
+	_task();
+}
+
+
+MarketShard::MarketShard(unsigned index):
+_index(index),
+_stopped(true),
+_thread("MarketShard" + Poco::NumberFormatter::format(index))
+{
+}
+
+MarketShard::~MarketShard()
+{
+	stop();
+}
+
+void MarketShard::start()
+{
+	_stopped = false;
+	_thread.start(*this);
+}
+
+void MarketShard::stop()
+{
+	if (_stopped == false)
+	{
+		_stopped = true;
+		_queue.wakeUpAll();
+		_thread.join();
+	}
+}
+
+void MarketShard::post(const MarketShardTask::Task & task)
+{
+	_queue.enqueueNotification(new MarketShardTask(task));
+}
+
+void MarketShard::setIdleHandler(const std::function<void(unsigned)> & handler)
+{
+	_idle_handler = handler;
+}
+
+int MarketShard::queued()
+{
+	return _queue.size();
+}
+
+unsigned MarketShard::getIndex()
+{
+	return _index;
+}
+
+void MarketShard::run()
+{
+	// Nothing may end the thread, the barriers wait for every shard.
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Market shard %u started", _index));
+
+	while (_stopped == false)
+	{
+		Poco::AutoPtr<Poco::Notification> pNf(_queue.waitDequeueNotification());
+		if (pNf.isNull())
+			break;
+
+		MarketShardTask * task = dynamic_cast<MarketShardTask *>(pNf.get());
+		if (task != NULL)
+		{
+			try
+			{
+				task->execute();
+			}
+			catch (Poco::Exception &e)
+			{
+				app.logger().error(Poco::format("Market shard %u - error:%s", _index, e.displayText()));
+			}
+			catch (std::exception &e)
+			{
+				app.logger().error(Poco::format("Market shard %u - error:%s", _index, std::string(e.what())));
+			}
+			catch (...)
+			{
+				app.logger().error(Poco::format("Market shard %u - unknown error", _index));
+			}
+		}
+
+		if ((_idle_handler) && (_queue.empty()))
+		{
+			try
+			{
+				_idle_handler(_index);
+			}
+			catch (Poco::Exception &e)
+			{
+				app.logger().error(Poco::format("Market shard %u - error:%s", _index, e.displayText()));
+			}
+			catch (std::exception &e)
+			{
+				app.logger().error(Poco::format("Market shard %u - error:%s", _index, std::string(e.what())));
+			}
+			catch (...)
+			{
+				app.logger().error(Poco::format("Market shard %u - unknown error", _index));
+			}
+		}
+	}
+
+	app.logger().information(Poco::format("Market shard %u stopped", _index));
+}
+
+
+MarketShardPool::MarketShardPool(unsigned shards):
+_stopped(false)
+{
+	for (unsigned i = 0; i < shards; ++i)
+	{
+		MarketShard * shard = new MarketShard(i);
+		_shards.push_back(shard);
+		shard->start();
+	}
+}
+
+MarketShardPool::~MarketShardPool()
+{
+	stop();
+
+	std::vector<MarketShard *>::iterator it;
+	for (it = _shards.begin(); it != _shards.end(); ++it)
+	{
+		delete *it;
+	}
+	_shards.clear();
+}
+
+unsigned MarketShardPool::size()
+{
+	return _shards.size();
+}
+
+unsigned MarketShardPool::getShardIndex(const std::string & serviceId)
+{
+	return (unsigned) (_hash(serviceId) % _shards.size());
+}
+
+void MarketShardPool::post(const std::string & serviceId, const MarketShardTask::Task & task)
+{
+	_shards[getShardIndex(serviceId)]->post(task);
+}
+
+void MarketShardPool::post(const MarketShardTask::Task & task)
+{
+	unsigned next = (unsigned) (_next_shard++);
+	_shards[next % _shards.size()]->post(task);
+}
+
+void MarketShardPool::setIdleHandler(const std::function<void(unsigned)> & handler)
+{
+	std::vector<MarketShard *>::iterator it;
+	for (it = _shards.begin(); it != _shards.end(); ++it)
+	{
+		(*it)->setIdleHandler(handler);
+	}
+}
+
+void MarketShardPool::barrier()
+{
+	Poco::Semaphore arrived(0, (int) _shards.size());
+
+	std::vector<MarketShard *>::iterator it;
+	for (it = _shards.begin(); it != _shards.end(); ++it)
+	{
+		(*it)->post([&arrived]() { arrived.set(); });
+	}
+
+	for (unsigned i = 0; i < _shards.size(); ++i)
+	{
+		arrived.wait();
+	}
+}
+
+void MarketShardPool::stop()
+{
+	if (_stopped == true)
+		return;
+
+	// Let the shards finish the work already queued.
+	barrier();
+	_stopped = true;
+
+	std::vector<MarketShard *>::iterator it;
+	for (it = _shards.begin(); it != _shards.end(); ++it)
+	{
+		(*it)->stop();
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
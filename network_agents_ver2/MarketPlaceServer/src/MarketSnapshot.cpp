@@ -0,0 +1,158 @@
+#include "MarketSnapshot.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ServiceSnapshot::ServiceSnapshot(std::string serviceId, std::string bestBids, int fronts):
+_service_id(serviceId),
+_best_bids(bestBids),
+_fronts(fronts)
+{
+}
+
+void ServiceSnapshot::addBid(Bid * bidPtr)
+{
+	BidEntry entry;
+	bidPtr->toMessage(entry.message);
+	entry.capacity = bidPtr->getCapacity();
+	_bids.insert(std::pair<std::string, BidEntry>(bidPtr->getId(), entry));
+}
+
+std::string ServiceSnapshot::getServiceId() const
+{
+	return _service_id;
+}
+
+const std::string & ServiceSnapshot::getBestBids() const
+{
+	return _best_bids;
+}
+
+int ServiceSnapshot::getFronts() const
+{
+	return _fronts;
+}
+
+bool ServiceSnapshot::getBid(const std::string & bidId, Message & message) const
+{
+	std::map<std::string, BidEntry>::const_iterator it;
+	it = _bids.find(bidId);
+	if (it != _bids.end())
+	{
+		message = (it->second).message;
+		return true;
+	}
+	return false;
+}
+
+bool ServiceSnapshot::getBidCapacity(const std::string & bidId, double & capacity) const
+{
+	std::map<std::string, BidEntry>::const_iterator it;
+	it = _bids.find(bidId);
+	if (it != _bids.end())
+	{
+		capacity = (it->second).capacity;
+		return true;
+	}
+	return false;
+}
+
+
+void ListenerDirectory::addListener(std::string listenerId, std::string address,
+									std::string port, bool connected)
+{
+	Channel channel;
+	channel.address = address;
+	channel.port = port;
+	channel.connected = connected;
+	_channels.insert(std::pair<std::string, Channel>(listenerId, channel));
+}
+
+void ListenerDirectory::addProvider(std::string providerId, ProviderCapacityType capacityType)
+{
+	_capacity_types.insert(std::pair<std::string, ProviderCapacityType>(providerId, capacityType));
+}
+
+bool ListenerDirectory::getChannel(const std::string & listenerId,
+								   std::string & address, std::string & port) const
+{
+	std::map<std::string, Channel>::const_iterator it;
+	it = _channels.find(listenerId);
+	if ((it != _channels.end()) && ((it->second).connected == true))
+	{
+		address = (it->second).address;
+		port = (it->second).port;
+		return true;
+	}
+	return false;
+}
+
+bool ListenerDirectory::getCapacityType(const std::string & providerId,
+										ProviderCapacityType & capacityType) const
+{
+	std::map<std::string, ProviderCapacityType>::const_iterator it;
+	it = _capacity_types.find(providerId);
+	if (it != _capacity_types.end())
+	{
+		capacityType = it->second;
+		return true;
+	}
+	return false;
+}
+
+
+MarketSnapshots::MarketSnapshots():
+_listeners(new ListenerDirectory())
+{
+}
+
+MarketSnapshots::~MarketSnapshots()
+{
+}
+
+void MarketSnapshots::addService(std::string serviceId)
+{
+	if (_services.find(serviceId) == _services.end())
+	{
+		ServiceSnapshotPtr empty;
+		_services.insert(std::pair<std::string, ServiceSnapshotPtr>(serviceId, empty));
+	}
+}
+
+MarketSnapshots::ServiceSnapshotPtr MarketSnapshots::getService(const std::string & serviceId) const
+{
+	std::map<std::string, ServiceSnapshotPtr>::const_iterator it;
+	it = _services.find(serviceId);
+	if (it != _services.end())
+	{
+		return std::atomic_load(&(it->second));
+	}
+	return ServiceSnapshotPtr();
+}
+
+void MarketSnapshots::publishService(const ServiceSnapshotPtr & snapshot)
+{
+	std::map<std::string, ServiceSnapshotPtr>::iterator it;
+	it = _services.find(snapshot->getServiceId());
+	if (it != _services.end())
+	{
+		std::atomic_store(&(it->second), snapshot);
+	}
+}
+
+MarketSnapshots::ListenerDirectoryPtr MarketSnapshots::getListeners() const
+{
+	return std::atomic_load(&_listeners);
+}
+
+void MarketSnapshots::publishListeners(const ListenerDirectoryPtr & directory)
+{
+	std::atomic_store(&_listeners, directory);
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,218 @@
+#include <Poco/Util/Application.h>
+
+#include "MessageScheduler.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+MessageScheduler::MessageScheduler(std::size_t capacity, unsigned batch,
+								   Poco::Timestamp::TimeDiff maxWait):
+_capacity(capacity),
+_batch(batch),
+_max_wait(maxWait),
+_drain_pending(false),
+_next_sequence(0)
+{
+	if (_batch == 0)
+		_batch = 1;
+	resetStats();
+}
+
+MessageScheduler::~MessageScheduler()
+{
+}
+
+MessagePriority MessageScheduler::classify(Method method)
+{
+	switch (method){
+	   case start_period:
+	   case end_period:
+	   case connect:
+	   case send_port:
+	   case disconnect:
+	   case snapshot:
+		   return PRIORITY_CONTROL;
+	   case receive_purchase:
+		   return PRIORITY_PURCHASE;
+	   case receive_bid:
+	   case send_availability:
+		   return PRIORITY_BID;
+	   default:
+		   return PRIORITY_QUERY;
+	}
+}
+
+bool MessageScheduler::isBarrier(Method method)
+{
+	return (method == start_period) || (method == end_period);
+}
+
+std::string MessageScheduler::getClassName(MessagePriority priority)
+{
+	switch (priority){
+	   case PRIORITY_CONTROL:
+		   return "control";
+	   case PRIORITY_PURCHASE:
+		   return "purchase";
+	   case PRIORITY_BID:
+		   return "bid";
+	   default:
+		   return "query";
+	}
+}
+
+bool MessageScheduler::push(MessagePriority priority, bool barrier, const Task & task)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	// While a period transition waits, the work queued before it holds it
+	// back, so no lower class request is let in to add to that work.
+	if ((priority != PRIORITY_CONTROL) &&
+		((_queues[priority].size() >= _capacity) || (_barriers.empty() == false)))
+	{
+		++(_stats[priority].rejected);
+		return false;
+	}
+
+	Entry entry;
+	entry.task = task;
+	entry.sequence = _next_sequence++;
+	entry.barrier = barrier;
+	_queues[priority].push_back(entry);
+	if (barrier)
+		_barriers.push_back(entry.sequence);
+	return true;
+}
+
+bool MessageScheduler::pop(Task & task, MessagePriority & priority)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	// Only the requests queued before the first barrier can go, and the
+	// barrier itself once none of them is left in the other classes.
+	bool eligible[PRIORITY_CLASSES];
+	for (int i = 0; i < PRIORITY_CLASSES; ++i)
+		eligible[i] = !_queues[i].empty();
+	if (_barriers.empty() == false)
+	{
+		Poco::UInt64 limit = _barriers.front();
+		bool earlier = false;
+		for (int i = 0; i < PRIORITY_CLASSES; ++i)
+		{
+			if (eligible[i] && (i != PRIORITY_CONTROL))
+			{
+				eligible[i] = (_queues[i].front().sequence < limit);
+				earlier = earlier || eligible[i];
+			}
+		}
+		if (earlier && _queues[PRIORITY_CONTROL].front().barrier)
+			eligible[PRIORITY_CONTROL] = false;
+	}
+
+	int selected = -1;
+	Poco::Timestamp::TimeDiff oldest = 0;
+
+	// A request waiting more than the maximum goes first, the oldest of
+	// them when there are several.
+	for (int i = 0; i < PRIORITY_CLASSES; ++i)
+	{
+		if (!eligible[i])
+			continue;
+		Poco::Timestamp::TimeDiff waited = _queues[i].front().queued.elapsed();
+		if ((waited > _max_wait) && (waited > oldest))
+		{
+			selected = i;
+			oldest = waited;
+		}
+	}
+
+	if (selected < 0)
+	{
+		for (int i = 0; i < PRIORITY_CLASSES; ++i)
+		{
+			if (eligible[i])
+			{
+				selected = i;
+				break;
+			}
+		}
+	}
+
+	if (selected < 0)
+		return false;
+
+	Entry & entry = _queues[selected].front();
+	Poco::Timestamp::TimeDiff delay = entry.queued.elapsed();
+	task = entry.task;
+	priority = (MessagePriority) selected;
+	if (entry.barrier)
+		_barriers.pop_front();
+	_queues[selected].pop_front();
+
+	ClassStats & stats = _stats[selected];
+	++(stats.dispatched);
+	stats.total_delay += delay;
+	if (delay > stats.max_delay)
+		stats.max_delay = delay;
+
+	return true;
+}
+
+std::size_t MessageScheduler::size()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	std::size_t total = 0;
+	for (int i = 0; i < PRIORITY_CLASSES; ++i)
+		total += _queues[i].size();
+	return total;
+}
+
+unsigned MessageScheduler::getBatch()
+{
+	return _batch;
+}
+
+bool MessageScheduler::setDrainPending(bool pending)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	bool previous = _drain_pending;
+	_drain_pending = pending;
+	return previous;
+}
+
+void MessageScheduler::logStats()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (int i = 0; i < PRIORITY_CLASSES; ++i)
+	{
+		ClassStats & stats = _stats[i];
+		Poco::Timestamp::TimeDiff average = 0;
+		if (stats.dispatched > 0)
+			average = stats.total_delay / stats.dispatched;
+
+		app.logger().information(Poco::format("Queue delay class:%s dispatched:%lu rejected:%lu avg:%Ld us max:%Ld us queued:%z",
+								 getClassName((MessagePriority) i), stats.dispatched, stats.rejected,
+								 average, stats.max_delay, _queues[i].size()));
+	}
+	resetStats();
+}
+
+void MessageScheduler::resetStats()
+{
+	for (int i = 0; i < PRIORITY_CLASSES; ++i)
+	{
+		_stats[i].dispatched = 0;
+		_stats[i].rejected = 0;
+		_stats[i].total_delay = 0;
+		_stats[i].max_delay = 0;
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
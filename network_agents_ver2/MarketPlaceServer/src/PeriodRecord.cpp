@@ -0,0 +1,165 @@
+#include <map>
+#include <Poco/Util/Application.h>
+#include <Poco/Exception.h>
+
+#include "PeriodRecord.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+PeriodRecord::PeriodRecord(unsigned period, int executionCount, std::size_t insertChunk):
+_period(period),
+_execution_count(executionCount),
+_insert_chunk(insertChunk)
+{
+}
+
+PeriodRecord::~PeriodRecord()
+{
+}
+
+unsigned PeriodRecord::getPeriod()
+{
+	return _period;
+}
+
+const Poco::Timestamp & PeriodRecord::getCreated()
+{
+	return _created;
+}
+
+std::size_t PeriodRecord::size()
+{
+	return _bid_id.size() + _dv_bid_id.size() + _pur_bid_id.size();
+}
+
+void PeriodRecord::addBid(Bid * bidPtr)
+{
+	// It saves the information at the start of the following period.
+	BidStruct bidS = bidPtr->getDBBidStructure(_execution_count, (int) _period - 1);
+	_bid_period.push_back(bidS._period);
+	_bid_id.push_back(bidS._id);
+	_bid_provider.push_back(bidS._provider);
+	_bid_status.push_back(bidS._status);
+	_bid_pareto_status.push_back(bidS._paretoStatus);
+	_bid_dominated_count.push_back((int) bidS._dominatedCount);
+	_bid_execution_count.push_back(bidS._execution_count);
+	_bid_unitary_profit.push_back(bidS._unitary_profit);
+	_bid_unitary_cost.push_back(bidS._unitary_cost);
+	_bid_parent_id.push_back(bidS._parent_bid_id);
+	_bid_capacity.push_back(bidS._capacity);
+	_bid_init_capacity.push_back(bidS._init_capacity);
+	_bid_creation_period.push_back(bidS._creation_period);
+
+	std::map<std::string, double > decVars;
+	bidPtr->getDBDecisionVariables(&decVars);
+	std::map<std::string, double >::iterator itDes;
+	for (itDes = decVars.begin(); itDes != decVars.end() ; ++itDes)
+	{
+		_dv_bid_id.push_back(bidPtr->getId());
+		_dv_variable_id.push_back(itDes->first);
+		_dv_value.push_back(itDes->second);
+		_dv_execution_count.push_back(_execution_count);
+	}
+}
+
+void PeriodRecord::addPurchases(PurchaseInformation * purchases)
+{
+	std::vector<PurchaseServiceBidStruct> rows;
+	purchases->getDBPurchases(_execution_count, (int) _period - 1, rows);
+
+	std::vector<PurchaseServiceBidStruct>::iterator it;
+	for (it = rows.begin(); it != rows.end(); ++it)
+	{
+		_pur_period.push_back(it->_period);
+		_pur_service_id.push_back(it->_serviceId);
+		_pur_bid_id.push_back(it->_bidId);
+		_pur_quantity.push_back(it->_quantity);
+		_pur_quantity_backlog.push_back(it->_quantity_backlog);
+		_pur_execution_count.push_back(it->_execution_count);
+	}
+}
+
+void PeriodRecord::store(StorageBackend & storage)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Storing period:%d bids:%d purchases:%d",
+							 (int) _period, (int) _bid_id.size(), (int) _pur_bid_id.size()));
+
+	if (size() == 0)
+		return;
+
+	std::vector<BulkInsert *> inserts;
+	try
+	{
+		addBidInserts(inserts);
+		addPurchaseInserts(inserts);
+		storage.write(inserts);
+	}
+	catch (Poco::Exception &e)
+	{
+		for (std::size_t i = 0; i < inserts.size(); ++i)
+			delete inserts[i];
+		throw;
+	}
+	for (std::size_t i = 0; i < inserts.size(); ++i)
+		delete inserts[i];
+}
+
+void PeriodRecord::addBidInserts(std::vector<BulkInsert *> & inserts)
+{
+	if (_bid_id.size() == 0)
+		return;
+
+	BulkInsert * insertBids = new BulkInsert("simulation_bid",
+		"period, bidId, providerId, status, paretoStatus, dominatedCount, execution_count, unitary_profit, unitary_cost, parentBidId, capacity, init_capacity, creation_period",
+		_insert_chunk);
+	inserts.push_back(insertBids);
+	insertBids->column(_bid_period)
+			   .column(_bid_id)
+			   .column(_bid_provider)
+			   .column(_bid_status)
+			   .column(_bid_pareto_status)
+			   .column(_bid_dominated_count)
+			   .column(_bid_execution_count)
+			   .column(_bid_unitary_profit)
+			   .column(_bid_unitary_cost)
+			   .column(_bid_parent_id)
+			   .column(_bid_capacity)
+			   .column(_bid_init_capacity)
+			   .column(_bid_creation_period);
+
+	if (_dv_bid_id.size() == 0)
+		return;
+
+	BulkInsert * insertDecisionVariable = new BulkInsert("simulation_bid_decision_variable",
+		"parentId, decisionVariableName, value, execution_count", _insert_chunk);
+	inserts.push_back(insertDecisionVariable);
+	insertDecisionVariable->column(_dv_bid_id)
+						   .column(_dv_variable_id)
+						   .column(_dv_value)
+						   .column(_dv_execution_count);
+}
+
+void PeriodRecord::addPurchaseInserts(std::vector<BulkInsert *> & inserts)
+{
+	if (_pur_bid_id.size() == 0)
+		return;
+
+	BulkInsert * insert = new BulkInsert("simulation_bid_purchases",
+		"period, serviceId, bidId, quantity, qty_backlog, execution_count", _insert_chunk);
+	inserts.push_back(insert);
+	insert->column(_pur_period)
+		   .column(_pur_service_id)
+		   .column(_pur_bid_id)
+		   .column(_pur_quantity)
+		   .column(_pur_quantity_backlog)
+		   .column(_pur_execution_count);
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
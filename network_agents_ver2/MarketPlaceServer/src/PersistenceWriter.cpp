@@ -0,0 +1,181 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Exception.h>
+
+#include "PersistenceWriter.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+PersistenceWriter::PersistenceWriter(StorageBackend * storage, std::size_t capacity,
+									 PersistenceMode mode):
+_storage(storage),
+_capacity(capacity),
+_mode(mode),
+_stopped(true),
+_written(0),
+_dropped(0),
+_failed(0),
+_last_lag(0),
+_max_lag(0),
+_thread("PersistenceWriter")
+{
+	if (_capacity == 0)
+		_capacity = 1;
+}
+
+PersistenceWriter::~PersistenceWriter()
+{
+	stop();
+}
+
+void PersistenceWriter::start()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	if (_stopped)
+	{
+		_stopped = false;
+		_thread.start(*this);
+	}
+}
+
+void PersistenceWriter::stop()
+{
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+		if (_stopped)
+			return;
+		_stopped = true;
+		_not_empty.broadcast();
+		_not_full.broadcast();
+	}
+	_thread.join();
+
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().information(Poco::format("Persistence writer stopped written:%lu dropped:%lu failed:%lu max lag:%Ld us",
+							 _written, _dropped, _failed, _max_lag));
+}
+
+bool PersistenceWriter::enqueue(PeriodRecord * record)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	if (_mode == PERSISTENCE_BLOCK)
+	{
+		while ((_queue.size() >= _capacity) && (_stopped == false))
+			_not_full.wait(_mutex);
+	}
+
+	if ((_queue.size() >= _capacity) || _stopped)
+	{
+		++_dropped;
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		app.logger().warning(Poco::format("Persistence queue full, period %d dropped - dropped:%lu",
+							 (int) record->getPeriod(), _dropped));
+		delete record;
+		return false;
+	}
+
+	_queue.push_back(record);
+	_not_empty.signal();
+	return true;
+}
+
+std::size_t PersistenceWriter::queued()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _queue.size();
+}
+
+unsigned long PersistenceWriter::getWritten()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _written;
+}
+
+unsigned long PersistenceWriter::getDropped()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _dropped;
+}
+
+unsigned long PersistenceWriter::getFailed()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _failed;
+}
+
+Poco::Timestamp::TimeDiff PersistenceWriter::getLastLag()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _last_lag;
+}
+
+Poco::Timestamp::TimeDiff PersistenceWriter::getMaxLag()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	return _max_lag;
+}
+
+void PersistenceWriter::run()
+{
+	for (;;)
+	{
+		PeriodRecord * record = NULL;
+		{
+			Poco::Mutex::ScopedLock lock(_mutex);
+			while (_queue.empty() && (_stopped == false))
+				_not_empty.wait(_mutex);
+
+			// When stopping the queue is flushed before leaving.
+			if (_queue.empty())
+				break;
+
+			record = _queue.front();
+			_queue.pop_front();
+			_not_full.signal();
+		}
+		write(record);
+	}
+}
+
+void PersistenceWriter::write(PeriodRecord * record)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	bool ok = true;
+	try
+	{
+		record->store(*_storage);
+	}
+	catch (Poco::Exception &e)
+	{
+		ok = false;
+		app.logger().error(Poco::format("Period %d could not be stored: %s",
+							(int) record->getPeriod(), e.displayText()));
+	}
+
+	Poco::Timestamp::TimeDiff lag = record->getCreated().elapsed();
+	std::size_t pending;
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+		if (ok)
+			++_written;
+		else
+			++_failed;
+		_last_lag = lag;
+		if (lag > _max_lag)
+			_max_lag = lag;
+		pending = _queue.size();
+	}
+
+	app.logger().information(Poco::format("Period %d stored lag:%Ld us pending:%z",
+							 (int) record->getPeriod(), lag, pending));
+	delete record;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
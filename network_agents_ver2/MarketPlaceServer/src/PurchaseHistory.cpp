@@ -0,0 +1,208 @@
+#include <Poco/Util/Application.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <set>
+
+#include "PurchaseHistory.h"
+#include "SnapshotFile.h"
+#include "MarketPlaceException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+PurchaseHistory::PurchaseHistory():
+_retention(0),
+_spill_fd(-1),
+_spill_size(0)
+{
+}
+
+PurchaseHistory::~PurchaseHistory()
+{
+	std::deque<Entry>::iterator it;
+	for (it = _hot.begin(); it != _hot.end(); ++it)
+		delete it->second;
+	_hot.clear();
+
+	if (_spill_fd >= 0)
+	{
+		::close(_spill_fd);
+		::unlink(_spill_path.c_str());
+	}
+}
+
+void PurchaseHistory::setRetention(unsigned periods, const std::string & spillPath)
+{
+	_retention = periods;
+	if ((_retention > 0) && (_retention < 2))
+		_retention = 2;
+
+	if ((_retention > 0) && (spillPath.empty() == false))
+	{
+		// The segment only lives as long as the run.
+		_spill_fd = ::open(spillPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (_spill_fd < 0)
+			throw MarketPlaceException("Could not create the purchase history segment " + spillPath
+										+ ": " + strerror(errno), 347);
+		_spill_path = spillPath;
+		_spill_size = 0;
+	}
+	evict();
+}
+
+void PurchaseHistory::add(const std::string & key, PurchaseInformation * purchases)
+{
+	_hot.push_back(Entry(key, purchases));
+	evict();
+}
+
+void PurchaseHistory::evict(void)
+{
+	if (_retention == 0)
+		return;
+
+	while (_hot.size() > _retention)
+	{
+		Entry entry = _hot.front();
+		_hot.pop_front();
+
+		if (_spill_fd >= 0)
+		{
+			try
+			{
+				spill(entry);
+			}
+			catch (MarketPlaceException &e)
+			{
+				// The period was stored when it was closed, it is only lost
+				// for the lookups.
+				Poco::Util::Application& app = Poco::Util::Application::instance();
+				app.logger().error(e.message());
+			}
+		}
+		delete entry.second;
+	}
+}
+
+void PurchaseHistory::spill(const Entry & entry)
+{
+	std::vector<PurchaseServiceBidStruct> rows;
+	entry.second->getDBPurchases(0, 0, rows);
+
+	std::string data;
+	SnapshotWriter out(data);
+	out.putCount(rows.size());
+	for (std::size_t i = 0; i < rows.size(); ++i)
+	{
+		out.putString(rows[i]._serviceId);
+		out.putString(rows[i]._bidId);
+		out.putDouble(rows[i]._quantity);
+		out.putDouble(rows[i]._quantity_backlog);
+	}
+
+	const char * pos = data.data();
+	std::size_t left = data.size();
+	off_t offset = (off_t) _spill_size;
+	while (left > 0)
+	{
+		ssize_t written = ::pwrite(_spill_fd, pos, left, offset);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw MarketPlaceException("Could not write the purchase history segment " + _spill_path
+										+ ": " + strerror(errno), 347);
+		}
+		pos += written;
+		offset += written;
+		left -= (std::size_t) written;
+	}
+
+	Location location;
+	location.offset = _spill_size;
+	location.size = (Poco::UInt32) data.size();
+	if (_spilled.find(entry.first) == _spilled.end())
+		_spilled_order.push_back(entry.first);
+	_spilled[entry.first] = location;
+	_spill_size += data.size();
+}
+
+bool PurchaseHistory::getPurchases(const std::string & key, std::vector<PurchaseServiceBidStruct> & rows)
+{
+	std::deque<Entry>::reverse_iterator it;
+	for (it = _hot.rbegin(); it != _hot.rend(); ++it)
+	{
+		if (it->first == key)
+		{
+			it->second->getDBPurchases(0, 0, rows);
+			return true;
+		}
+	}
+
+	std::map<std::string, Location>::iterator it_spilled = _spilled.find(key);
+	if (it_spilled == _spilled.end())
+		return false;
+
+	std::string data(it_spilled->second.size, '\0');
+	std::size_t read = 0;
+	while (read < data.size())
+	{
+		ssize_t n = ::pread(_spill_fd, &data[read], data.size() - read,
+							(off_t) (it_spilled->second.offset + read));
+		if ((n < 0) && (errno == EINTR))
+			continue;
+		if (n <= 0)
+			throw MarketPlaceException("Could not read the purchase history segment " + _spill_path
+										+ ": " + strerror(errno), 347);
+		read += (std::size_t) n;
+	}
+
+	SnapshotReader in(data.data(), data.data() + data.size());
+	std::size_t count = in.getCount(24);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		PurchaseServiceBidStruct row;
+		row._period = 0;
+		row._execution_count = 0;
+		row._serviceId = in.getString();
+		row._bidId = in.getString();
+		row._quantity = in.getDouble();
+		row._quantity_backlog = in.getDouble();
+		rows.push_back(row);
+	}
+	return in.done();
+}
+
+void PurchaseHistory::getPeriods(std::vector<std::string> & keys)
+{
+	std::vector<std::string>::iterator it;
+	for (it = _spilled_order.begin(); it != _spilled_order.end(); ++it)
+		keys.push_back(*it);
+
+	std::set<std::string> listed(_spilled_order.begin(), _spilled_order.end());
+	std::deque<Entry>::iterator it_hot;
+	for (it_hot = _hot.begin(); it_hot != _hot.end(); ++it_hot)
+	{
+		if (listed.insert(it_hot->first).second)
+			keys.push_back(it_hot->first);
+	}
+}
+
+std::size_t PurchaseHistory::getHotPeriods(void)
+{
+	return _hot.size();
+}
+
+std::size_t PurchaseHistory::getSpilledPeriods(void)
+{
+	return _spilled.size();
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -25,6 +25,7 @@ public:
 	std::string getBestBids(std::string serviceIdParam, int fronts);
 	void getProviderBids(std::string providerId, std::map<std::string, std::vector<std::string> > &bids);
 	bool isBidActive(std::string serviceId, std::string providerId, std::string bidId);
+	void getActiveBids(std::string serviceId, std::vector<Bid *> &bids);
 
 private:
 
@@ -29,6 +29,8 @@ public:
 	void getBids(std::map<std::string, std::vector<std::string> > &bids_parameter);	
 	
 	bool isBidActive(std::string bidId);
+
+	void getActiveBids(std::vector<Bid *> &bids);
 	
 private:
     std::map<std::string, Bid *> _bids;
@@ -31,6 +31,7 @@ public:
 	void calculateNeighbors(Bid * bidPtr);
 	void getProviderBids(std::string providerId, std::map<std::string, std::vector<std::string> > &bids);
 	bool isBidActive(std::string providerId, std::string bidId);
+	void getActiveBids(std::vector<Bid *> &bids);
 	
 private:
     typedef std::vector<Datapoint *> Front;
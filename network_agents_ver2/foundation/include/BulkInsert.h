@@ -0,0 +1,127 @@
+#ifndef BulkInsert_INCLUDED
+#define BulkInsert_INCLUDED
+
+#include <Poco/Data/Session.h>
+#include <Poco/Data/Statement.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class BulkColumnVisitor
+/// Receives the columns of a BulkInsert with their type.
+{
+public:
+	virtual ~BulkColumnVisitor();
+
+	virtual void visit(const std::vector<int> & values) = 0;
+
+	virtual void visit(const std::vector<double> & values) = 0;
+
+	virtual void visit(const std::vector<std::string> & values) = 0;
+};
+
+class BulkInsert
+/// Inserts rows given column by column straight into their table, with
+/// multi-row INSERT statements of at most chunk rows each. The values are
+/// bound in place, so the column vectors must live until execute returns.
+/// The rows can also be given as text, for the backends storing files.
+{
+public:
+	enum
+	{
+		DEFAULT_CHUNK = 500,
+		MAX_PLACEHOLDERS = 65535	// Limit of a MySQL prepared statement.
+	};
+
+	BulkInsert(const std::string & table, const std::string & columns,
+			   std::size_t chunk);
+		/// The columns are given as in the INSERT statement, in the order
+		/// the column vectors are added. A chunk of 0 is the default one.
+
+	~BulkInsert();
+
+	template <class T>
+	BulkInsert & column(const std::vector<T> & values)
+		/// Throws a FoundationException when the column has not as many
+		/// rows as the first one.
+	{
+		if (_binders.empty())
+			_rows = values.size();
+		else if (values.size() != _rows)
+			throw FoundationException("Bulk insert into " + _table + " with columns of different sizes", 340);
+
+		_binders.push_back([&values](Poco::Data::Statement & statement, std::size_t row)
+		{
+			statement, Poco::Data::Keywords::useRef(values[row]);
+		});
+		_formatters.push_back([&values](std::string & out, std::size_t row)
+		{
+			appendValue(out, values[row]);
+		});
+		_columns_typed.push_back([&values](BulkColumnVisitor & visitor)
+		{
+			visitor.visit(values);
+		});
+		return *this;
+	}
+
+	std::size_t execute(Poco::Data::Session & session,
+						std::size_t maxPlaceholders = MAX_PLACEHOLDERS);
+		/// Returns the number of statements executed. The chunk is reduced
+		/// to keep every statement under maxPlaceholders values.
+
+	void getStatementRows(std::size_t maxPlaceholders, std::vector<std::size_t> & rows) const;
+		/// Rows of every statement execute runs, in order: full chunks and
+		/// the remainder.
+
+	void appendText(std::string & out) const;
+		/// One line per row, the values separated by tabs. The tabs, line
+		/// breaks and backslashes of the text values are escaped as \t, \n,
+		/// \r and \\.
+
+	void visitColumns(BulkColumnVisitor & visitor) const;
+		/// The columns in the order they were added.
+
+	const std::string & getTable() const;
+
+	const std::string & getColumns() const;
+
+	std::size_t size() const;
+		/// Number of rows.
+
+private:
+	typedef std::function<void(Poco::Data::Statement &, std::size_t)> Binder;
+	typedef std::function<void(std::string &, std::size_t)> Formatter;
+	typedef std::function<void(BulkColumnVisitor &)> TypedColumn;
+
+	std::string _table;
+	std::string _columns;
+	std::size_t _chunk;
+	std::size_t _rows;
+	std::vector<Binder> _binders;
+	std::vector<Formatter> _formatters;
+	std::vector<TypedColumn> _columns_typed;
+
+	std::string getText(std::size_t rows) const;
+
+	static void appendValue(std::string & out, int value);
+
+	static void appendValue(std::string & out, double value);
+
+	static void appendValue(std::string & out, const std::string & value);
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // BulkInsert_INCLUDED
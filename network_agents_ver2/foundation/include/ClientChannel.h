@@ -0,0 +1,110 @@
+#ifndef ClientChannel_INCLUDED
+#define ClientChannel_INCLUDED
+
+#include <Poco/Net/SocketNotification.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/RefCountedObject.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Timer.h>
+#include <functional>
+#include <string>
+#include <deque>
+
+#include "Message.h"
+#include "MessageFraming.h"
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ClientChannel: public Poco::RefCountedObject
+/// Connection to another server whose requests are answered in order. The
+/// socket is connected, written and read by a reactor, so no thread ever
+/// waits on it: requests are queued with the callback that takes their
+/// response, and the responses are framed and matched to the requests in
+/// the order they were sent. A request not answered in time fails alone:
+/// it keeps its place until its response comes, which is then dropped, so
+/// the connection and the requests behind it go on.
+{
+public:
+	typedef std::function<void(bool, Message &)> Callback;
+		/// Called by the reactor thread with true and the response, or with
+		/// false when the request failed.
+
+	ClientChannel(WaitingSocketReactor & reactor,
+				  const Poco::Net::SocketAddress & address,
+				  long timeout);
+		/// Timeout in milliseconds.
+
+	void open();
+		/// Starts connecting. Any thread.
+
+	void request(Message message, const Callback & callback);
+		/// Any thread.
+
+	void close();
+		/// The requests pending fail. Any thread. It stops the timer
+		/// checking the deadlines, so it is called before the channel is
+		/// released.
+
+	bool isOpen();
+		/// Reactor thread only.
+
+	void onSocketReadable(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf);
+
+	void onSocketWritable(const Poco::AutoPtr<Poco::Net::WritableNotification>& pNf);
+
+	void onSocketError(const Poco::AutoPtr<Poco::Net::ErrorNotification>& pNf);
+
+	void onTimer(Poco::Timer & timer);
+
+protected:
+	~ClientChannel();
+
+private:
+	enum
+	{
+		BUFFER_SIZE = 16384
+	};
+
+	struct Pending
+	{
+		Callback callback;
+		Poco::Timestamp deadline;
+		bool expired;			// Failed, waits for its response to drop it
+	};
+
+	WaitingSocketReactor & _reactor;
+	Poco::Net::SocketAddress _address;
+	Poco::Timestamp::TimeDiff _timeout;
+	Poco::Net::StreamSocket _socket;
+	Poco::Timer _timer;
+	bool _open;
+	bool _writing;
+	std::string _output;
+	MessageFraming _framing;
+	std::deque<Pending> _pending;
+
+	void doOpen();
+
+	void doRequest(const std::string & data, const Callback & callback);
+
+	void fail(const std::string & reason);
+		/// Closes the connection and fails the requests pending.
+
+	void expire();
+		/// Fails the requests whose deadline elapsed.
+
+	void setWriting(bool writing);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ClientChannel_INCLUDED
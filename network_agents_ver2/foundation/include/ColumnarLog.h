@@ -0,0 +1,91 @@
+#ifndef ColumnarLog_INCLUDED
+#define ColumnarLog_INCLUDED
+
+#include <Poco/Types.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BulkInsert.h"
+#include "StorageBackend.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ColumnarLog
+/// Append-only file of the rows of one table, kept by column. The file
+/// starts with the table, its columns and their types; every append adds a
+/// chunk with the number of rows, the strings not yet in the dictionary of
+/// the file and then every column as a fixed-width array: 32 bit integers,
+/// doubles, or 32 bit indexes in the dictionary for the strings. Every part
+/// is aligned to 8 bytes, so a reader can map the file and use the arrays
+/// in place. A chunk cut by a crash is dropped when the file is reopened.
+{
+public:
+	ColumnarLog(const std::string & path);
+
+	~ColumnarLog();
+
+	void append(const BulkInsert & insert);
+		/// Throws a FoundationException when the file holds another table
+		/// or cannot be written.
+
+	static std::size_t load(const std::string & path, StorageBackend & target,
+							std::size_t chunk);
+		/// Writes every chunk of the file to the target, one transaction per
+		/// chunk, with inserts of at most chunk rows. Returns the number of
+		/// rows written.
+
+private:
+	enum ColumnType
+	{
+		COLUMN_INT = 1,
+		COLUMN_DOUBLE = 2,
+		COLUMN_STRING = 3
+	};
+
+	struct Layout
+	{
+		std::string table;
+		std::string columns;
+		std::vector<char> types;
+		std::size_t first_chunk;
+	};
+
+	struct Chunk
+	{
+		Poco::UInt32 rows;
+		std::vector<std::string> strings;
+		std::vector<const char *> columns;
+	};
+
+	friend class ColumnEncoder;
+
+	std::string _path;
+	bool _opened;
+	bool _exists;
+	std::string _table;
+	std::string _columns;
+	std::vector<char> _types;
+	std::map<std::string, Poco::UInt32> _dictionary;
+
+	void open();
+
+	static std::string encodeLayout(const BulkInsert & insert, const std::vector<char> & types);
+
+	static bool decodeLayout(const char * begin, std::size_t size, Layout & layout);
+
+	static std::size_t decodeChunk(const char * begin, std::size_t size, std::size_t offset,
+								   const Layout & layout, Chunk & chunk);
+		/// Offset after the chunk, 0 when there is no complete chunk there.
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ColumnarLog_INCLUDED
@@ -0,0 +1,45 @@
+#ifndef ColumnarStorageBackend_INCLUDED
+#define ColumnarStorageBackend_INCLUDED
+
+#include <map>
+#include <string>
+
+#include "FileStorageBackend.h"
+#include "ColumnarLog.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ColumnarStorageBackend: public FileStorageBackend
+/// Results appended to one columnar result log per table and execution,
+/// <table>.<execution>.col in the directory, every stored period adding a
+/// chunk. The MarketPlaceServer option --load-results copies the logs into
+/// the tables of a database afterwards.
+{
+public:
+	ColumnarStorageBackend(const std::string & directory, const std::string & snapshot);
+
+	~ColumnarStorageBackend();
+
+	const std::string & getName() const;
+
+	void startExecution(int executionCount);
+
+	void write(const std::vector<BulkInsert *> & inserts);
+
+private:
+	int _execution_count;
+	std::map<std::string, ColumnarLog *> _logs;
+
+	void closeLogs();
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ColumnarStorageBackend_INCLUDED
@@ -0,0 +1,61 @@
+#ifndef ConfigurationLoader_INCLUDED
+#define ConfigurationLoader_INCLUDED
+
+#include <Poco/Data/SessionPool.h>
+#include <Poco/Data/Session.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ConfigurationRows.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ConfigurationLoader
+/// Reads the configuration tables of the simulation with one query per
+/// table, instead of one per row of the parent table. The tables do not
+/// depend on each other once read whole, so they are read in parallel,
+/// each with a session of its own from the pool; the objects are built
+/// from the rows afterwards by a single thread.
+{
+public:
+	ConfigurationLoader(Poco::Data::SessionPool & pool, unsigned threads);
+		/// At most the given number of tables are read at the same time.
+
+	~ConfigurationLoader();
+
+	void setCountUpdate(const std::string & statement);
+		/// Statement incrementing the execution count, for the databases
+		/// without the MySQL "update ... limit".
+
+	void load(bool countExecution, ConfigurationRows & rows);
+		/// With countExecution the execution count of the general
+		/// parameters is incremented first. Throws a FoundationException
+		/// when a table cannot be read.
+
+	void loadGeneralParameters(bool countExecution, GeneralParametersRow & row);
+		/// Only the general parameters, with the same count update.
+
+private:
+	typedef std::function<void(Poco::Data::Session &)> TableLoad;
+
+	Poco::Data::SessionPool & _pool;
+	unsigned _threads;
+	std::string _count_update;
+
+	void readGeneralParameters(Poco::Data::Session & session, bool countExecution,
+							   GeneralParametersRow & row);
+
+	void run(std::vector<TableLoad> & loads);
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ConfigurationLoader_INCLUDED
@@ -0,0 +1,123 @@
+#ifndef ConfigurationRows_INCLUDED
+#define ConfigurationRows_INCLUDED
+
+#include <string>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+/// Rows of the configuration tables of the simulation, as read from the
+/// database, before the objects are built from them.
+
+struct GeneralParametersRow
+{
+	int bid_periods;
+	int pareto_fronts_to_exchange;
+	int execution_count;
+};
+
+struct ResourceRow
+{
+	int id;
+	std::string name;
+};
+
+struct DistributionRow
+{
+	int id;
+	std::string name;
+	std::string domain;
+	std::string class_name;
+};
+
+struct DistributionPointRow
+{
+	int distribution_id;
+	double value;
+	double probability;
+};
+
+struct DistributionParameterRow
+{
+	int distribution_id;
+	std::string parameter;
+	double value;
+};
+
+struct CostFunctionRow
+{
+	int id;
+	std::string name;
+	std::string range;
+	std::string class_name;
+};
+
+struct CostParameterRow
+{
+	int cost_function_id;
+	std::string parameter;
+	double value;
+};
+
+struct DecisionVariableRow
+{
+	int id;
+	std::string name;
+	std::string optimization;
+	double min_value;
+	double max_value;
+	int resource_id;
+	std::string modeling;
+	int sensitivity_distribution_id;
+	int value_distribution_id;
+	int cost_function_id;
+};
+
+struct ServiceRow
+{
+	int id;
+	std::string name;
+	std::string file_name_demand;
+	std::string converter_origin;
+	std::string file_name_converter;
+};
+
+struct ServiceVariableRow
+{
+	int service_id;
+	int decision_variable_id;
+};
+
+struct TrafficRow
+{
+	int service_id;
+	double average;
+	double variance;
+};
+
+struct ConfigurationRows
+{
+	GeneralParametersRow general;
+	std::vector<ResourceRow> resources;
+	std::vector<DistributionRow> distributions;
+	std::vector<DistributionPointRow> distribution_points;
+	std::vector<DistributionParameterRow> distribution_parameters;
+	std::vector<CostFunctionRow> cost_functions;
+	std::vector<CostParameterRow> cost_parameters;
+	std::vector<DecisionVariableRow> decision_variables;
+	std::vector<ServiceRow> services;
+	std::vector<ServiceVariableRow> service_variables;
+	std::vector<TrafficRow> traffic;
+	std::vector<int> services_to_execute;
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ConfigurationRows_INCLUDED
@@ -0,0 +1,46 @@
+#ifndef ConfigurationSnapshot_INCLUDED
+#define ConfigurationSnapshot_INCLUDED
+
+#include <Poco/Types.h>
+#include <string>
+
+#include "ConfigurationRows.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class ConfigurationSnapshot
+/// Binary image of the configuration rows read from the database, so the
+/// servers can start without it. It is kept in a SnapshotFile, so a file
+/// of another version, truncated or whose rows do not match the checksum
+/// is not used.
+{
+public:
+	static void write(const std::string & path, const ConfigurationRows & rows);
+		/// Throws a FoundationException when it cannot be written.
+
+	static bool read(const std::string & path, ConfigurationRows & rows,
+					 std::string & reason);
+		/// False, with the reason, when the file is missing or not valid.
+
+private:
+	enum
+	{
+		VERSION = 1
+	};
+
+	static void encode(const ConfigurationRows & rows, std::string & payload);
+
+	static bool decode(const char * begin, const char * end, ConfigurationRows & rows);
+
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // ConfigurationSnapshot_INCLUDED
@@ -0,0 +1,77 @@
+#ifndef ConnectionChannel_INCLUDED
+#define ConnectionChannel_INCLUDED
+
+#include <Poco/RefCountedObject.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Mutex.h>
+#include <string>
+#include <map>
+
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ConnectionWriter
+/// Transport end of a connection channel.
+{
+public:
+	virtual ~ConnectionWriter() { }
+
+	virtual void writeResponse(const std::string & responseStr) = 0;
+		/// Reactor thread of the channel only.
+};
+
+class ConnectionChannel: public Poco::RefCountedObject
+/// Response path of a connection. Every request gets a sequence number
+/// when it is read, and its response is written to the connection only
+/// after the responses of all the previous requests, so the agent sees
+/// them in order even when they are produced by different threads.
+/// The channel outlives the connection while there is work in flight; once
+/// the connection is detached the remaining responses are discarded.
+{
+public:
+	ConnectionChannel(ConnectionWriter * connection, WaitingSocketReactor & reactor);
+
+	unsigned reserve();
+		/// Assigns the sequence number of the next request.
+
+	void complete(unsigned sequence, const std::string & response);
+		/// Registers the response for the given sequence.
+
+	void deliver(unsigned sequence, const std::string & response);
+		/// Registers the response and flushes it, in place when called by
+		/// the reactor thread of the connection, otherwise through a task
+		/// posted to it.
+
+	void flush();
+		/// Writes the responses that are in order. Reactor thread only.
+
+	void detach();
+		/// Called by the connection when it is destroyed.
+
+	bool isAttached();
+
+	WaitingSocketReactor & getReactor();
+		/// The reactor of the connection.
+
+protected:
+	~ConnectionChannel();
+
+private:
+	ConnectionWriter * _connection;
+	WaitingSocketReactor & _reactor;
+	Poco::FastMutex _mutex;
+	unsigned _next_sequence;
+	unsigned _next_to_write;
+	std::map<unsigned, std::string> _completed;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ConnectionChannel_INCLUDED
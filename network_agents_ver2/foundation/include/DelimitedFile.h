@@ -0,0 +1,97 @@
+#ifndef DelimitedFile_INCLUDED
+#define DelimitedFile_INCLUDED
+
+#include <Poco/SharedMemory.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class DelimitedFile
+/// Text file of lines of fields split by a separator, as the demand,
+/// traffic converter and probability files. The file is mapped in memory
+/// and split once; the fields are trimmed like a Poco::StringTokenizer
+/// with TOK_TRIM would, and point into the mapping. The first field of
+/// every line is indexed, so a line is found by key in constant time.
+{
+public:
+	DelimitedFile(char separator);
+
+	~DelimitedFile();
+
+	bool open(const std::string & path);
+		/// False when the file does not exist or cannot be mapped.
+
+	std::size_t size() const;
+		/// Number of lines.
+
+	std::size_t count(std::size_t line) const;
+		/// Number of fields of the line, 0 for an empty line.
+
+	bool hasCount(std::size_t fields) const;
+		/// True when every line has that number of fields. Checked when
+		/// the file is split, not line by line.
+
+	std::string get(std::size_t line, std::size_t field) const;
+
+	bool parseFloat(std::size_t line, std::size_t field, double & value) const;
+		/// False when the field is not a number.
+
+	bool parseUnsigned(std::size_t line, std::size_t field, unsigned & value) const;
+
+	bool find(const std::string & key, std::size_t & line) const;
+		/// First line whose first field is the key.
+
+	static Poco::SharedPtr<DelimitedFile> shared(const std::string & path, char separator);
+		/// The file read once for all the callers until clearShared, NULL
+		/// when it cannot be opened. Any thread.
+
+	static void clearShared();
+		/// Releases the files read through shared.
+
+	static bool parseFloat(const char * begin, const char * end, double & value);
+		/// Decimal numbers of up to 15 significant digits are converted
+		/// without strtod, exactly as it would; the others go through it.
+
+	static bool parseUnsigned(const char * begin, const char * end, unsigned & value);
+
+private:
+	struct Field
+	{
+		std::size_t offset;
+		std::size_t length;
+	};
+
+	char _separator;
+	Poco::SharedMemory _mapping;
+	const char * _data;
+	std::vector<Field> _fields;
+	std::vector<std::size_t> _lines;
+		/// Index of the first field of every line, plus the end.
+	std::size_t _min_count;
+	std::size_t _max_count;
+	std::unordered_map<std::string, std::size_t> _keys;
+
+	static Poco::FastMutex _shared_mutex;
+	static std::map<std::string, Poco::SharedPtr<DelimitedFile> > _shared_files;
+
+	void split(std::size_t length);
+
+	const Field * getField(std::size_t line, std::size_t field) const;
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // DelimitedFile_INCLUDED
@@ -0,0 +1,66 @@
+#ifndef DemandSeries_INCLUDED
+#define DemandSeries_INCLUDED
+
+#include <Poco/Types.h>
+#include <string>
+#include <vector>
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class DemandSeries
+/// Demand of the consecutive periods starting at 1, kept in a dense array.
+/// The periods after the last one repeat the series from the first. The
+/// text files can be cached in a binary file next to them, which is mapped
+/// instead of parsing the text while the file keeps its modification time
+/// and size.
+{
+public:
+	DemandSeries();
+
+	~DemandSeries();
+
+	void load(const std::string & path, bool cache);
+		/// Reads a file of "period : value" lines. Throws a
+		/// FoundationException when the file is missing or malformed.
+
+	double get(unsigned period) const;
+		/// Zero for the period 0 and for an empty series.
+
+	std::size_t size() const;
+
+	bool isFromCache() const;
+		/// The last load mapped the binary cache.
+
+	static std::string getCachePath(const std::string & path);
+
+private:
+	struct CacheHeader
+	{
+		char magic[8];
+		Poco::Int64 modified;
+		Poco::UInt64 source_size;
+		Poco::UInt64 count;
+	};
+
+	std::vector<double> _values;
+	bool _from_cache;
+
+	void parse(const std::string & path);
+
+	bool readCache(const std::string & path, Poco::Int64 modified,
+				   Poco::UInt64 source_size);
+
+	void writeCache(const std::string & path, Poco::Int64 modified,
+					Poco::UInt64 source_size);
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // DemandSeries_INCLUDED
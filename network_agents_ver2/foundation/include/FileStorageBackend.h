@@ -0,0 +1,49 @@
+#ifndef FileStorageBackend_INCLUDED
+#define FileStorageBackend_INCLUDED
+
+#include <Poco/Mutex.h>
+#include <string>
+
+#include "StorageBackend.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class FileStorageBackend: public StorageBackend
+/// Results appended to one text file per table in a directory, with a
+/// first line naming the columns, and the configuration read from a
+/// configuration snapshot. Nothing is ever read back from the result
+/// files, so no server is needed for a single node experiment.
+{
+public:
+	FileStorageBackend(const std::string & directory, const std::string & snapshot);
+		/// The directory is created when missing.
+
+	~FileStorageBackend();
+
+	const std::string & getName() const;
+
+	void readConfiguration(bool countExecution, unsigned threads,
+						   ConfigurationRows & rows);
+
+	int readExecutionCount(bool countExecution, int configured);
+		/// Kept in the file execution_count of the directory, never below
+		/// the one configured.
+
+	void write(const std::vector<BulkInsert *> & inserts);
+
+protected:
+	std::string _directory;
+	std::string _snapshot;
+	Poco::FastMutex _mutex;
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // FileStorageBackend_INCLUDED
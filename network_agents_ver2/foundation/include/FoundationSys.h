@@ -13,6 +13,8 @@
 #include "CostFunction.h"
 #include "Resource.h"
 #include "ModuleLoader.h"
+#include "ConfigurationRows.h"
+#include "StorageBackend.h"
 
 
 
@@ -55,6 +57,11 @@ public:
     void readServiceDecisionVariablesFromDataBase(int serviceId, Service * service);
     void readServicesFromDataBase(void);
     void readServiceToExecute(void);
+
+    void applyConfiguration(const ConfigurationRows & rows);
+    	/// Builds the resources, distributions, cost functions, decision
+    	/// variables and services from the rows of their tables, in the
+    	/// order the readers above build them.
     
     void insertProbabilityDistribution(ProbabilityDistribution * probability_distribution);
     void insertCostFunction(CostFunction * cost_function);
@@ -66,10 +73,16 @@ public:
     ProbabilityDistribution * getProbabilityDistribution(std::string id);
     CostFunction * getCostFunction(std::string id);
     Service * getService(std::string serviceId);
+    void getForecasts(int period, std::vector<double> & forecasts);
+    	/// Forecast of every service to execute for the period, in the order
+    	/// of the services to execute.
     DecisionVariable * getDecisionVariable(std::string decisionVariableId);
     Resource * getResource(std::string resourceId);
     SimplestTrafficConverter * loadTrafficConverter(std::string serviceId);
     
+    StorageBackend * getStorage();
+    	/// Where the results are stored, set by initialize.
+
     AgentType getType();
 
     int getExecutionCount();
@@ -99,9 +112,18 @@ protected:
     ResourceContainer _resources;
     
     std::vector<std::string> _services_to_execute;
+    std::vector<Service *> _services_to_execute_ptr;
+
+	StorageBackend * _storage;
 
+	// Pool of the storage backend, NULL when it is not a database.
 	Poco::Data::SessionPool * _pool;
 
+    void createModuleLoader(Poco::Util::Application &app);
+
+    void loadConfiguration(Poco::Util::Application &app, const ConfigurationRows & rows,
+    					   int bid_periods, int pareto_fronts);
+
     //! associated module loader 
     //! these are the algorithms to create bids for the user.
     ModuleLoader *_loader;
@@ -52,8 +52,6 @@ public:
 	ChoiceNet::Eco::ListenerType getType();
 	std::string getTypeStr();
 	std::string getId();
-	void addStreamStagedForProcessing(Poco::FIFOBuffer & fifoIn, int len);
-	bool getMessage(Message & messsage);
 	
 
 private:
@@ -62,7 +60,6 @@ private:
 	ListenerStatus _status;
 	ListenerType _type;
 	Poco::Net::StreamSocket * _socket;
-	std::string _waitingProcessing;
 	Poco::UInt16 _listeneningPort;
 
 };
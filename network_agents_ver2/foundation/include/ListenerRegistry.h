@@ -0,0 +1,83 @@
+#ifndef ListenerRegistry_INCLUDED
+#define ListenerRegistry_INCLUDED
+
+#include <Poco/Net/SocketAddress.h>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+#include "Listener.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ListenerRegistry
+/// Listeners of a server indexed by socket address and by id through
+/// hash tables, and by type through intrusive lists. Registering, finding
+/// and removing a listener take constant time. The registry owns the
+/// listeners registered; it does no locking.
+{
+public:
+	ListenerRegistry();
+
+	~ListenerRegistry();
+		/// Disconnects and deletes the listeners still registered.
+
+	Listener * add(const std::string & id, Poco::Net::SocketAddress socketAddress);
+		/// Returns NULL when the id or the address is already registered.
+
+	Listener * find(const Poco::Net::SocketAddress & socketAddress);
+
+	Listener * find(const std::string & id);
+
+	void setType(Listener * listener, const std::string & type);
+		/// Sets the listener type and moves it to the list of that type.
+
+	Listener * remove(const Poco::Net::SocketAddress & socketAddress);
+		/// Unregisters the listener and gives its ownership back to the
+		/// caller. Returns NULL when the address is not registered.
+
+	std::size_t size();
+
+	void getListeners(std::vector<Listener *> & listeners);
+		/// All the listeners, in registration order.
+
+	void getListeners(const std::string & type, std::vector<Listener *> & listeners);
+		/// The listeners of the type, in the order they took it.
+
+private:
+	struct Entry
+	{
+		Listener * listener;
+		std::string address;
+		std::string type;
+		Entry * prev;
+		Entry * next;
+		Entry * type_prev;
+		Entry * type_next;
+	};
+
+	struct EntryList
+	{
+		Entry * head;
+		Entry * tail;
+	};
+
+	std::unordered_map<std::string, Entry *> _by_address;
+	std::unordered_map<std::string, Entry *> _by_id;
+	std::unordered_map<std::string, EntryList> _by_type;
+	EntryList _all;
+
+	static std::string getAddressKey(const Poco::Net::SocketAddress & socketAddress);
+
+	void unlinkType(Entry * entry);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ListenerRegistry_INCLUDED
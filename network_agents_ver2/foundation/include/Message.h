@@ -1,6 +1,7 @@
 #ifndef Message_INCLUDED
 #define Message_INCLUDED
 
+#include <Poco/Types.h>
 #include <string>
 #include <map>
 
@@ -34,6 +35,8 @@ enum Method
   get_unitary_cost = 18,
   activate_presenter=19,
   get_availability=20,
+  period_done=21,
+  snapshot=22,
 };
 
 
@@ -73,6 +76,15 @@ public:
 
 	bool isComplete(size_t lenght);
 
+	void setVirtualTime(Poco::UInt64 time);
+		/// Simulated time, in milliseconds, the message was sent at by a
+		/// clock running in virtual time.
+
+	bool hasVirtualTime();
+
+	Poco::UInt64 getVirtualTime();
+		/// Zero when the message carries no virtual time.
+
 private:
 	Method _method;
 	std::map<std::string, std::string> _parameters;
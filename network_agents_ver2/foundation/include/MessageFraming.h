@@ -0,0 +1,45 @@
+#ifndef MessageFraming_INCLUDED
+#define MessageFraming_INCLUDED
+
+#include <Poco/FIFOBuffer.h>
+#include <string>
+
+#include "Message.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class MessageFraming
+/// Splits the bytes read from a connection into messages. A message starts
+/// with its Method parameter and ends where the next one starts, or when
+/// the bytes staged reach the Message_Size it declares.
+{
+public:
+	MessageFraming();
+
+	~MessageFraming();
+
+	void append(const char * data, std::size_t length);
+
+	void append(Poco::FIFOBuffer & fifoIn);
+		/// Stages everything used in the FIFO and drains it.
+
+	bool next(Message & message);
+		/// Takes the next complete message, false when there is none. Data
+		/// not starting with a method gives a message with undefined method.
+
+	std::size_t size();
+		/// Bytes staged waiting for the rest of their message.
+
+private:
+	std::string _staged;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // MessageFraming_INCLUDED
@@ -0,0 +1,124 @@
+#ifndef NetworkServer_INCLUDED
+#define NetworkServer_INCLUDED
+
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketNotification.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/IPAddress.h>
+#include <Poco/Thread.h>
+#include <Poco/Mutex.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Types.h>
+#include <string>
+#include <vector>
+
+#include "Message.h"
+#include "ConnectionChannel.h"
+#include "ServerDispatcher.h"
+#include "ServerMetrics.h"
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class SharedMemoryServer;
+
+class NetworkServer
+/// Acceptor, reactor threads and metrics shared by the servers. The first
+/// reactor accepts the connections and dispatches every request. With more
+/// than one reactor the connections are spread over the others, which
+/// read, frame and write them, so the method handlers of the dispatcher
+/// still run on a single thread.
+{
+public:
+	struct Request
+	{
+		unsigned sequence;
+		Message message;
+	};
+
+	NetworkServer(const std::string & name, ServerDispatcher & dispatcher,
+				  unsigned reactors);
+
+	~NetworkServer();
+
+	void listenLocal(const std::string & path);
+		/// Also accepts the connections of the agents running on the same
+		/// host through a Unix domain socket bound to the path. Called
+		/// before start.
+
+	void listenSharedMemory(const std::string & name, unsigned slots,
+							std::size_t ringSize);
+		/// Also serves the agents attached to a shared memory segment with
+		/// the given number of slots. Called before start.
+
+	void start(Poco::UInt16 port);
+		/// Listens on the port and starts the reactor threads.
+
+	void stop();
+		/// Stops the reactors and waits for their threads.
+
+	void onAccept(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf);
+
+	void onAcceptLocal(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf);
+
+	void received(Poco::AutoPtr<ConnectionChannel> channel,
+				  Poco::Net::SocketAddress socketAddress,
+				  std::vector<Request> & requests);
+		/// Thread reading the connection. Hands the requests read to the
+		/// dispatch reactor.
+
+	void closed(Poco::Net::SocketAddress socketAddress);
+		/// Thread of the connection.
+
+	Poco::Net::SocketAddress assignLocalAddress();
+		/// The peers of a Unix domain socket or a shared memory slot have no
+		/// address of their own. They are given a local address named after
+		/// the server and a counter, never reused and never equal to the
+		/// address of a TCP client, which keys them as listeners. Any thread.
+
+	static bool isLocalPeer(const Poco::Net::SocketAddress & socketAddress);
+
+	static Poco::Net::IPAddress getCallbackHost(const Poco::Net::SocketAddress & socketAddress);
+		/// Host the peer is called back on: the loopback interface for a
+		/// local peer, the host it connected from otherwise.
+
+	WaitingSocketReactor & getDispatchReactor();
+
+	ServerMetrics & getMetrics();
+
+	void logStats();
+
+private:
+	std::string _name;
+	ServerDispatcher & _dispatcher;
+	ServerMetrics _metrics;
+	Poco::Net::ServerSocket _socket;
+	Poco::Net::ServerSocket _localSocket;
+	std::string _localPath;
+	Poco::FastMutex _local_mutex;
+	Poco::UInt64 _next_local;
+	SharedMemoryServer * _shared;
+	std::vector<WaitingSocketReactor *> _reactors;
+	std::vector<Poco::Thread *> _threads;
+	unsigned _next_reactor;
+	bool _started;
+
+	void attach(Poco::Net::StreamSocket & socket,
+				Poco::Net::SocketAddress socketAddress);
+
+	void dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+				  Poco::Net::SocketAddress socketAddress,
+				  std::vector<Request> & requests);
+
+	void disconnect(Poco::Net::SocketAddress socketAddress);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // NetworkServer_INCLUDED
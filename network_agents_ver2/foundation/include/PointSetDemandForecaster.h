@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include "DemandForecaster.h"
+#include "DemandSeries.h"
 
 namespace ChoiceNet
 {
@@ -17,14 +18,17 @@ class PointSetDemandForecaster: public DemandForecaster
 public:
 
     PointSetDemandForecaster(std::map<std::string, std::string> parameters );
+    	/// Parameters location and file_name of the demand file, and cache
+    	/// ("true") to go through its binary cache.
     
     ~PointSetDemandForecaster();
 
 	double getForecast(unsigned period);
 	
+	const DemandSeries & getSeries();
 	
 private:    
-    std::map <unsigned, double> _forecast;
+    DemandSeries _forecast;
     
 };
 
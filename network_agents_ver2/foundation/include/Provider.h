@@ -2,6 +2,8 @@
 #define Provider_INCLUDED
 
 #include <string>
+#include <vector>
+#include <map>
 #include "Resource.h"
 #include "ResourceAvailability.h"
 #include "Purchase.h"
@@ -54,6 +56,18 @@ public:
 
 	double getResourceAvailability(unsigned period, std::string resourceId);
 
+	void setResourceAvailability(unsigned period, std::string resourceId, double quantity);
+	/// Sets the units of a resource left in a period. Resources the provider
+	/// does not control are ignored.
+
+	void getResources(std::vector<std::string> & resourceIds);
+	/// Gets the resources controlled by the provider.
+
+	void getAvailabilities(std::string resourceId, double & initial,
+						   std::map<unsigned, double> & periods);
+	/// Gets the initial availability of a resource and the units left in
+	/// the periods with a deduction.
+
 	ProviderCapacityType getCapacityType(void);
 
 	std::string getId();
@@ -28,6 +28,14 @@ public:
     // Store purchases in the database pool.
     void toDatabase(Poco::Data::SessionPool * _pool, int execution_count, int period);
 
+    // Get the rows of every service, without touching the database.
+    void getDBPurchases(int execution_count, int period,
+						std::vector<PurchaseServiceBidStruct> & rows);
+
+    // Set the quantities purchased of a bid, as restored from a checkpoint.
+    void setPurchaseQuantities(std::string serviceId, std::string bidId,
+							   double quantity, double quantityBacklog);
+
 private:
 
 	typedef std::map<std::string, PurchaseServiceInformation *> PurchaseServiceInformationContainer;
@@ -58,6 +58,13 @@ public:
     // Store purchases for the service in the database pool.
     void toDatabase(Poco::Data::SessionPool * _pool, int execution_count, int period, std::string serviceId);
 
+    // Get the rows that toDatabase stores, without touching the database.
+    void getDBPurchases(int execution_count, int period, std::string serviceId,
+						std::vector<PurchaseServiceBidStruct> & rows);
+
+    // Set the quantities purchased of a bid, as restored from a checkpoint.
+    void setQuantities(std::string bidId, double quantity, double quantityBacklog);
+
 	typedef Poco::Tuple<int,std::string,std::string,double,double,int> DBPurchaseStructType;
 
 private:
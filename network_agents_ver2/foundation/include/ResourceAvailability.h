@@ -31,6 +31,15 @@ public:
 	double getAvailability(unsigned period);
 	/// Gets the availability for a specified period.
 
+	double getInitialAvailability(void);
+	/// Gets the availability of the periods without a deduction.
+
+	void getAvailabilities(std::map<unsigned, double> & periods);
+	/// Gets the units left in every period with a deduction.
+
+	void setAvailability(unsigned period, double quantity);
+	/// Sets the units left in a period, as restored by a recovery.
+
 	double deductAvailability(unsigned period, DecisionVariable *variable,
 							  double level, double quantity);
 	/// returns the number of units deducted from the availability.
@@ -0,0 +1,74 @@
+#ifndef ServerConnection_INCLUDED
+#define ServerConnection_INCLUDED
+
+#include <Poco/Net/SocketNotification.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/NObserver.h>
+#include <Poco/FIFOBuffer.h>
+#include <Poco/AutoPtr.h>
+#include <string>
+
+#include "ConnectionChannel.h"
+#include "MessageFraming.h"
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class NetworkServer;
+
+class ServerConnection: public ConnectionWriter
+/// I/O handler of a connection accepted by a network server. It reads the
+/// requests on the reactor thread given to the connection, frames them and
+/// hands them to the server in order; the responses come back through its
+/// channel. To alleviate spurious socket writability callback triggering
+/// when no data to be sent is available, the output goes through a FIFO
+/// buffer whose readable notification enables and disables the writable
+/// notification of the reactor.
+{
+public:
+	ServerConnection(Poco::Net::StreamSocket & socket,
+					 Poco::Net::SocketAddress socketAddress,
+					 WaitingSocketReactor & reactor,
+					 NetworkServer & server);
+
+	~ServerConnection();
+
+	void onFIFOOutReadable(bool& b);
+
+	void onSocketReadable(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf);
+
+	void onSocketWritable(const Poco::AutoPtr<Poco::Net::WritableNotification>& pNf);
+
+	void onSocketShutdown(const Poco::AutoPtr<Poco::Net::ShutdownNotification>& pNf);
+
+	void onSocketError(const Poco::AutoPtr<Poco::Net::ErrorNotification>& pNf);
+
+	void writeResponse(const std::string & responseStr);
+		/// Puts the response in the output FIFO. Reactor thread only.
+
+private:
+	enum
+	{
+		BUFFER_SIZE = 16384
+	};
+
+	Poco::Net::StreamSocket _socket;
+	WaitingSocketReactor & _reactor;
+	NetworkServer & _server;
+	Poco::Net::SocketAddress _address;
+	Poco::FIFOBuffer _fifoIn;
+	Poco::FIFOBuffer _fifoOut;
+	MessageFraming _framing;
+	Poco::AutoPtr<ConnectionChannel> _channel;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ServerConnection_INCLUDED
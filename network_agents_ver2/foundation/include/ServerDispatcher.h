@@ -0,0 +1,68 @@
+#ifndef ServerDispatcher_INCLUDED
+#define ServerDispatcher_INCLUDED
+
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/AutoPtr.h>
+#include <functional>
+#include <vector>
+
+#include "Message.h"
+#include "ConnectionChannel.h"
+#include "WaitingSocketReactor.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ServerDispatcher
+/// Pluggable part of a server: the handlers of the methods it answers and
+/// how their requests are routed. Every request is dispatched by the
+/// dispatch reactor thread of the network server; by default it is
+/// executed there and its response delivered to the connection.
+{
+public:
+	typedef std::function<void(Poco::Net::SocketAddress,
+							   Message &, Message &)> MethodHandler;
+
+	ServerDispatcher();
+
+	virtual ~ServerDispatcher();
+
+	void addMethod(Method method, const MethodHandler & handler);
+
+	void execute(Poco::Net::SocketAddress socketAddress,
+				 Message & message, Message & messageResponse);
+		/// Runs the handler of the method and turns its exceptions into
+		/// the status of the response. Any thread.
+
+	virtual void dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+						  unsigned sequence,
+						  Poco::Net::SocketAddress socketAddress,
+						  Message & message);
+		/// The sequence number was reserved when the request was read.
+
+	virtual void onReadBatch();
+		/// Called after the requests of a read were dispatched.
+
+	virtual void onDisconnect(Poco::Net::SocketAddress socketAddress);
+		/// Called when a connection is closed.
+
+	void setReactor(WaitingSocketReactor * reactor);
+
+	WaitingSocketReactor & getReactor();
+		/// The dispatch reactor.
+
+	static void errorProcedure(Message & messageResponse);
+
+private:
+	std::vector<MethodHandler> _methods;
+	WaitingSocketReactor * _reactor;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ServerDispatcher_INCLUDED
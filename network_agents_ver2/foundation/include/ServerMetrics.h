@@ -0,0 +1,57 @@
+#ifndef ServerMetrics_INCLUDED
+#define ServerMetrics_INCLUDED
+
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Types.h>
+#include <string>
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class ServerMetrics
+/// Counters of the I/O stack of a server, updated by the reactor threads.
+{
+public:
+	ServerMetrics();
+
+	~ServerMetrics();
+
+	void connectionOpened();
+
+	void connectionClosed();
+
+	void bytesRead(std::size_t bytes);
+
+	void requestRead();
+
+	void responseQueued();
+
+	void bytesWritten(std::size_t bytes);
+
+	void logStats(const std::string & name);
+		/// Logs the counters since the last call and resets them, except
+		/// the number of open connections.
+
+private:
+	Poco::FastMutex _mutex;
+	Poco::Timestamp _since;
+	unsigned long _open;
+	unsigned long _accepted;
+	unsigned long _closed;
+	unsigned long _requests;
+	unsigned long _responses;
+	Poco::UInt64 _bytes_read;
+	Poco::UInt64 _bytes_written;
+
+	void resetStats();
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // ServerMetrics_INCLUDED
@@ -0,0 +1,52 @@
+#ifndef SharedMemoryClient_INCLUDED
+#define SharedMemoryClient_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "Message.h"
+#include "MessageFraming.h"
+#include "SharedMemorySegment.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class SharedMemoryClient
+/// Agent end of the shared memory transport, for the C++ agents and load
+/// generators running on the host of a server. It speaks the protocol of
+/// the sockets over the slot it attaches to.
+{
+public:
+	SharedMemoryClient(const std::string & name);
+		/// Attaches to a free slot of the segment of the server.
+
+	~SharedMemoryClient();
+		/// Detaches from the slot.
+
+	void send(const std::string & request);
+		/// Waits while the ring of the requests is full.
+
+	bool receive(Message & message, long milliseconds);
+		/// Takes the next response, false when none arrives in time.
+
+private:
+	enum
+	{
+		FULL_WAIT = 1,
+		BUFFER_SIZE = 16384
+	};
+
+	SharedMemorySegment _segment;
+	unsigned _slot;
+	MessageFraming _framing;
+	std::vector<char> _buffer;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // SharedMemoryClient_INCLUDED
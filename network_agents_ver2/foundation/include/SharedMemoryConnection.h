@@ -0,0 +1,69 @@
+#ifndef SharedMemoryConnection_INCLUDED
+#define SharedMemoryConnection_INCLUDED
+
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+#include <string>
+#include <vector>
+
+#include "ConnectionChannel.h"
+#include "MessageFraming.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class NetworkServer;
+class SharedMemoryServer;
+
+class SharedMemoryConnection: public ConnectionWriter
+/// Connection of an agent attached to a slot of the shared memory segment.
+/// The transport thread reads and frames its requests and copies its
+/// responses to the slot; the responses are written by the dispatch
+/// reactor, which is the reactor of its channel, and the connection is
+/// destroyed there too.
+{
+public:
+	SharedMemoryConnection(SharedMemoryServer & transport,
+						   unsigned slot,
+						   Poco::UInt32 session,
+						   Poco::Net::SocketAddress socketAddress,
+						   NetworkServer & server);
+
+	~SharedMemoryConnection();
+
+	bool pump();
+		/// Transport thread only. Moves the requests and responses waiting
+		/// in the slot, returns false when there were none.
+
+	void writeResponse(const std::string & responseStr);
+
+	Poco::UInt32 getSession();
+
+private:
+	enum
+	{
+		BUFFER_SIZE = 16384
+	};
+
+	SharedMemoryServer & _transport;
+	unsigned _slot;
+	Poco::UInt32 _session;
+	Poco::Net::SocketAddress _address;
+	NetworkServer & _server;
+	MessageFraming _framing;
+	Poco::AutoPtr<ConnectionChannel> _channel;
+	std::vector<char> _buffer;
+	Poco::FastMutex _output_mutex;
+	std::string _output;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // SharedMemoryConnection_INCLUDED
@@ -0,0 +1,63 @@
+#ifndef SharedMemoryRing_INCLUDED
+#define SharedMemoryRing_INCLUDED
+
+#include <Poco/Types.h>
+#include <atomic>
+#include <cstddef>
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class SharedMemoryRing
+/// Single producer, single consumer byte ring laid over memory that can be
+/// shared by two processes. The positions are free running counters, the
+/// producer only moves the head and the consumer only moves the tail, so
+/// neither side takes a lock nor enters the kernel to pass data.
+{
+public:
+	struct Control
+	{
+		std::atomic<Poco::UInt64> head;
+		char head_pad[56];
+		std::atomic<Poco::UInt64> tail;
+		char tail_pad[56];
+	};
+
+	SharedMemoryRing(char * memory, std::size_t capacity);
+		/// The memory holds the control block followed by capacity bytes;
+		/// the capacity is a power of two.
+
+	~SharedMemoryRing();
+
+	static std::size_t footprint(std::size_t capacity);
+		/// Bytes of memory taken by a ring of the given capacity.
+
+	void reset();
+		/// Empties the ring. Neither side may be using it.
+
+	std::size_t write(const char * data, std::size_t length);
+		/// Producer only. Copies what fits, returns the bytes copied.
+
+	std::size_t read(char * data, std::size_t length);
+		/// Consumer only. Returns the bytes copied, 0 when empty.
+
+	std::size_t readable();
+
+	std::size_t writable();
+
+	std::size_t capacity();
+
+private:
+	Control * _control;
+	char * _data;
+	std::size_t _capacity;
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // SharedMemoryRing_INCLUDED
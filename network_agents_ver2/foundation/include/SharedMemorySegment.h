@@ -0,0 +1,105 @@
+#ifndef SharedMemorySegment_INCLUDED
+#define SharedMemorySegment_INCLUDED
+
+#include <Poco/SharedMemory.h>
+#include <Poco/Types.h>
+#include <atomic>
+#include <string>
+
+#include "SharedMemoryRing.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class SharedMemorySegment
+/// Layout of the memory mapped segment shared by a server and the agents
+/// running on its host: a header followed by one slot per agent, each
+/// holding the ring of the requests of the agent and the ring of its
+/// responses. A side waiting for data sleeps on a futex of the segment, so
+/// the other side only enters the kernel when it is asleep.
+{
+public:
+	enum SlotState
+	{
+		SLOT_FREE = 0,
+		SLOT_ATTACHING,
+		SLOT_ATTACHED,
+		SLOT_CLOSED
+	};
+
+	struct Header
+	{
+		Poco::UInt32 magic;
+		Poco::UInt32 slots;
+		Poco::UInt64 ring_size;
+		std::atomic<Poco::UInt32> doorbell;
+			/// Rung when there are requests to read or responses to write.
+		std::atomic<Poco::UInt32> sleeping;
+		char pad[40];
+	};
+
+	struct Slot
+	{
+		std::atomic<Poco::UInt32> state;
+		std::atomic<Poco::UInt32> session;
+			/// Changes every time an agent attaches to the slot.
+		std::atomic<Poco::UInt32> doorbell;
+			/// Rung when there are responses for the agent.
+		std::atomic<Poco::UInt32> sleeping;
+		std::atomic<Poco::Int32> pid;
+		char pad[44];
+	};
+
+	SharedMemorySegment(const std::string & name, unsigned slots, std::size_t ringSize);
+		/// Creates the segment, it is removed when the object is destroyed.
+
+	SharedMemorySegment(const std::string & name);
+		/// Opens the segment created by a server.
+
+	~SharedMemorySegment();
+
+	Header & header();
+
+	unsigned slots();
+
+	Slot & slot(unsigned index);
+
+	SharedMemoryRing requests(unsigned index);
+
+	SharedMemoryRing responses(unsigned index);
+
+	static void ring(std::atomic<Poco::UInt32> & doorbell,
+					 std::atomic<Poco::UInt32> & sleeping);
+		/// Signals the change and wakes the other side if it sleeps.
+
+	static void wait(std::atomic<Poco::UInt32> & doorbell,
+					 std::atomic<Poco::UInt32> & sleeping,
+					 Poco::UInt32 seen, long milliseconds);
+		/// Sleeps until the doorbell moves from the value seen, at most the
+		/// given milliseconds.
+
+private:
+	enum
+	{
+		MAGIC = 0x45434f53,
+		MIN_RING_SIZE = 4096
+	};
+
+	Poco::SharedMemory * _memory;
+	char * _base;
+	unsigned _slots;
+	std::size_t _ring_size;
+
+	static std::size_t slotSize(std::size_t ringSize);
+
+	char * slotBase(unsigned index);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // SharedMemorySegment_INCLUDED
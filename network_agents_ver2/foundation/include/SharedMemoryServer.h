@@ -0,0 +1,72 @@
+#ifndef SharedMemoryServer_INCLUDED
+#define SharedMemoryServer_INCLUDED
+
+#include <Poco/Runnable.h>
+#include <Poco/Thread.h>
+#include <Poco/Types.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "SharedMemorySegment.h"
+#include "SharedMemoryConnection.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+class NetworkServer;
+
+class SharedMemoryServer: public Poco::Runnable
+/// Shared memory transport of a network server. It creates the segment,
+/// and one thread watches its slots: it opens a connection when an agent
+/// attaches, moves the requests and the responses of the attached agents,
+/// and closes the connection when the agent detaches or its process is
+/// gone. The requests are dispatched like those of the sockets.
+{
+public:
+	SharedMemoryServer(NetworkServer & server, const std::string & name,
+					   unsigned slots, std::size_t ringSize);
+
+	~SharedMemoryServer();
+
+	void start();
+
+	void stop();
+		/// Joins the thread and closes the connections. Called once the
+		/// reactors are stopped.
+
+	void run();
+
+	void wakeUp();
+		/// Any thread. There are responses to write.
+
+	SharedMemorySegment & getSegment();
+
+private:
+	enum
+	{
+		IDLE_WAIT = 100
+	};
+
+	NetworkServer & _server;
+	std::string _name;
+	SharedMemorySegment _segment;
+	std::vector<SharedMemoryConnection *> _connections;
+	Poco::Thread _thread;
+	std::atomic<bool> _stop;
+
+	void open(unsigned index);
+
+	void close(unsigned index);
+
+	bool isAlive(unsigned index);
+};
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif // SharedMemoryServer_INCLUDED
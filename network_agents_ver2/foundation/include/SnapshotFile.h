@@ -0,0 +1,164 @@
+#ifndef SnapshotFile_INCLUDED
+#define SnapshotFile_INCLUDED
+
+#include <Poco/Types.h>
+#include <cstring>
+#include <string>
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class SnapshotWriter
+/// Appends the values in the byte order of the host; the snapshots are
+/// only read on the hosts running the simulation.
+{
+public:
+	SnapshotWriter(std::string & out):
+	_out(out)
+	{
+	}
+
+	void putInt(int value)
+	{
+		Poco::Int32 v = value;
+		_out.append((const char *) &v, sizeof(v));
+	}
+
+	void putDouble(double value)
+	{
+		_out.append((const char *) &value, sizeof(value));
+	}
+
+	void putString(const std::string & value)
+	{
+		putCount(value.size());
+		_out.append(value);
+	}
+
+	void putCount(std::size_t count)
+	{
+		Poco::UInt32 v = (Poco::UInt32) count;
+		_out.append((const char *) &v, sizeof(v));
+	}
+
+private:
+	std::string & _out;
+};
+
+class SnapshotReader
+/// Reads back the values of a SnapshotWriter. Reading past the end leaves
+/// the reader failed instead of throwing.
+{
+public:
+	SnapshotReader(const char * begin, const char * end):
+	_pos(begin),
+	_end(end),
+	_ok(true)
+	{
+	}
+
+	int getInt()
+	{
+		Poco::Int32 v = 0;
+		take(&v, sizeof(v));
+		return v;
+	}
+
+	double getDouble()
+	{
+		double v = 0;
+		take(&v, sizeof(v));
+		return v;
+	}
+
+	std::string getString()
+	{
+		std::size_t length = getCount(1);
+		if (_ok == false)
+			return std::string();
+		std::string value(_pos, length);
+		_pos += length;
+		return value;
+	}
+
+	std::size_t getCount(std::size_t itemSize)
+	{
+		Poco::UInt32 v = 0;
+		take(&v, sizeof(v));
+		// A count that cannot fit in the rest of the file is a corrupt one.
+		if ((std::size_t) (_end - _pos) < (std::size_t) v * itemSize)
+			_ok = false;
+		return (_ok ? v : 0);
+	}
+
+	bool failed() const
+	{
+		return (_ok == false);
+	}
+
+	bool done() const
+	{
+		return _ok && (_pos == _end);
+	}
+
+private:
+	const char * _pos;
+	const char * _end;
+	bool _ok;
+
+	void take(void * value, std::size_t size)
+	{
+		if ((_ok == false) || ((std::size_t) (_end - _pos) < size))
+		{
+			_ok = false;
+			return;
+		}
+		std::memcpy(value, _pos, size);
+		_pos += size;
+	}
+};
+
+class SnapshotFile
+/// File holding a payload written by a SnapshotWriter after a header
+/// giving the kind of snapshot, the format version, the size and the CRC32
+/// of the payload. A file of another kind or version, truncated or whose
+/// payload does not match the checksum is not used.
+{
+public:
+	enum
+	{
+		MAGIC_SIZE = 8
+	};
+
+	static void write(const std::string & path, const char * magic,
+					  Poco::UInt32 version, const std::string & payload,
+					  const std::string & kind);
+		/// The file is written aside and renamed, a reader never maps half
+		/// a snapshot. The kind names the snapshot in the errors. Throws a
+		/// FoundationException when it cannot be written.
+
+	static bool read(const std::string & path, const char * magic,
+					 Poco::UInt32 version, const std::string & kind,
+					 std::string & payload, std::string & reason);
+		/// Maps the file and copies its payload. False, with the reason,
+		/// when the file is missing or not valid.
+
+private:
+	struct Header
+	{
+		char magic[MAGIC_SIZE];
+		Poco::UInt32 version;
+		Poco::UInt32 checksum;
+		Poco::UInt64 size;
+	};
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // SnapshotFile_INCLUDED
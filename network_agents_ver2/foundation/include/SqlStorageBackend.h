@@ -0,0 +1,53 @@
+#ifndef SqlStorageBackend_INCLUDED
+#define SqlStorageBackend_INCLUDED
+
+#include <Poco/Data/Session.h>
+#include <Poco/Data/SessionPool.h>
+#include <string>
+
+#include "StorageBackend.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class SqlStorageBackend: public StorageBackend
+/// Database reached through a Poco::Data connector. A SQLite database is
+/// put in WAL mode with normal synchronization, so appending the results
+/// of a period is one batched transaction that does not block the readers,
+/// and its statements are kept under the SQLite limit of 999 values.
+{
+public:
+	SqlStorageBackend(const std::string & connector, const std::string & connectionString);
+		/// The connector is "MySQL" or "SQLite". No connection is made before
+		/// the first use.
+
+	~SqlStorageBackend();
+
+	const std::string & getName() const;
+
+	Poco::Data::SessionPool * getPool();
+
+	void readConfiguration(bool countExecution, unsigned threads,
+						   ConfigurationRows & rows);
+
+	int readExecutionCount(bool countExecution, int configured);
+		/// The one of the general parameters.
+
+	void write(const std::vector<BulkInsert *> & inserts);
+
+private:
+	std::string _connector;
+	Poco::Data::SessionPool * _pool;
+	bool _sqlite;
+	std::size_t _max_placeholders;
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // SqlStorageBackend_INCLUDED
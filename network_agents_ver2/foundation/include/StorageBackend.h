@@ -0,0 +1,65 @@
+#ifndef StorageBackend_INCLUDED
+#define StorageBackend_INCLUDED
+
+#include <Poco/Util/AbstractConfiguration.h>
+#include <Poco/Data/SessionPool.h>
+#include <string>
+#include <vector>
+
+#include "BulkInsert.h"
+#include "ConfigurationRows.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+class StorageBackend
+/// Where the servers read their configuration and store the results of
+/// the periods. The storage_backend configuration key chooses it: "mysql"
+/// connects with the db_* keys, "sqlite" opens the database file
+/// storage_path, "file" appends the results to text files under the
+/// directory storage_path and "columnar" to columnar result logs there.
+{
+public:
+	static StorageBackend * create(Poco::Util::AbstractConfiguration & config);
+		/// Throws a Poco::NotFoundException when a key needed by the backend
+		/// is missing and a FoundationException for an unknown backend.
+
+	static StorageBackend * create(Poco::Util::AbstractConfiguration & config,
+								   const std::string & backend);
+		/// The given backend instead of the one of storage_backend.
+
+	virtual ~StorageBackend();
+
+	virtual const std::string & getName() const = 0;
+
+	virtual Poco::Data::SessionPool * getPool();
+		/// Pool of the database sessions, NULL when there is no database.
+
+	virtual void readConfiguration(bool countExecution, unsigned threads,
+								   ConfigurationRows & rows) = 0;
+		/// With countExecution the execution count stored is incremented
+		/// first. Throws a FoundationException when it cannot be read.
+
+	virtual int readExecutionCount(bool countExecution, int configured);
+		/// Execution count stored, incremented first with countExecution
+		/// so every run of the clock server gets one of its own. The one
+		/// configured by default. Throws a FoundationException when it
+		/// cannot be read or stored.
+
+	virtual void startExecution(int executionCount);
+		/// Execution whose results are written from now on. Nothing by default.
+
+	virtual void write(const std::vector<BulkInsert *> & inserts) = 0;
+		/// Stores the rows of the inserts in a single transaction, or
+		/// append, per call.
+};
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
+
+#endif   // StorageBackend_INCLUDED
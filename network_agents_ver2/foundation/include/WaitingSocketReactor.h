@@ -2,6 +2,14 @@
 #define WaitingSocketReactor_INCLUDED
 
 #include <Poco/Net/SocketReactor.h>
+#include <Poco/Net/SocketNotification.h>
+#include <Poco/Net/DatagramSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Mutex.h>
+#include <Poco/Thread.h>
+#include <functional>
+#include <deque>
 #include <iostream>
 
 
@@ -12,15 +20,50 @@ namespace Eco
 {
 
 class WaitingSocketReactor: public  Poco::Net::SocketReactor
+/// Socket reactor that can also run tasks posted by other threads.
+/// Posted tasks are executed on the reactor thread, so they can touch
+/// connection handlers and their FIFO buffers without further locking.
+/// A loopback datagram socket is used to wake the reactor up when a task
+/// is posted while it is waiting on the sockets.
 {
 
 public:
-	
+
+	typedef std::function<void()> Task;
+
 	WaitingSocketReactor();
-	
+
 	~WaitingSocketReactor();
-	
+
+	void post(const Task & task);
+		/// Queues the task for execution on the reactor thread.
+		/// It can be called from any thread.
+
+	void run();
+
+	bool isReactorThread();
+		/// True when called by the thread running the reactor.
+
 	void onIdle();
+
+	void onTimeout();
+
+	void onWakeup(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf);
+
+protected:
+
+	void runPostedTasks();
+
+private:
+
+	Poco::FastMutex _tasks_mutex;
+	std::deque<Task> _tasks;
+	bool _wakeup_pending;
+	Poco::Thread * _thread;
+
+	Poco::Net::DatagramSocket _wakeup_socket;
+	Poco::Net::DatagramSocket _wakeup_sender;
+	Poco::Net::SocketAddress _wakeup_address;
 };
 
 
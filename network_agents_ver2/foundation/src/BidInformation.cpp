@@ -157,6 +157,16 @@ bool BidInformation::isBidActive(std::string serviceId, std::string providerId,
 	}
 }
 
+void BidInformation::getActiveBids(std::string serviceId, std::vector<Bid *> &bids)
+{
+	std::map<std::string ,BidServiceInformation*>::iterator it;
+	it = _service_information.find(serviceId);
+	if (it != _service_information.end())
+	{
+		(*(it->second)).getActiveBids(bids);
+	}
+}
+
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
@@ -111,6 +111,14 @@ bool BidProviderInformation::isBidActive(std::string bidId)
 
 }
 
+void BidProviderInformation::getActiveBids(std::vector<Bid *> &bids)
+{
+	for(std::map<std::string, Bid *>::iterator it = _bids.begin(); it != _bids.end(); ++it)
+	{
+		bids.push_back(it->second);
+	}
+}
+
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
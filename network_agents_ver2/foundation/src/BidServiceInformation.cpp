@@ -291,6 +291,15 @@ bool BidServiceInformation::isBidActive(std::string providerId, std::string bidI
 	
 }
 
+void BidServiceInformation::getActiveBids(std::vector<Bid *> &bids)
+{
+	std::map<std::string, BidProviderInformation *>::iterator it;
+	for (it = _provider_information.begin(); it != _provider_information.end(); ++it)
+	{
+		(*(it->second)).getActiveBids(bids);
+	}
+}
+
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
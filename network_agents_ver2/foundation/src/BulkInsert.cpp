@@ -0,0 +1,178 @@
+#include <Poco/NumberFormatter.h>
+#include <algorithm>
+#include <cstdio>
+
+#include "BulkInsert.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+BulkColumnVisitor::~BulkColumnVisitor()
+{
+}
+
+BulkInsert::BulkInsert(const std::string & table, const std::string & columns,
+					   std::size_t chunk):
+_table(table),
+_columns(columns),
+_chunk(chunk),
+_rows(0)
+{
+	if (_chunk == 0)
+		_chunk = DEFAULT_CHUNK;
+}
+
+BulkInsert::~BulkInsert()
+{
+}
+
+std::string BulkInsert::getText(std::size_t rows) const
+{
+	std::string row = "(";
+	for (std::size_t i = 0; i < _binders.size(); ++i)
+	{
+		if (i > 0)
+			row.append(",");
+		row.append("?");
+	}
+	row.append(")");
+
+	std::string text = "insert into " + _table + " (" + _columns + ") values ";
+	text.reserve(text.size() + rows * (row.size() + 1));
+	for (std::size_t i = 0; i < rows; ++i)
+	{
+		if (i > 0)
+			text.append(",");
+		text.append(row);
+	}
+	return text;
+}
+
+std::size_t BulkInsert::execute(Poco::Data::Session & session,
+							   std::size_t maxPlaceholders)
+{
+	std::vector<std::size_t> statements;
+	getStatementRows(maxPlaceholders, statements);
+
+	// Every full chunk has the same text, only the last one is shorter.
+	std::string fullText;
+	std::size_t first = 0;
+	for (std::size_t s = 0; s < statements.size(); ++s)
+	{
+		std::size_t rows = statements[s];
+		if ((rows == statements[0]) && fullText.empty())
+			fullText = getText(rows);
+
+		Poco::Data::Statement insert(session);
+		if (rows == statements[0])
+			insert << fullText;
+		else
+			insert << getText(rows);
+
+		for (std::size_t row = first; row < first + rows; ++row)
+		{
+			for (std::size_t i = 0; i < _binders.size(); ++i)
+				_binders[i](insert, row);
+		}
+		insert.execute();
+		first += rows;
+	}
+	return statements.size();
+}
+
+void BulkInsert::getStatementRows(std::size_t maxPlaceholders,
+								  std::vector<std::size_t> & rows) const
+{
+	rows.clear();
+	if ((_rows == 0) || _binders.empty())
+		return;
+
+	std::size_t chunk = _chunk;
+	if (chunk * _binders.size() > maxPlaceholders)
+		chunk = std::max<std::size_t>(1, maxPlaceholders / _binders.size());
+
+	for (std::size_t first = 0; first < _rows; first += chunk)
+		rows.push_back(std::min(chunk, _rows - first));
+}
+
+void BulkInsert::appendText(std::string & out) const
+{
+	for (std::size_t row = 0; row < _rows; ++row)
+	{
+		for (std::size_t i = 0; i < _formatters.size(); ++i)
+		{
+			if (i > 0)
+				out.append("\t");
+			_formatters[i](out, row);
+		}
+		out.append("\n");
+	}
+}
+
+void BulkInsert::visitColumns(BulkColumnVisitor & visitor) const
+{
+	for (std::size_t i = 0; i < _columns_typed.size(); ++i)
+		_columns_typed[i](visitor);
+}
+
+const std::string & BulkInsert::getTable() const
+{
+	return _table;
+}
+
+const std::string & BulkInsert::getColumns() const
+{
+	return _columns;
+}
+
+std::size_t BulkInsert::size() const
+{
+	return _rows;
+}
+
+void BulkInsert::appendValue(std::string & out, int value)
+{
+	Poco::NumberFormatter::append(out, value);
+}
+
+void BulkInsert::appendValue(std::string & out, double value)
+{
+	// Enough digits to read back the same double.
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+	out.append(buffer);
+}
+
+void BulkInsert::appendValue(std::string & out, const std::string & value)
+{
+	// Escaped as LOAD DATA and COPY read them, so a value cannot split
+	// its field or its line.
+	for (std::size_t i = 0; i < value.size(); ++i)
+	{
+		switch (value[i])
+		{
+			case '\t':
+				out.append("\\t");
+				break;
+			case '\n':
+				out.append("\\n");
+				break;
+			case '\r':
+				out.append("\\r");
+				break;
+			case '\\':
+				out.append("\\\\");
+				break;
+			default:
+				out.push_back(value[i]);
+		}
+	}
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
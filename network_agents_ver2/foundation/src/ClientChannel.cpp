@@ -0,0 +1,243 @@
+#include <Poco/Util/Application.h>
+#include <Poco/NObserver.h>
+#include <Poco/Exception.h>
+#include <Poco/Net/NetException.h>
+#include <vector>
+
+#include "ClientChannel.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ClientChannel::ClientChannel(WaitingSocketReactor & reactor,
+							 const Poco::Net::SocketAddress & address,
+							 long timeout):
+_reactor(reactor),
+_address(address),
+_timeout((Poco::Timestamp::TimeDiff) timeout * 1000),
+_timer(timeout, (timeout / 4) + 1),
+_open(false),
+_writing(false)
+{
+}
+
+ClientChannel::~ClientChannel()
+{
+	_timer.stop();
+}
+
+void ClientChannel::open()
+{
+	Poco::AutoPtr<ClientChannel> channel(this, true);
+	_reactor.post([channel]() { channel->doOpen(); });
+
+	// The deadlines are checked even when the reactor has no events.
+	_timer.start(Poco::TimerCallback<ClientChannel>(*this, &ClientChannel::onTimer));
+}
+
+void ClientChannel::request(Message message, const Callback & callback)
+{
+	Poco::AutoPtr<ClientChannel> channel(this, true);
+	std::string data = message.to_string();
+	_reactor.post([channel, data, callback]() { channel->doRequest(data, callback); });
+}
+
+void ClientChannel::close()
+{
+	_timer.stop();
+
+	Poco::AutoPtr<ClientChannel> channel(this, true);
+	_reactor.post([channel]() { channel->fail("Channel closed"); });
+}
+
+bool ClientChannel::isOpen()
+{
+	return _open;
+}
+
+void ClientChannel::doOpen()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	try
+	{
+		_socket = Poco::Net::StreamSocket(_address.family());
+		_socket.connectNB(_address);
+	}
+	catch (Poco::Exception &e)
+	{
+		app.logger().error(Poco::format("Connecting to %s: %s", _address.toString(), e.displayText()));
+		return;
+	}
+	_open = true;
+
+	_reactor.addEventHandler(_socket,
+		Poco::NObserver<ClientChannel, Poco::Net::ReadableNotification>(*this, &ClientChannel::onSocketReadable));
+	_reactor.addEventHandler(_socket,
+		Poco::NObserver<ClientChannel, Poco::Net::ErrorNotification>(*this, &ClientChannel::onSocketError));
+
+	// Writable once connected, the requests queued meanwhile go then.
+	setWriting(true);
+}
+
+void ClientChannel::doRequest(const std::string & data, const Callback & callback)
+{
+	if (_open == false)
+	{
+		Message response;
+		callback(false, response);
+		return;
+	}
+
+	Pending pending;
+	pending.callback = callback;
+	pending.deadline += _timeout;
+	pending.expired = false;
+	_pending.push_back(pending);
+
+	_output.append(data);
+	setWriting(true);
+}
+
+void ClientChannel::onSocketReadable(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf)
+{
+	std::vector<char> buffer(BUFFER_SIZE);
+	int len = 0;
+	try
+	{
+		len = _socket.receiveBytes(&buffer[0], (int) buffer.size());
+	}
+	catch (Poco::Exception &e)
+	{
+		len = 0;
+	}
+
+	if (len <= 0)
+	{
+		fail("Connection closed by " + _address.toString());
+		return;
+	}
+
+	_framing.append(&buffer[0], (std::size_t) len);
+
+	while (_pending.empty() == false)
+	{
+		Message response;
+		if (_framing.next(response) == false)
+			break;
+
+		// The late response of a request that timed out is dropped.
+		Pending pending = _pending.front();
+		_pending.pop_front();
+		if (pending.expired == false)
+			pending.callback(true, response);
+	}
+}
+
+void ClientChannel::onSocketWritable(const Poco::AutoPtr<Poco::Net::WritableNotification>& pNf)
+{
+	if (_output.empty())
+	{
+		setWriting(false);
+		return;
+	}
+
+	int len = 0;
+	try
+	{
+		len = _socket.sendBytes(_output.data(), (int) _output.size());
+	}
+	catch (Poco::Exception &e)
+	{
+		fail(Poco::format("Sending to %s: %s", _address.toString(), e.displayText()));
+		return;
+	}
+
+	if (len > 0)
+		_output.erase(0, (std::size_t) len);
+	if (_output.empty())
+		setWriting(false);
+}
+
+void ClientChannel::onSocketError(const Poco::AutoPtr<Poco::Net::ErrorNotification>& pNf)
+{
+	fail("Socket error on " + _address.toString());
+}
+
+void ClientChannel::onTimer(Poco::Timer & timer)
+{
+	Poco::AutoPtr<ClientChannel> channel(this, true);
+	_reactor.post([channel]() { channel->expire(); });
+}
+
+void ClientChannel::expire()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	// The requests keep their place, so that their responses if any are
+	// still matched, and only fail. The deadlines are in request order.
+	std::deque<Pending>::iterator it;
+	for (it = _pending.begin(); (it != _pending.end()) && it->deadline.isElapsed(0); ++it)
+	{
+		if (it->expired == true)
+			continue;
+		it->expired = true;
+
+		app.logger().error("Request to " + _address.toString() + " timed out");
+		Message response;
+		Callback callback = it->callback;
+		callback(false, response);
+	}
+}
+
+void ClientChannel::fail(const std::string & reason)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	if (_open == true)
+	{
+		_open = false;
+		setWriting(false);
+		_reactor.removeEventHandler(_socket,
+			Poco::NObserver<ClientChannel, Poco::Net::ReadableNotification>(*this, &ClientChannel::onSocketReadable));
+		_reactor.removeEventHandler(_socket,
+			Poco::NObserver<ClientChannel, Poco::Net::ErrorNotification>(*this, &ClientChannel::onSocketError));
+		_socket.close();
+	}
+	_output.clear();
+
+	if (_pending.empty() == false)
+		app.logger().error(reason);
+
+	// The callbacks may queue new requests, they fail right away.
+	std::deque<Pending> pending;
+	pending.swap(_pending);
+	std::deque<Pending>::iterator it;
+	for (it = pending.begin(); it != pending.end(); ++it)
+	{
+		if (it->expired == true)
+			continue;
+		Message response;
+		it->callback(false, response);
+	}
+}
+
+void ClientChannel::setWriting(bool writing)
+{
+	if (writing == _writing)
+		return;
+	_writing = writing;
+
+	if (writing)
+		_reactor.addEventHandler(_socket,
+			Poco::NObserver<ClientChannel, Poco::Net::WritableNotification>(*this, &ClientChannel::onSocketWritable));
+	else
+		_reactor.removeEventHandler(_socket,
+			Poco::NObserver<ClientChannel, Poco::Net::WritableNotification>(*this, &ClientChannel::onSocketWritable));
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
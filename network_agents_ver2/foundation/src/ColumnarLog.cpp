@@ -0,0 +1,400 @@
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+#include <Poco/Exception.h>
+#include <fstream>
+#include <cstring>
+
+#include "ColumnarLog.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+static const char COLUMNAR_LOG_MAGIC[8] = { 'E', 'C', 'O', 'C', 'O', 'L', '0', '1' };
+
+static const Poco::UInt32 COLUMNAR_CHUNK_MARKER = 0x4B4E4843;	// "CHNK"
+
+struct ColumnarFileHeader
+{
+	char magic[8];
+	Poco::UInt32 columns;
+	Poco::UInt32 table_length;
+	Poco::UInt32 names_length;
+	Poco::UInt32 reserved;
+};
+
+struct ColumnarChunkHeader
+{
+	Poco::UInt32 marker;
+	Poco::UInt32 rows;
+	Poco::UInt32 strings;
+	Poco::UInt32 reserved;
+	Poco::UInt64 size;
+};
+
+static std::size_t alignColumnar(std::size_t size)
+{
+	return (size + 7) & ~((std::size_t) 7);
+}
+
+static void padColumnar(std::string & out)
+{
+	out.append(alignColumnar(out.size()) - out.size(), '\0');
+}
+
+class ColumnEncoder: public BulkColumnVisitor
+/// Encodes the columns of an insert as the arrays of a chunk. The strings
+/// missing from the dictionary are added to it and to the chunk.
+{
+public:
+	ColumnEncoder(std::map<std::string, Poco::UInt32> & dictionary,
+				  std::vector<std::string> & added, std::string & out,
+				  std::vector<char> & types):
+	_dictionary(dictionary),
+	_added(added),
+	_out(out),
+	_types(types)
+	{
+	}
+
+	void visit(const std::vector<int> & values)
+	{
+		_types.push_back(ColumnarLog::COLUMN_INT);
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			Poco::Int32 v = values[i];
+			_out.append((const char *) &v, sizeof(v));
+		}
+		padColumnar(_out);
+	}
+
+	void visit(const std::vector<double> & values)
+	{
+		_types.push_back(ColumnarLog::COLUMN_DOUBLE);
+		if (values.empty() == false)
+			_out.append((const char *) &values[0], values.size() * sizeof(double));
+	}
+
+	void visit(const std::vector<std::string> & values)
+	{
+		_types.push_back(ColumnarLog::COLUMN_STRING);
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			Poco::UInt32 index;
+			std::map<std::string, Poco::UInt32>::iterator it = _dictionary.find(values[i]);
+			if (it == _dictionary.end())
+			{
+				index = (Poco::UInt32) _dictionary.size();
+				_dictionary.insert(std::pair<std::string, Poco::UInt32>(values[i], index));
+				_added.push_back(values[i]);
+			}
+			else
+			{
+				index = it->second;
+			}
+			_out.append((const char *) &index, sizeof(index));
+		}
+		padColumnar(_out);
+	}
+
+private:
+	std::map<std::string, Poco::UInt32> & _dictionary;
+	std::vector<std::string> & _added;
+	std::string & _out;
+	std::vector<char> & _types;
+};
+
+ColumnarLog::ColumnarLog(const std::string & path):
+_path(path),
+_opened(false),
+_exists(false)
+{
+}
+
+ColumnarLog::~ColumnarLog()
+{
+}
+
+std::string ColumnarLog::encodeLayout(const BulkInsert & insert, const std::vector<char> & types)
+{
+	ColumnarFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, COLUMNAR_LOG_MAGIC, sizeof(header.magic));
+	header.columns = (Poco::UInt32) types.size();
+	header.table_length = (Poco::UInt32) insert.getTable().size();
+	header.names_length = (Poco::UInt32) insert.getColumns().size();
+
+	std::string out((const char *) &header, sizeof(header));
+	out.append(insert.getTable());
+	out.append(insert.getColumns());
+	out.append(&types[0], types.size());
+	padColumnar(out);
+	return out;
+}
+
+bool ColumnarLog::decodeLayout(const char * begin, std::size_t size, Layout & layout)
+{
+	ColumnarFileHeader header;
+	if (size < sizeof(header))
+		return false;
+	std::memcpy(&header, begin, sizeof(header));
+	if (std::memcmp(header.magic, COLUMNAR_LOG_MAGIC, sizeof(header.magic)) != 0)
+		return false;
+
+	std::size_t length = sizeof(header) + (std::size_t) header.table_length +
+						 header.names_length + header.columns;
+	if ((header.columns == 0) || (size < alignColumnar(length)))
+		return false;
+
+	const char * pos = begin + sizeof(header);
+	layout.table.assign(pos, header.table_length);
+	pos += header.table_length;
+	layout.columns.assign(pos, header.names_length);
+	pos += header.names_length;
+	layout.types.assign(pos, pos + header.columns);
+	layout.first_chunk = alignColumnar(length);
+	return true;
+}
+
+std::size_t ColumnarLog::decodeChunk(const char * begin, std::size_t size, std::size_t offset,
+									 const Layout & layout, Chunk & chunk)
+{
+	ColumnarChunkHeader header;
+	if (size - offset < sizeof(header))
+		return 0;
+	std::memcpy(&header, begin + offset, sizeof(header));
+	if ((header.marker != COLUMNAR_CHUNK_MARKER) ||
+		(header.size > size - offset - sizeof(header)))
+		return 0;
+
+	const char * pos = begin + offset + sizeof(header);
+	const char * end = pos + header.size;
+
+	chunk.rows = header.rows;
+	chunk.strings.clear();
+	chunk.columns.clear();
+
+	for (Poco::UInt32 i = 0; i < header.strings; ++i)
+	{
+		Poco::UInt32 length;
+		if ((std::size_t) (end - pos) < sizeof(length))
+			return 0;
+		std::memcpy(&length, pos, sizeof(length));
+		pos += sizeof(length);
+		if ((std::size_t) (end - pos) < length)
+			return 0;
+		chunk.strings.push_back(std::string(pos, length));
+		pos += length;
+	}
+	pos = begin + alignColumnar(pos - begin);
+
+	for (std::size_t i = 0; i < layout.types.size(); ++i)
+	{
+		std::size_t width = (layout.types[i] == COLUMN_DOUBLE) ? sizeof(double) : sizeof(Poco::UInt32);
+		std::size_t bytes = alignColumnar((std::size_t) header.rows * width);
+		if ((pos > end) || ((std::size_t) (end - pos) < bytes))
+			return 0;
+		chunk.columns.push_back(pos);
+		pos += bytes;
+	}
+	if (pos != end)
+		return 0;
+	return end - begin;
+}
+
+void ColumnarLog::open()
+{
+	_opened = true;
+	Poco::File file(_path);
+	if ((file.exists() == false) || (file.getSize() == 0))
+		return;
+
+	std::size_t valid = 0;
+	{
+		Poco::SharedMemory mapping(file, Poco::SharedMemory::AM_READ);
+		const char * begin = mapping.begin();
+		std::size_t size = mapping.end() - mapping.begin();
+
+		Layout layout;
+		if (decodeLayout(begin, size, layout) == false)
+			throw FoundationException("Not a columnar result log: " + _path, 344);
+
+		// The dictionary is rebuilt from the chunks written before.
+		valid = layout.first_chunk;
+		Chunk chunk;
+		std::size_t next;
+		while ((valid < size) && ((next = decodeChunk(begin, size, valid, layout, chunk)) != 0))
+		{
+			for (std::size_t i = 0; i < chunk.strings.size(); ++i)
+				_dictionary.insert(std::pair<std::string, Poco::UInt32>(chunk.strings[i],
+								   (Poco::UInt32) _dictionary.size()));
+			valid = next;
+		}
+		_table = layout.table;
+		_columns = layout.columns;
+		_types = layout.types;
+	}
+
+	if (valid < file.getSize())
+		file.setSize(valid);
+	_exists = true;
+}
+
+void ColumnarLog::append(const BulkInsert & insert)
+{
+	if (insert.size() == 0)
+		return;
+
+	if (_opened == false)
+		open();
+	if (_exists && ((insert.getTable() != _table) || (insert.getColumns() != _columns)))
+		throw FoundationException("Columnar result log " + _path + " holds another table", 344);
+
+	std::vector<std::string> added;
+	std::string columns;
+	std::vector<char> types;
+	ColumnEncoder encoder(_dictionary, added, columns, types);
+	insert.visitColumns(encoder);
+
+	std::string out;
+	try
+	{
+		if (_exists == false)
+			out = encodeLayout(insert, types);
+		else if (types != _types)
+			throw FoundationException("Columnar result log " + _path + " has other column types", 344);
+
+		std::string strings;
+		for (std::size_t i = 0; i < added.size(); ++i)
+		{
+			Poco::UInt32 length = (Poco::UInt32) added[i].size();
+			strings.append((const char *) &length, sizeof(length));
+			strings.append(added[i]);
+		}
+		padColumnar(strings);
+
+		ColumnarChunkHeader header;
+		std::memset(&header, 0, sizeof(header));
+		header.marker = COLUMNAR_CHUNK_MARKER;
+		header.rows = (Poco::UInt32) insert.size();
+		header.strings = (Poco::UInt32) added.size();
+		header.size = strings.size() + columns.size();
+		out.append((const char *) &header, sizeof(header));
+		out.append(strings);
+		out.append(columns);
+
+		std::ofstream file(_path.c_str(), std::ios::binary | std::ios::app);
+		file.write(out.data(), out.size());
+		file.close();
+		if (file.fail())
+			throw FoundationException("Could not append to " + _path, 343);
+	}
+	catch (FoundationException &e)
+	{
+		// The strings of a chunk not written are not in the file.
+		for (std::size_t i = 0; i < added.size(); ++i)
+			_dictionary.erase(added[i]);
+		throw;
+	}
+
+	if (_exists == false)
+	{
+		_exists = true;
+		_table = insert.getTable();
+		_columns = insert.getColumns();
+		_types = types;
+	}
+}
+
+std::size_t ColumnarLog::load(const std::string & path, StorageBackend & target,
+							  std::size_t chunk)
+{
+	Poco::File file(path);
+	Poco::SharedMemory mapping(file, Poco::SharedMemory::AM_READ);
+	const char * begin = mapping.begin();
+	std::size_t size = mapping.end() - mapping.begin();
+
+	Layout layout;
+	if (decodeLayout(begin, size, layout) == false)
+		throw FoundationException("Not a columnar result log: " + path, 344);
+
+	std::size_t intColumns = 0, doubleColumns = 0, stringColumns = 0;
+	for (std::size_t i = 0; i < layout.types.size(); ++i)
+	{
+		if (layout.types[i] == COLUMN_INT)
+			++intColumns;
+		else if (layout.types[i] == COLUMN_DOUBLE)
+			++doubleColumns;
+		else
+			++stringColumns;
+	}
+
+	std::vector<std::string> dictionary;
+	std::size_t rows = 0;
+	std::size_t offset = layout.first_chunk;
+	Chunk current;
+	std::size_t next;
+	while ((offset < size) && ((next = decodeChunk(begin, size, offset, layout, current)) != 0))
+	{
+		dictionary.insert(dictionary.end(), current.strings.begin(), current.strings.end());
+
+		// Reserved, the inserts keep references to the vectors.
+		std::vector<std::vector<int> > ints;
+		std::vector<std::vector<double> > doubles;
+		std::vector<std::vector<std::string> > strings;
+		ints.reserve(intColumns);
+		doubles.reserve(doubleColumns);
+		strings.reserve(stringColumns);
+
+		BulkInsert insert(layout.table, layout.columns, chunk);
+		for (std::size_t i = 0; i < layout.types.size(); ++i)
+		{
+			const char * data = current.columns[i];
+			if (layout.types[i] == COLUMN_INT)
+			{
+				ints.push_back(std::vector<int>(current.rows));
+				for (Poco::UInt32 row = 0; row < current.rows; ++row)
+				{
+					Poco::Int32 v;
+					std::memcpy(&v, data + row * sizeof(v), sizeof(v));
+					ints.back()[row] = v;
+				}
+				insert.column(ints.back());
+			}
+			else if (layout.types[i] == COLUMN_DOUBLE)
+			{
+				doubles.push_back(std::vector<double>(current.rows));
+				if (current.rows > 0)
+					std::memcpy(&doubles.back()[0], data, current.rows * sizeof(double));
+				insert.column(doubles.back());
+			}
+			else
+			{
+				strings.push_back(std::vector<std::string>(current.rows));
+				for (Poco::UInt32 row = 0; row < current.rows; ++row)
+				{
+					Poco::UInt32 index;
+					std::memcpy(&index, data + row * sizeof(index), sizeof(index));
+					if (index >= dictionary.size())
+						throw FoundationException("Invalid string in columnar result log " + path, 344);
+					strings.back()[row] = dictionary[index];
+				}
+				insert.column(strings.back());
+			}
+		}
+
+		std::vector<BulkInsert *> inserts(1, &insert);
+		target.write(inserts);
+		rows += current.rows;
+		offset = next;
+	}
+	return rows;
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,73 @@
+#include <Poco/Path.h>
+#include <Poco/NumberFormatter.h>
+
+#include "ColumnarStorageBackend.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+static const std::string COLUMNAR_STORAGE_NAME = "columnar";
+
+ColumnarStorageBackend::ColumnarStorageBackend(const std::string & directory,
+											   const std::string & snapshot):
+FileStorageBackend(directory, snapshot),
+_execution_count(0)
+{
+}
+
+ColumnarStorageBackend::~ColumnarStorageBackend()
+{
+	closeLogs();
+}
+
+const std::string & ColumnarStorageBackend::getName() const
+{
+	return COLUMNAR_STORAGE_NAME;
+}
+
+void ColumnarStorageBackend::startExecution(int executionCount)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	closeLogs();
+	_execution_count = executionCount;
+}
+
+void ColumnarStorageBackend::write(const std::vector<BulkInsert *> & inserts)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (std::size_t i = 0; i < inserts.size(); ++i)
+	{
+		if (inserts[i]->size() == 0)
+			continue;
+
+		const std::string & table = inserts[i]->getTable();
+		std::map<std::string, ColumnarLog *>::iterator it = _logs.find(table);
+		if (it == _logs.end())
+		{
+			Poco::Path path(_directory);
+			path.makeDirectory();
+			path.setFileName(table + "." + Poco::NumberFormatter::format(_execution_count) + ".col");
+			it = _logs.insert(std::pair<std::string, ColumnarLog *>(table,
+							  new ColumnarLog(path.toString()))).first;
+		}
+		it->second->append(*inserts[i]);
+	}
+}
+
+void ColumnarStorageBackend::closeLogs()
+{
+	std::map<std::string, ColumnarLog *>::iterator it;
+	for (it = _logs.begin(); it != _logs.end(); ++it)
+		delete it->second;
+	_logs.clear();
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
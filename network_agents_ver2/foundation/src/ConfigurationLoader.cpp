@@ -0,0 +1,375 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Data/Statement.h>
+#include <Poco/Thread.h>
+#include <Poco/Runnable.h>
+#include <Poco/Mutex.h>
+#include <Poco/Exception.h>
+#include <atomic>
+
+#include "ConfigurationLoader.h"
+#include "FoundationException.h"
+
+using namespace Poco::Data::Keywords;
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+namespace
+{
+
+class TableLoadWorker: public Poco::Runnable
+/// Takes the next table load not yet taken until none is left, with a
+/// session of its own. The first error is kept for the caller.
+{
+public:
+	typedef std::function<void(Poco::Data::Session &)> TableLoad;
+
+	TableLoadWorker(Poco::Data::SessionPool & pool, std::vector<TableLoad> & loads,
+					std::atomic<std::size_t> & next, Poco::FastMutex & mutex,
+					std::string & error):
+	_pool(pool),
+	_loads(loads),
+	_next(next),
+	_mutex(mutex),
+	_error(error)
+	{
+	}
+
+	void run()
+	{
+		try
+		{
+			Poco::Data::Session session(_pool.get());
+			std::size_t index = _next++;
+			while (index < _loads.size())
+			{
+				_loads[index](session);
+				index = _next++;
+			}
+		}
+		catch (Poco::Exception &e)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_error.empty())
+				_error = e.displayText();
+			// The other workers stop after their current table.
+			_next = _loads.size();
+		}
+	}
+
+private:
+	Poco::Data::SessionPool & _pool;
+	std::vector<TableLoad> & _loads;
+	std::atomic<std::size_t> & _next;
+	Poco::FastMutex & _mutex;
+	std::string & _error;
+};
+
+}
+
+ConfigurationLoader::ConfigurationLoader(Poco::Data::SessionPool & pool, unsigned threads):
+_pool(pool),
+_threads(threads),
+_count_update("update simulation_generalparameters set execution_count = execution_count + 1 limit 1")
+{
+	if (_threads == 0)
+		_threads = 1;
+}
+
+ConfigurationLoader::~ConfigurationLoader()
+{
+}
+
+void ConfigurationLoader::setCountUpdate(const std::string & statement)
+{
+	_count_update = statement;
+}
+
+void ConfigurationLoader::loadGeneralParameters(bool countExecution, GeneralParametersRow & row)
+{
+	try
+	{
+		Poco::Data::Session session(_pool.get());
+		readGeneralParameters(session, countExecution, row);
+	}
+	catch (Poco::Exception &e)
+	{
+		throw FoundationException("Could not read the general parameters: " + e.displayText(), 337);
+	}
+}
+
+void ConfigurationLoader::load(bool countExecution, ConfigurationRows & rows)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	loadGeneralParameters(countExecution, rows.general);
+
+	std::vector<TableLoad> loads;
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> name;
+		Poco::Data::Statement select(session);
+		select << "SELECT id, name FROM simulation_resource",
+				into(id), into(name);
+		select.execute();
+		rows.resources.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			rows.resources[i].id = id[i];
+			rows.resources[i].name = name[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> name, domain, class_name;
+		Poco::Data::Statement select(session);
+		select << "SELECT id, name, domain, class_name FROM simulation_probabilitydistribution",
+				into(id), into(name), into(domain), into(class_name);
+		select.execute();
+		rows.distributions.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			DistributionRow & row = rows.distributions[i];
+			row.id = id[i];
+			row.name = name[i];
+			row.domain = domain[i];
+			row.class_name = class_name[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<double> value, probability;
+		Poco::Data::Statement select(session);
+		select << "SELECT probability_id_id, value, probability FROM simulation_discreteprobabilitydistribution",
+				into(id), into(value), into(probability);
+		select.execute();
+		rows.distribution_points.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			DistributionPointRow & row = rows.distribution_points[i];
+			row.distribution_id = id[i];
+			row.value = value[i];
+			row.probability = probability[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> parameter;
+		std::vector<double> value;
+		Poco::Data::Statement select(session);
+		select << "SELECT probability_id_id, parameter, value FROM simulation_continuousprobabilitydistribution",
+				into(id), into(parameter), into(value);
+		select.execute();
+		rows.distribution_parameters.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			DistributionParameterRow & row = rows.distribution_parameters[i];
+			row.distribution_id = id[i];
+			row.parameter = parameter[i];
+			row.value = value[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> name, range_function, class_name;
+		Poco::Data::Statement select(session);
+		select << "SELECT id, name, range_function, class_name FROM simulation_costfunction",
+				into(id), into(name), into(range_function), into(class_name);
+		select.execute();
+		rows.cost_functions.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			CostFunctionRow & row = rows.cost_functions[i];
+			row.id = id[i];
+			row.name = name[i];
+			row.range = range_function[i];
+			row.class_name = class_name[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> parameter;
+		std::vector<double> value;
+		Poco::Data::Statement select(session);
+		select << "SELECT costfunction_id, parameter, value FROM simulation_continuouscostfunction",
+				into(id), into(parameter), into(value);
+		select.execute();
+		rows.cost_parameters.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			CostParameterRow & row = rows.cost_parameters[i];
+			row.cost_function_id = id[i];
+			row.parameter = parameter[i];
+			row.value = value[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id, resource_id, sensitivity_id, value_id, cost_id;
+		std::vector<std::string> name, optimization, modeling;
+		std::vector<double> min_value, max_value;
+		Poco::Data::Statement select(session);
+		select << "SELECT id, name, optimization, min_value, max_value, resource_id, modeling, sensitivity_distribution_id, value_distribution_id, cost_function_id FROM simulation_decisionvariable",
+				into(id), into(name), into(optimization), into(min_value), into(max_value),
+				into(resource_id), into(modeling), into(sensitivity_id), into(value_id),
+				into(cost_id);
+		select.execute();
+		rows.decision_variables.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			DecisionVariableRow & row = rows.decision_variables[i];
+			row.id = id[i];
+			row.name = name[i];
+			row.optimization = optimization[i];
+			row.min_value = min_value[i];
+			row.max_value = max_value[i];
+			row.resource_id = resource_id[i];
+			row.modeling = modeling[i];
+			row.sensitivity_distribution_id = sensitivity_id[i];
+			row.value_distribution_id = value_id[i];
+			row.cost_function_id = cost_id[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> id;
+		std::vector<std::string> name, file_name_demand, converter_origin, file_name_converter;
+		Poco::Data::Statement select(session);
+		select << "SELECT id, name, file_name_demand, converter_origin, file_name_converter FROM simulation_service",
+				into(id), into(name), into(file_name_demand), into(converter_origin),
+				into(file_name_converter);
+		select.execute();
+		rows.services.resize(id.size());
+		for (std::size_t i = 0; i < id.size(); ++i)
+		{
+			ServiceRow & row = rows.services[i];
+			row.id = id[i];
+			row.name = name[i];
+			row.file_name_demand = file_name_demand[i];
+			row.converter_origin = converter_origin[i];
+			row.file_name_converter = file_name_converter[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> service_id, variable_id;
+		Poco::Data::Statement select(session);
+		select << "SELECT id_service_id, id_decision_variable_id FROM simulation_service_decisionvariable",
+				into(service_id), into(variable_id);
+		select.execute();
+		rows.service_variables.resize(service_id.size());
+		for (std::size_t i = 0; i < service_id.size(); ++i)
+		{
+			rows.service_variables[i].service_id = service_id[i];
+			rows.service_variables[i].decision_variable_id = variable_id[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		std::vector<int> service_id;
+		std::vector<double> average, variance;
+		Poco::Data::Statement select(session);
+		select << "SELECT service_id, average, variance FROM simulation_consumerservice",
+				into(service_id), into(average), into(variance);
+		select.execute();
+		rows.traffic.resize(service_id.size());
+		for (std::size_t i = 0; i < service_id.size(); ++i)
+		{
+			rows.traffic[i].service_id = service_id[i];
+			rows.traffic[i].average = average[i];
+			rows.traffic[i].variance = variance[i];
+		}
+	});
+
+	loads.push_back([&rows](Poco::Data::Session & session)
+	{
+		Poco::Data::Statement select(session);
+		select << "select distinct b.service_id from simulation_consumer a, simulation_consumerservice b where a.id = b.consumer_id and b.execute = 1",
+				into(rows.services_to_execute);
+		select.execute();
+	});
+
+	run(loads);
+
+	app.logger().information(Poco::format("Configuration read: %z services, %z decision variables, %z distributions",
+							 rows.services.size(), rows.decision_variables.size(),
+							 rows.distributions.size()));
+}
+
+void ConfigurationLoader::readGeneralParameters(Poco::Data::Session & session, bool countExecution,
+												GeneralParametersRow & row)
+{
+	if (countExecution){
+		Poco::Data::Statement insert(session);
+		insert << _count_update;
+		insert.execute();
+	}
+
+	std::vector<int> bid_periods, pareto_fronts_to_exchange, execution_count;
+	Poco::Data::Statement select(session);
+	select << "select bid_periods, pareto_fronts_to_exchange, execution_count from simulation_generalparameters limit 1",
+			into(bid_periods), into(pareto_fronts_to_exchange), into(execution_count);
+	select.execute();
+	session.commit();
+
+	row.bid_periods = 0;
+	row.pareto_fronts_to_exchange = 0;
+	row.execution_count = 0;
+	if (bid_periods.empty() == false)
+	{
+		row.bid_periods = bid_periods[0];
+		row.pareto_fronts_to_exchange = pareto_fronts_to_exchange[0];
+		row.execution_count = execution_count[0];
+	}
+}
+
+void ConfigurationLoader::run(std::vector<TableLoad> & loads)
+{
+	std::atomic<std::size_t> next(0);
+	Poco::FastMutex mutex;
+	std::string error;
+
+	unsigned count = _threads;
+	if (count > loads.size())
+		count = loads.size();
+
+	std::vector<TableLoadWorker *> workers;
+	std::vector<Poco::Thread *> threads;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		workers.push_back(new TableLoadWorker(_pool, loads, next, mutex, error));
+		threads.push_back(new Poco::Thread());
+		threads[i]->start(*workers[i]);
+	}
+	for (unsigned i = 0; i < count; ++i)
+	{
+		threads[i]->join();
+		delete threads[i];
+		delete workers[i];
+	}
+
+	if (error.empty() == false)
+		throw FoundationException("Could not read the configuration: " + error, 338);
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,259 @@
+#include "ConfigurationSnapshot.h"
+#include "SnapshotFile.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+static const char CONFIG_SNAPSHOT_MAGIC[8] = { 'E', 'C', 'O', 'C', 'F', 'G', '0', '1' };
+
+void ConfigurationSnapshot::encode(const ConfigurationRows & rows, std::string & payload)
+{
+	SnapshotWriter out(payload);
+
+	out.putInt(rows.general.bid_periods);
+	out.putInt(rows.general.pareto_fronts_to_exchange);
+	out.putInt(rows.general.execution_count);
+
+	out.putCount(rows.resources.size());
+	for (std::size_t i = 0; i < rows.resources.size(); ++i)
+	{
+		out.putInt(rows.resources[i].id);
+		out.putString(rows.resources[i].name);
+	}
+
+	out.putCount(rows.distributions.size());
+	for (std::size_t i = 0; i < rows.distributions.size(); ++i)
+	{
+		const DistributionRow & row = rows.distributions[i];
+		out.putInt(row.id);
+		out.putString(row.name);
+		out.putString(row.domain);
+		out.putString(row.class_name);
+	}
+
+	out.putCount(rows.distribution_points.size());
+	for (std::size_t i = 0; i < rows.distribution_points.size(); ++i)
+	{
+		const DistributionPointRow & row = rows.distribution_points[i];
+		out.putInt(row.distribution_id);
+		out.putDouble(row.value);
+		out.putDouble(row.probability);
+	}
+
+	out.putCount(rows.distribution_parameters.size());
+	for (std::size_t i = 0; i < rows.distribution_parameters.size(); ++i)
+	{
+		const DistributionParameterRow & row = rows.distribution_parameters[i];
+		out.putInt(row.distribution_id);
+		out.putString(row.parameter);
+		out.putDouble(row.value);
+	}
+
+	out.putCount(rows.cost_functions.size());
+	for (std::size_t i = 0; i < rows.cost_functions.size(); ++i)
+	{
+		const CostFunctionRow & row = rows.cost_functions[i];
+		out.putInt(row.id);
+		out.putString(row.name);
+		out.putString(row.range);
+		out.putString(row.class_name);
+	}
+
+	out.putCount(rows.cost_parameters.size());
+	for (std::size_t i = 0; i < rows.cost_parameters.size(); ++i)
+	{
+		const CostParameterRow & row = rows.cost_parameters[i];
+		out.putInt(row.cost_function_id);
+		out.putString(row.parameter);
+		out.putDouble(row.value);
+	}
+
+	out.putCount(rows.decision_variables.size());
+	for (std::size_t i = 0; i < rows.decision_variables.size(); ++i)
+	{
+		const DecisionVariableRow & row = rows.decision_variables[i];
+		out.putInt(row.id);
+		out.putString(row.name);
+		out.putString(row.optimization);
+		out.putDouble(row.min_value);
+		out.putDouble(row.max_value);
+		out.putInt(row.resource_id);
+		out.putString(row.modeling);
+		out.putInt(row.sensitivity_distribution_id);
+		out.putInt(row.value_distribution_id);
+		out.putInt(row.cost_function_id);
+	}
+
+	out.putCount(rows.services.size());
+	for (std::size_t i = 0; i < rows.services.size(); ++i)
+	{
+		const ServiceRow & row = rows.services[i];
+		out.putInt(row.id);
+		out.putString(row.name);
+		out.putString(row.file_name_demand);
+		out.putString(row.converter_origin);
+		out.putString(row.file_name_converter);
+	}
+
+	out.putCount(rows.service_variables.size());
+	for (std::size_t i = 0; i < rows.service_variables.size(); ++i)
+	{
+		out.putInt(rows.service_variables[i].service_id);
+		out.putInt(rows.service_variables[i].decision_variable_id);
+	}
+
+	out.putCount(rows.traffic.size());
+	for (std::size_t i = 0; i < rows.traffic.size(); ++i)
+	{
+		out.putInt(rows.traffic[i].service_id);
+		out.putDouble(rows.traffic[i].average);
+		out.putDouble(rows.traffic[i].variance);
+	}
+
+	out.putCount(rows.services_to_execute.size());
+	for (std::size_t i = 0; i < rows.services_to_execute.size(); ++i)
+		out.putInt(rows.services_to_execute[i]);
+}
+
+bool ConfigurationSnapshot::decode(const char * begin, const char * end, ConfigurationRows & rows)
+{
+	SnapshotReader in(begin, end);
+
+	rows.general.bid_periods = in.getInt();
+	rows.general.pareto_fronts_to_exchange = in.getInt();
+	rows.general.execution_count = in.getInt();
+
+	// The smallest encoding of a row bounds the count read before it.
+	rows.resources.resize(in.getCount(8));
+	for (std::size_t i = 0; i < rows.resources.size(); ++i)
+	{
+		rows.resources[i].id = in.getInt();
+		rows.resources[i].name = in.getString();
+	}
+
+	rows.distributions.resize(in.getCount(16));
+	for (std::size_t i = 0; i < rows.distributions.size(); ++i)
+	{
+		DistributionRow & row = rows.distributions[i];
+		row.id = in.getInt();
+		row.name = in.getString();
+		row.domain = in.getString();
+		row.class_name = in.getString();
+	}
+
+	rows.distribution_points.resize(in.getCount(20));
+	for (std::size_t i = 0; i < rows.distribution_points.size(); ++i)
+	{
+		DistributionPointRow & row = rows.distribution_points[i];
+		row.distribution_id = in.getInt();
+		row.value = in.getDouble();
+		row.probability = in.getDouble();
+	}
+
+	rows.distribution_parameters.resize(in.getCount(16));
+	for (std::size_t i = 0; i < rows.distribution_parameters.size(); ++i)
+	{
+		DistributionParameterRow & row = rows.distribution_parameters[i];
+		row.distribution_id = in.getInt();
+		row.parameter = in.getString();
+		row.value = in.getDouble();
+	}
+
+	rows.cost_functions.resize(in.getCount(16));
+	for (std::size_t i = 0; i < rows.cost_functions.size(); ++i)
+	{
+		CostFunctionRow & row = rows.cost_functions[i];
+		row.id = in.getInt();
+		row.name = in.getString();
+		row.range = in.getString();
+		row.class_name = in.getString();
+	}
+
+	rows.cost_parameters.resize(in.getCount(16));
+	for (std::size_t i = 0; i < rows.cost_parameters.size(); ++i)
+	{
+		CostParameterRow & row = rows.cost_parameters[i];
+		row.cost_function_id = in.getInt();
+		row.parameter = in.getString();
+		row.value = in.getDouble();
+	}
+
+	rows.decision_variables.resize(in.getCount(52));
+	for (std::size_t i = 0; i < rows.decision_variables.size(); ++i)
+	{
+		DecisionVariableRow & row = rows.decision_variables[i];
+		row.id = in.getInt();
+		row.name = in.getString();
+		row.optimization = in.getString();
+		row.min_value = in.getDouble();
+		row.max_value = in.getDouble();
+		row.resource_id = in.getInt();
+		row.modeling = in.getString();
+		row.sensitivity_distribution_id = in.getInt();
+		row.value_distribution_id = in.getInt();
+		row.cost_function_id = in.getInt();
+	}
+
+	rows.services.resize(in.getCount(20));
+	for (std::size_t i = 0; i < rows.services.size(); ++i)
+	{
+		ServiceRow & row = rows.services[i];
+		row.id = in.getInt();
+		row.name = in.getString();
+		row.file_name_demand = in.getString();
+		row.converter_origin = in.getString();
+		row.file_name_converter = in.getString();
+	}
+
+	rows.service_variables.resize(in.getCount(8));
+	for (std::size_t i = 0; i < rows.service_variables.size(); ++i)
+	{
+		rows.service_variables[i].service_id = in.getInt();
+		rows.service_variables[i].decision_variable_id = in.getInt();
+	}
+
+	rows.traffic.resize(in.getCount(20));
+	for (std::size_t i = 0; i < rows.traffic.size(); ++i)
+	{
+		rows.traffic[i].service_id = in.getInt();
+		rows.traffic[i].average = in.getDouble();
+		rows.traffic[i].variance = in.getDouble();
+	}
+
+	rows.services_to_execute.resize(in.getCount(4));
+	for (std::size_t i = 0; i < rows.services_to_execute.size(); ++i)
+		rows.services_to_execute[i] = in.getInt();
+
+	return in.done();
+}
+
+void ConfigurationSnapshot::write(const std::string & path, const ConfigurationRows & rows)
+{
+	std::string payload;
+	encode(rows, payload);
+	SnapshotFile::write(path, CONFIG_SNAPSHOT_MAGIC, VERSION, payload, "configuration snapshot");
+}
+
+bool ConfigurationSnapshot::read(const std::string & path, ConfigurationRows & rows,
+								 std::string & reason)
+{
+	std::string payload;
+	if (SnapshotFile::read(path, CONFIG_SNAPSHOT_MAGIC, VERSION, "configuration snapshot",
+						   payload, reason) == false)
+		return false;
+
+	if (decode(payload.data(), payload.data() + payload.size(), rows) == false)
+	{
+		reason = "malformed rows";
+		return false;
+	}
+	return true;
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
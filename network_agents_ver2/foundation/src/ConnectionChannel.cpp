@@ -0,0 +1,95 @@
+#include <vector>
+
+#include "ConnectionChannel.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ConnectionChannel::ConnectionChannel(ConnectionWriter * connection, WaitingSocketReactor & reactor):
+_connection(connection),
+_reactor(reactor),
+_next_sequence(0),
+_next_to_write(0)
+{
+}
+
+ConnectionChannel::~ConnectionChannel()
+{
+	_connection = NULL;
+}
+
+unsigned ConnectionChannel::reserve()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _next_sequence++;
+}
+
+void ConnectionChannel::complete(unsigned sequence, const std::string & response)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_completed.insert(std::pair<unsigned, std::string>(sequence, response));
+}
+
+void ConnectionChannel::deliver(unsigned sequence, const std::string & response)
+{
+	complete(sequence, response);
+
+	if (_reactor.isReactorThread())
+	{
+		flush();
+		return;
+	}
+
+	Poco::AutoPtr<ConnectionChannel> channel(this, true);
+	_reactor.post([channel]() { channel->flush(); });
+}
+
+void ConnectionChannel::flush()
+{
+	std::vector<std::string> ready;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		std::map<unsigned, std::string>::iterator it = _completed.find(_next_to_write);
+		while (it != _completed.end())
+		{
+			ready.push_back(it->second);
+			_completed.erase(it);
+			++_next_to_write;
+			it = _completed.find(_next_to_write);
+		}
+	}
+
+	if (_connection != NULL)
+	{
+		std::vector<std::string>::iterator it_ready;
+		for (it_ready = ready.begin(); it_ready != ready.end(); ++it_ready)
+		{
+			_connection->writeResponse(*it_ready);
+		}
+	}
+}
+
+void ConnectionChannel::detach()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_connection = NULL;
+	_completed.clear();
+}
+
+bool ConnectionChannel::isAttached()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return (_connection != NULL);
+}
+
+WaitingSocketReactor & ConnectionChannel::getReactor()
+{
+	return _reactor;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
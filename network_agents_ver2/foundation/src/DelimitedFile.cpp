@@ -0,0 +1,301 @@
+#include <Poco/File.h>
+#include <Poco/Exception.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "DelimitedFile.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+Poco::FastMutex DelimitedFile::_shared_mutex;
+std::map<std::string, Poco::SharedPtr<DelimitedFile> > DelimitedFile::_shared_files;
+
+static inline bool isBlank(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') ||
+		   (c == '\v') || (c == '\f');
+}
+
+DelimitedFile::DelimitedFile(char separator):
+_separator(separator),
+_data(NULL),
+_min_count(0),
+_max_count(0)
+{
+}
+
+DelimitedFile::~DelimitedFile()
+{
+}
+
+bool DelimitedFile::open(const std::string & path)
+{
+	_data = NULL;
+	_fields.clear();
+	_lines.clear();
+	_keys.clear();
+	_min_count = 0;
+	_max_count = 0;
+
+	try
+	{
+		Poco::File file(path);
+		if ((file.exists() == false) || (file.isFile() == false))
+			return false;
+
+		std::size_t length = (std::size_t) file.getSize();
+		if (length > 0)
+		{
+			// An empty file cannot be mapped, it just has no lines.
+			_mapping = Poco::SharedMemory(file, Poco::SharedMemory::AM_READ);
+			_data = _mapping.begin();
+		}
+		split(length);
+	}
+	catch (Poco::Exception &e)
+	{
+		return false;
+	}
+	return true;
+}
+
+void DelimitedFile::split(std::size_t length)
+{
+	std::size_t pos = 0;
+	while (pos < length)
+	{
+		std::size_t end = pos;
+		while ((end < length) && (_data[end] != '\n'))
+			++end;
+
+		std::size_t line = _lines.size();
+		_lines.push_back(_fields.size());
+
+		std::size_t stop = end;
+		if ((stop > pos) && (_data[stop - 1] == '\r'))
+			--stop;
+
+		if (stop > pos)
+		{
+			std::size_t start = pos;
+			for (std::size_t i = pos; i <= stop; ++i)
+			{
+				if ((i == stop) || (_data[i] == _separator))
+				{
+					// Trimmed like the tokenizer does.
+					std::size_t first = start;
+					std::size_t last = i;
+					while ((first < last) && isBlank(_data[first]))
+						++first;
+					while ((last > first) && isBlank(_data[last - 1]))
+						--last;
+
+					Field field;
+					field.offset = first;
+					field.length = last - first;
+					_fields.push_back(field);
+					start = i + 1;
+				}
+			}
+
+			std::string key(_data + _fields[_lines[line]].offset, _fields[_lines[line]].length);
+			_keys.insert(std::make_pair(key, line));
+		}
+
+		std::size_t fields = _fields.size() - _lines[line];
+		if ((line == 0) || (fields < _min_count))
+			_min_count = fields;
+		if (fields > _max_count)
+			_max_count = fields;
+
+		pos = end + 1;
+	}
+	_lines.push_back(_fields.size());
+}
+
+std::size_t DelimitedFile::size() const
+{
+	return _lines.empty() ? 0 : _lines.size() - 1;
+}
+
+std::size_t DelimitedFile::count(std::size_t line) const
+{
+	return _lines[line + 1] - _lines[line];
+}
+
+bool DelimitedFile::hasCount(std::size_t fields) const
+{
+	return (size() == 0) || ((_min_count == fields) && (_max_count == fields));
+}
+
+const DelimitedFile::Field * DelimitedFile::getField(std::size_t line, std::size_t field) const
+{
+	if ((line >= size()) || (field >= count(line)))
+		return NULL;
+	return &_fields[_lines[line] + field];
+}
+
+std::string DelimitedFile::get(std::size_t line, std::size_t field) const
+{
+	const Field * found = getField(line, field);
+	if (found == NULL)
+		return std::string();
+	return std::string(_data + found->offset, found->length);
+}
+
+bool DelimitedFile::parseFloat(std::size_t line, std::size_t field, double & value) const
+{
+	const Field * found = getField(line, field);
+	if (found == NULL)
+		return false;
+	return parseFloat(_data + found->offset, _data + found->offset + found->length, value);
+}
+
+bool DelimitedFile::parseUnsigned(std::size_t line, std::size_t field, unsigned & value) const
+{
+	const Field * found = getField(line, field);
+	if (found == NULL)
+		return false;
+	return parseUnsigned(_data + found->offset, _data + found->offset + found->length, value);
+}
+
+bool DelimitedFile::find(const std::string & key, std::size_t & line) const
+{
+	std::unordered_map<std::string, std::size_t>::const_iterator it = _keys.find(key);
+	if (it == _keys.end())
+		return false;
+	line = it->second;
+	return true;
+}
+
+Poco::SharedPtr<DelimitedFile> DelimitedFile::shared(const std::string & path, char separator)
+{
+	Poco::FastMutex::ScopedLock lock(_shared_mutex);
+
+	std::map<std::string, Poco::SharedPtr<DelimitedFile> >::iterator it = _shared_files.find(path);
+	if (it != _shared_files.end())
+		return it->second;
+
+	Poco::SharedPtr<DelimitedFile> file = new DelimitedFile(separator);
+	if (file->open(path) == false)
+		return Poco::SharedPtr<DelimitedFile>();
+
+	_shared_files.insert(std::make_pair(path, file));
+	return file;
+}
+
+void DelimitedFile::clearShared()
+{
+	Poco::FastMutex::ScopedLock lock(_shared_mutex);
+	_shared_files.clear();
+}
+
+bool DelimitedFile::parseUnsigned(const char * begin, const char * end, unsigned & value)
+{
+	if (begin == end)
+		return false;
+
+	Poco::UInt64 result = 0;
+	for (const char * p = begin; p != end; ++p)
+	{
+		if ((*p < '0') || (*p > '9'))
+			return false;
+		result = (result * 10) + (*p - '0');
+		if (result > 0xFFFFFFFFULL)
+			return false;
+	}
+	value = (unsigned) result;
+	return true;
+}
+
+bool DelimitedFile::parseFloat(const char * begin, const char * end, double & value)
+{
+	static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+									 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+	if (begin == end)
+		return false;
+
+	// [sign] digits [. digits], with at most 15 significant digits: the
+	// mantissa and the power of ten are exact doubles, so one division
+	// rounds the same way strtod does.
+	const char * p = begin;
+	bool negative = false;
+	if ((*p == '-') || (*p == '+'))
+	{
+		negative = (*p == '-');
+		++p;
+	}
+
+	Poco::UInt64 mantissa = 0;
+	unsigned digits = 0;
+	unsigned decimals = 0;
+	bool seen_digit = false;
+	bool seen_point = false;
+	bool fast = true;
+	for (; p != end; ++p)
+	{
+		if ((*p >= '0') && (*p <= '9'))
+		{
+			seen_digit = true;
+			if ((mantissa == 0) && (*p == '0'))
+			{
+				// Leading zeros are not significant.
+				if (seen_point)
+					++decimals;
+				continue;
+			}
+			if (++digits > 15)
+			{
+				fast = false;
+				break;
+			}
+			mantissa = (mantissa * 10) + (*p - '0');
+			if (seen_point)
+				++decimals;
+		}
+		else if ((*p == '.') && (seen_point == false))
+		{
+			seen_point = true;
+		}
+		else
+		{
+			// Exponents, infinities and the like.
+			fast = false;
+			break;
+		}
+	}
+
+	if ((fast == true) && (seen_digit == true) && (decimals <= 15))
+	{
+		double result = (double) mantissa;
+		if (decimals > 0)
+			result = result / powers[decimals];
+		value = negative ? -result : result;
+		return true;
+	}
+
+	// Fall back on strtod with a terminated copy of the field.
+	std::size_t length = end - begin;
+	char buffer[128];
+	if (length >= sizeof(buffer))
+		return false;
+	std::memcpy(buffer, begin, length);
+	buffer[length] = '\0';
+
+	char * parsed = NULL;
+	double result = std::strtod(buffer, &parsed);
+	if ((parsed == buffer) || (*parsed != '\0'))
+		return false;
+	value = result;
+	return true;
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,211 @@
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/Exception.h>
+#include <fstream>
+#include <cstring>
+
+#include "DemandSeries.h"
+#include "DelimitedFile.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+static const char DEMAND_CACHE_MAGIC[8] = { 'E', 'C', 'O', 'D', 'M', 'D', '0', '1' };
+
+DemandSeries::DemandSeries():
+_from_cache(false)
+{
+}
+
+DemandSeries::~DemandSeries()
+{
+}
+
+std::string DemandSeries::getCachePath(const std::string & path)
+{
+	return path + ".cache";
+}
+
+void DemandSeries::load(const std::string & path, bool cache)
+{
+	_values.clear();
+	_from_cache = false;
+
+	Poco::File source(path);
+	if (source.exists() == false)
+	{
+		std::string message = "Demand file was not found";
+		message.append(path);
+		throw FoundationException(message, 333);
+	}
+
+	Poco::Int64 modified = source.getLastModified().epochMicroseconds();
+	Poco::UInt64 source_size = source.getSize();
+
+	if ((cache == true) && readCache(path, modified, source_size))
+	{
+		_from_cache = true;
+		return;
+	}
+
+	parse(path);
+
+	if (cache == true)
+		writeCache(path, modified, source_size);
+}
+
+void DemandSeries::parse(const std::string & path)
+{
+	DelimitedFile file(':');
+	if (file.open(path) == false)
+	{
+		std::string message = "Demand file was not found";
+		message.append(path);
+		throw FoundationException(message, 333);
+	}
+
+	_values.reserve(file.size());
+	for (std::size_t line = 0; line < file.size(); ++line)
+	{
+		if (file.count(line) != 2)
+		{
+			// we have to raise an exception because the file is not well formed.
+			throw FoundationException("Demand line not in the correct format( period : value )" , 332);
+		}
+
+		unsigned period = 0;
+		double value = 0;
+		if ((file.parseUnsigned(line, 0, period) == false) ||
+			(file.parseFloat(line, 1, value) == false))
+		{
+			throw FoundationException("Invalid value in demand file", 331);
+		}
+
+		// Validates typical poblems in data
+		if (value < 0)
+		{
+			std::string message = "Invalid value in demand file for period ";
+			Poco::NumberFormatter::append(message, period);
+			throw FoundationException(message);
+		}
+
+		if ((period >= 1) && (period <= _values.size()))
+		{
+			std::string message = "Period ";
+			Poco::NumberFormatter::append(message, period);
+			message.append(" is already given as parameter");
+			throw FoundationException(message);
+		}
+
+		if (period != (_values.size() + 1))
+		{
+			std::string message = "Period ";
+			Poco::NumberFormatter::append(message, period);
+			message.append(" is not consecutive and create a partitioned interval");
+			throw FoundationException(message, 330);
+		}
+
+		_values.push_back(value);
+	}
+}
+
+bool DemandSeries::readCache(const std::string & path, Poco::Int64 modified,
+							 Poco::UInt64 source_size)
+{
+	Poco::File cacheFile(getCachePath(path));
+	if ((cacheFile.exists() == false) || (cacheFile.getSize() < sizeof(CacheHeader)))
+		return false;
+
+	try
+	{
+		Poco::SharedMemory mapping(cacheFile, Poco::SharedMemory::AM_READ);
+		std::size_t mapped = mapping.end() - mapping.begin();
+
+		CacheHeader header;
+		std::memcpy(&header, mapping.begin(), sizeof(CacheHeader));
+		if ((std::memcmp(header.magic, DEMAND_CACHE_MAGIC, sizeof(header.magic)) != 0) ||
+			(header.modified != modified) || (header.source_size != source_size) ||
+			(mapped != sizeof(CacheHeader) + header.count * sizeof(double)))
+		{
+			// Written for another version of the file.
+			return false;
+		}
+
+		_values.resize((std::size_t) header.count);
+		if (header.count > 0)
+			std::memcpy(&_values[0], mapping.begin() + sizeof(CacheHeader),
+						(std::size_t) header.count * sizeof(double));
+	}
+	catch (Poco::Exception &e)
+	{
+		_values.clear();
+		return false;
+	}
+	return true;
+}
+
+void DemandSeries::writeCache(const std::string & path, Poco::Int64 modified,
+							  Poco::UInt64 source_size)
+{
+	CacheHeader header;
+	std::memset(&header, 0, sizeof(CacheHeader));
+	std::memcpy(header.magic, DEMAND_CACHE_MAGIC, sizeof(header.magic));
+	header.modified = modified;
+	header.source_size = source_size;
+	header.count = _values.size();
+
+	// Written aside and renamed, a reader never maps half a cache. The
+	// cache is only an accelerator, a directory we cannot write is fine.
+	std::string cachePath = getCachePath(path);
+	std::string tmpPath = cachePath + ".tmp";
+	try
+	{
+		std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+		if (out.is_open() == false)
+			return;
+		out.write((const char *) &header, sizeof(CacheHeader));
+		if (_values.empty() == false)
+			out.write((const char *) &_values[0], _values.size() * sizeof(double));
+		out.close();
+		if (out.fail())
+		{
+			Poco::File(tmpPath).remove();
+			return;
+		}
+		Poco::File(tmpPath).renameTo(cachePath);
+	}
+	catch (Poco::Exception &e)
+	{
+	}
+}
+
+double DemandSeries::get(unsigned period) const
+{
+	if ((period == 0) || _values.empty())
+		return 0;
+
+	if (period <= _values.size())
+		return _values[period - 1];
+
+	return _values[(period - 1) % _values.size()];
+}
+
+std::size_t DemandSeries::size() const
+{
+	return _values.size();
+}
+
+bool DemandSeries::isFromCache() const
+{
+	return _from_cache;
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,118 @@
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/Exception.h>
+#include <fstream>
+
+#include "FileStorageBackend.h"
+#include "ConfigurationSnapshot.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+static const std::string FILE_STORAGE_NAME = "file";
+
+FileStorageBackend::FileStorageBackend(const std::string & directory,
+									   const std::string & snapshot):
+_directory(directory),
+_snapshot(snapshot)
+{
+	Poco::File(_directory).createDirectories();
+}
+
+FileStorageBackend::~FileStorageBackend()
+{
+}
+
+const std::string & FileStorageBackend::getName() const
+{
+	return FILE_STORAGE_NAME;
+}
+
+void FileStorageBackend::readConfiguration(bool countExecution, unsigned threads,
+										   ConfigurationRows & rows)
+{
+	std::string reason;
+	if (ConfigurationSnapshot::read(_snapshot, rows, reason) == false)
+		throw FoundationException("Configuration snapshot " + _snapshot + " not usable: " + reason, 342);
+	rows.general.execution_count = readExecutionCount(countExecution, rows.general.execution_count);
+}
+
+int FileStorageBackend::readExecutionCount(bool countExecution, int configured)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Poco::Path path(_directory);
+	path.makeDirectory();
+	path.setFileName("execution_count");
+
+	int executionCount = configured;
+	std::ifstream in(path.toString().c_str());
+	if (in.is_open())
+	{
+		int stored = 0;
+		if (!(in >> stored))
+			throw FoundationException("Invalid execution count in " + path.toString(), 348);
+		if (stored > executionCount)
+			executionCount = stored;
+	}
+	in.close();
+
+	if (countExecution)
+	{
+		++executionCount;
+
+		// Replaced once written, a crash leaves the previous count.
+		std::string tmpPath = path.toString() + ".tmp";
+		std::ofstream out(tmpPath.c_str(), std::ios::trunc);
+		out << executionCount << "\n";
+		out.close();
+		if (out.fail())
+			throw FoundationException("Could not write " + tmpPath, 348);
+		try
+		{
+			Poco::File(tmpPath).renameTo(path.toString());
+		}
+		catch (Poco::FileException &e)
+		{
+			throw FoundationException("Could not write the execution count: " + e.displayText(), 348);
+		}
+	}
+	return executionCount;
+}
+
+void FileStorageBackend::write(const std::vector<BulkInsert *> & inserts)
+{
+	// Several threads may store periods; a line is never split between them.
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (std::size_t i = 0; i < inserts.size(); ++i)
+	{
+		if (inserts[i]->size() == 0)
+			continue;
+
+		Poco::Path path(_directory);
+		path.makeDirectory();
+		path.setFileName(inserts[i]->getTable() + ".tsv");
+		bool exists = Poco::File(path).exists();
+
+		std::string text;
+		if (exists == false)
+			text = inserts[i]->getColumns() + "\n";
+		inserts[i]->appendText(text);
+
+		std::ofstream out(path.toString().c_str(), std::ios::binary | std::ios::app);
+		out.write(text.data(), text.size());
+		out.close();
+		if (out.fail())
+			throw FoundationException("Could not append to " + path.toString(), 343);
+	}
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
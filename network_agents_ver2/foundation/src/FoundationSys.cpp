@@ -2,12 +2,15 @@
 #include <Poco/NumberFormatter.h>
 #include <Poco/Data/SessionFactory.h>
 #include <Poco/Data/MySQL/Connector.h>
+#include <Poco/Data/SQLite/Connector.h>
 #include <iostream>
 #include <Poco/Exception.h>
 #include <Poco/Net/NetException.h>
 
 #include "config.h"
 #include "FoundationSys.h"
+#include "ConfigurationSnapshot.h"
+#include "DelimitedFile.h"
 #include "FoundationException.h"
 #include "ProcError.h"
 
@@ -19,6 +22,7 @@ namespace Eco
 {
 
 FoundationSys::FoundationSys(AgentType type):
+_storage(NULL),
 _pool(NULL),
 _bid_periods(0),
 _pareto_fronts_to_exchange(0),
@@ -27,6 +31,7 @@ _type(type),
 _loader(NULL)
 {
 	Poco::Data::MySQL::Connector::registerConnector();
+	Poco::Data::SQLite::Connector::registerConnector();
 }
 
 FoundationSys::~FoundationSys(void)
@@ -85,10 +90,11 @@ FoundationSys::~FoundationSys(void)
 	}
 
 	app.logger().debug("Disconnecting from the database");
-	if (_pool != NULL)
-		delete _pool;
+	if (_storage != NULL)
+		delete _storage;
 
 	Poco::Data::MySQL::Connector::unregisterConnector();
+	Poco::Data::SQLite::Connector::unregisterConnector();
 
 	app.logger().debug("Eliminating modules");
 	if (_loader != NULL){
@@ -100,30 +106,11 @@ FoundationSys::~FoundationSys(void)
 
 void FoundationSys::initialize(Poco::Util::Application &app, int bid_periods, int pareto_fronts)
 {
-
 	try{//
-		// Connection string to POCO
-		std::string db_host = (std::string)
-					app.config().getString("db_host");
-
-		unsigned short db_port = (unsigned short)
-					app.config().getInt("db_port",3306);
-
-		std::string db_user = (std::string)
-					app.config().getString("db_user","root");
-
-		std::string db_password = (std::string)
-					app.config().getString("db_password","password");
-
-		std::string db_name = (std::string)
-					app.config().getString("db_name","Network_Simulation");
-
-		std::string sPort = Poco::NumberFormatter::format(db_port);
-		std::string connectionStr = "host=" + db_host + ";port=" + sPort + ";user=" + db_user + ";password=" + db_password + ";db=" + db_name;
-
-		std::cout << "connectionStr:" << connectionStr << std::endl;
-		app.logger().information("Connecting with the database");
-		_pool = new Poco::Data::SessionPool("MySQL", connectionStr);
+		// A database pool connects when the first session is taken.
+		_storage = StorageBackend::create(app.config());
+		_pool = _storage->getPool();
+		app.logger().information("Storage backend " + _storage->getName());
 
 	} catch (Poco::NotFoundException &e) {
     	throw FoundationException("Foundation information not found");
@@ -131,8 +118,61 @@ void FoundationSys::initialize(Poco::Util::Application &app, int bid_periods, in
 		throw FoundationException(e.what(), e.code());
 	}
 
+	// With config_source=snapshot the configuration comes from the snapshot
+	// written by a previous run, and the storage is not read unless the
+	// snapshot cannot be used.
+	std::string snapshot = app.config().getString("config_snapshot", "");
+	if ((snapshot.empty() == false) &&
+		(app.config().getString("config_source", "database").compare("snapshot") == 0))
+	{
+		ConfigurationRows rows;
+		std::string reason;
+		if (ConfigurationSnapshot::read(snapshot, rows, reason))
+		{
+			app.logger().information("Configuration read from the snapshot " + snapshot);
+
+			// The snapshot has the count of the run that wrote it. The
+			// clock server still takes a new one from the storage, so the
+			// runs do not mix their results; it does not start without it.
+			rows.general.execution_count = _storage->readExecutionCount(getType() == CLOCK_SERVER,
+																		rows.general.execution_count);
+			loadConfiguration(app, rows, bid_periods, pareto_fronts);
+			return;
+		}
+		app.logger().warning(Poco::format("Configuration snapshot %s not used (%s), reading the storage",
+							 snapshot, reason));
+	}
+
+	// The row by row readers need a database.
+	if ((_pool == NULL) || app.config().getBool("db_bulk_load", true))
+	{
+		app.logger().debug("Read the configuration tables");
+		ConfigurationRows rows;
+		_storage->readConfiguration(getType() == CLOCK_SERVER,
+									(unsigned) app.config().getInt("db_load_threads", 4), rows);
+
+		// Without a database the rows came from the snapshot itself.
+		if ((snapshot.empty() == false) && (_pool != NULL))
+		{
+			try
+			{
+				ConfigurationSnapshot::write(snapshot, rows);
+				app.logger().information("Configuration snapshot written to " + snapshot);
+			}
+			catch (FoundationException &e)
+			{
+				app.logger().error(e.message());
+			}
+		}
+
+		loadConfiguration(app, rows, bid_periods, pareto_fronts);
+		app.logger().debug("Data has been read from the database");
+		return;
+	}
+
 	app.logger().debug("Read the general parameters");
 	readGeneralParametersFromDataBase();
+	_storage->startExecution(_execution_count);
 	if (_bid_periods == 0 ){
 		_bid_periods = bid_periods;
 	}
@@ -148,6 +188,45 @@ void FoundationSys::initialize(Poco::Util::Application &app, int bid_periods, in
 	app.logger().debug("Read the probability distributions");
 	readProbabilityDistributionsFromDataBase();
 
+	createModuleLoader(app);
+
+	app.logger().debug("Read the cost functions");
+	readCostFunctionsFromDataBase();
+
+	app.logger().debug("Read the decision variables");
+	readDecisionVariablesFromDataBase();
+
+	app.logger().debug("Read the services");
+	readServicesFromDataBase();
+
+	app.logger().debug("Read the service to execute");
+	readServiceToExecute();
+
+	app.logger().debug("Data has been read from the database");
+}
+
+void FoundationSys::loadConfiguration(Poco::Util::Application &app, const ConfigurationRows & rows,
+									  int bid_periods, int pareto_fronts)
+{
+	_bid_periods = rows.general.bid_periods;
+	_pareto_fronts_to_exchange = rows.general.pareto_fronts_to_exchange;
+	_execution_count = rows.general.execution_count;
+	_storage->startExecution(_execution_count);
+	if (_bid_periods == 0 ){
+		_bid_periods = bid_periods;
+	}
+
+	if (_pareto_fronts_to_exchange == 0)
+	{
+		_pareto_fronts_to_exchange = pareto_fronts;
+	}
+
+	createModuleLoader(app);
+	applyConfiguration(rows);
+}
+
+void FoundationSys::createModuleLoader(Poco::Util::Application &app)
+{
 	std::string moduleDir = (std::string)
 					app.config().getString("module_dir", DEF_LIBDIR);
 
@@ -161,20 +240,197 @@ void FoundationSys::initialize(Poco::Util::Application &app, int bid_periods, in
 		throw FoundationException(e.getError());
 	}
 	std::cout << "could create the loader:" << std::endl;
+}
 
-	app.logger().debug("Read the cost functions");
-	readCostFunctionsFromDataBase();
+void FoundationSys::applyConfiguration(const ConfigurationRows & rows)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
 
-	app.logger().debug("Read the decision variables");
-	readDecisionVariablesFromDataBase();
+	for (std::size_t i = 0; i < rows.resources.size(); ++i)
+	{
+		std::string resourceId;
+		Poco::NumberFormatter::append(resourceId, rows.resources[i].id);
+		Resource *resource = new Resource(resourceId);
+		resource->setName(rows.resources[i].name);
+		_resources.insert(std::pair<std::string, Resource *> (resource->getId(), resource));
+	}
 
-	app.logger().debug("Read the services");
-	readServicesFromDataBase();
+	// The points and parameters are grouped by distribution once, instead of
+	// being queried for each one.
+	std::map<int, std::vector<const DistributionPointRow *> > points;
+	for (std::size_t i = 0; i < rows.distribution_points.size(); ++i)
+		points[rows.distribution_points[i].distribution_id].push_back(&rows.distribution_points[i]);
 
-	app.logger().debug("Read the service to execute");
-	readServiceToExecute();
+	std::map<int, std::vector<const DistributionParameterRow *> > distParameters;
+	for (std::size_t i = 0; i < rows.distribution_parameters.size(); ++i)
+		distParameters[rows.distribution_parameters[i].distribution_id].push_back(&rows.distribution_parameters[i]);
 
-	app.logger().debug("Data has been read from the database");
+	for (std::size_t i = 0; i < rows.distributions.size(); ++i)
+	{
+		const DistributionRow & row = rows.distributions[i];
+		Domain domain;
+		if (row.domain.compare("C") == 0)
+			domain = DOM_CONTINUOUS;
+		else
+			domain = DOM_DISCRETE;
+
+		std::string probId;
+		Poco::NumberFormatter::append(probId, row.id);
+		ProbabilityDistribution * probDistribution = new ProbabilityDistribution(probId, row.class_name, domain);
+		if (domain == DOM_DISCRETE)
+		{
+			const std::vector<const DistributionPointRow *> & list = points[row.id];
+			for (std::size_t j = 0; j < list.size(); ++j)
+				probDistribution->addPoint(list[j]->value, list[j]->probability);
+		}
+		else
+		{
+			const std::vector<const DistributionParameterRow *> & list = distParameters[row.id];
+			for (std::size_t j = 0; j < list.size(); ++j)
+				probDistribution->addParameter(list[j]->parameter, list[j]->value);
+		}
+		insertProbabilityDistribution(probDistribution);
+	}
+
+	std::map<int, std::vector<const CostParameterRow *> > costParameters;
+	for (std::size_t i = 0; i < rows.cost_parameters.size(); ++i)
+		costParameters[rows.cost_parameters[i].cost_function_id].push_back(&rows.cost_parameters[i]);
+
+	for (std::size_t i = 0; i < rows.cost_functions.size(); ++i)
+	{
+		const CostFunctionRow & row = rows.cost_functions[i];
+		Range range;
+		if (row.range.compare("C") == 0)
+			range = RANGE_CONTINUOUS;
+		else
+			range = RANGE_DISCRETE;
+
+		std::string cstFunctionId;
+		Poco::NumberFormatter::append(cstFunctionId, row.id);
+		CostFunction * cstFunction = new CostFunction(cstFunctionId, row.class_name, range, _loader);
+		if (range == RANGE_CONTINUOUS)
+		{
+			try
+			{
+				// Load the class from modules.
+				Module *module = _loader->loadModule( cstFunction->getClassName() , 0, NULL );
+				CostModule *costmod = dynamic_cast<CostModule*>(module);
+				if (costmod != NULL){
+					cstFunction->setModule(costmod);
+					const std::vector<const CostParameterRow *> & list = costParameters[row.id];
+					for (std::size_t j = 0; j < list.size(); ++j)
+					{
+						app.logger().information(Poco::format("CostFunction:%d Parameter:%s - Value:%f",
+												 row.id, list[j]->parameter, list[j]->value ));
+
+						// Only add the parameter if not empty.
+						if (!list[j]->parameter.empty()){
+							cstFunction->addParameter(list[j]->parameter, list[j]->value);
+						}
+					}
+				}
+			} catch (ProcError &e){
+				throw FoundationException(e.getError());
+			}
+		}
+		insertCostFunction(cstFunction);
+	}
+
+	for (std::size_t i = 0; i < rows.decision_variables.size(); ++i)
+	{
+		const DecisionVariableRow & row = rows.decision_variables[i];
+		OptimizationObjective objetive;
+		if (row.optimization.compare("M") == 0)
+			objetive = MAXIME;
+		else
+			objetive = MINIMIZE;
+
+		Modeling modeling;
+		if (row.modeling.compare("Q") == 0)
+			modeling = MODEL_QUALITY;
+		else
+			modeling = MODEL_PRICE;
+
+		std::string decId, resourceId, sensitivityDistrId,valueDistrId, costFunctionId;
+		Poco::NumberFormatter::append(decId, row.id);
+		Poco::NumberFormatter::append(resourceId, row.resource_id);
+		Poco::NumberFormatter::append(sensitivityDistrId, row.sensitivity_distribution_id);
+		Poco::NumberFormatter::append(valueDistrId, row.value_distribution_id);
+		Poco::NumberFormatter::append(costFunctionId, row.cost_function_id);
+
+		DecisionVariable * decisionVar = new DecisionVariable(decId);
+		decisionVar->setName(row.name);
+		decisionVar->setModelling(modeling);
+		decisionVar->setRange(row.min_value, row.max_value);
+		decisionVar->setObjetive(objetive);
+		decisionVar->setResource(resourceId);
+		decisionVar->setProbabilityDistribution( SENSITIVITY, getProbabilityDistribution(sensitivityDistrId));
+		decisionVar->setProbabilityDistribution( VALUE, getProbabilityDistribution(valueDistrId));
+		if (row.cost_function_id > 0)
+			decisionVar->setCostFunction(getCostFunction(costFunctionId));
+
+		insertDecisionVariable(decisionVar);
+	}
+
+	std::map<int, std::vector<int> > serviceVariables;
+	for (std::size_t i = 0; i < rows.service_variables.size(); ++i)
+		serviceVariables[rows.service_variables[i].service_id].push_back(rows.service_variables[i].decision_variable_id);
+
+	// As loadTrafficConverter, the first row of a service configures it.
+	std::map<int, const TrafficRow *> traffic;
+	for (std::size_t i = 0; i < rows.traffic.size(); ++i)
+		traffic.insert(std::pair<int, const TrafficRow *>(rows.traffic[i].service_id, &rows.traffic[i]));
+
+	for (std::size_t i = 0; i < rows.services.size(); ++i)
+	{
+		const ServiceRow & row = rows.services[i];
+		std::string serviceId;
+		Poco::NumberFormatter::append(serviceId, row.id);
+		Service *service = new Service();
+		service->setId(serviceId);
+		service->setName(row.name);
+		service->loadDemand(row.file_name_demand);
+		if (row.converter_origin.compare("D") == 0)
+		{
+			SimplestTrafficConverter * traffic_converter = NULL;
+			std::map<int, const TrafficRow *>::iterator it = traffic.find(row.id);
+			if (it != traffic.end())
+			{
+				traffic_converter = new SimplestTrafficConverter();
+				traffic_converter->setTrafficSampleConfiguration(it->second->average, it->second->variance);
+			}
+			service->setTrafficConverter(traffic_converter);
+		}
+		else
+		{
+			service->loadTrafficConverter(row.file_name_converter);
+		}
+
+		const std::vector<int> & variables = serviceVariables[row.id];
+		for (std::size_t j = 0; j < variables.size(); ++j)
+		{
+			std::string variableId;
+			Poco::NumberFormatter::append(variableId, variables[j]);
+			service->addDecisionVariable(getDecisionVariable(variableId));
+		}
+		insertService(service);
+	}
+
+	// The traffic converter files were only needed while loading.
+	DelimitedFile::clearShared();
+
+	for (std::size_t i = 0; i < rows.services_to_execute.size(); ++i)
+	{
+		std::string serviceId;
+		Poco::NumberFormatter::append(serviceId, rows.services_to_execute[i]);
+		ServiceContainer::iterator it;
+		it = _services.find(serviceId);
+		if (it != _services.end())
+		{
+			_services_to_execute.push_back(serviceId);
+			_services_to_execute_ptr.push_back(it->second);
+		}
+	}
 }
 
 void FoundationSys::readGeneralParametersFromDataBase(void)
@@ -539,6 +795,9 @@ void FoundationSys::readServicesFromDataBase(void)
 		readServiceDecisionVariablesFromDataBase(id, service);
 		insertService(service);
 	}
+
+	// The traffic converter files were only needed while loading.
+	DelimitedFile::clearShared();
 }
 
 void FoundationSys::readServiceToExecute(void)
@@ -561,6 +820,7 @@ void FoundationSys::readServiceToExecute(void)
 		if (it != _services.end())
 		{
 			_services_to_execute.push_back(serviceId);
+			_services_to_execute_ptr.push_back(it->second);
 		}
 	}
 }
@@ -675,6 +935,15 @@ Service * FoundationSys::getService(std::string serviceId)
 	}
 }
 
+void FoundationSys::getForecasts(int period, std::vector<double> & forecasts)
+{
+	forecasts.resize(_services_to_execute_ptr.size());
+	for (std::size_t i = 0; i < _services_to_execute_ptr.size(); ++i)
+	{
+		forecasts[i] = _services_to_execute_ptr[i]->getForecast(period);
+	}
+}
+
 DecisionVariable * FoundationSys::getDecisionVariable(std::string decisionVariableId)
 {
     // Verify the resource register on the system.
@@ -738,6 +1007,11 @@ SimplestTrafficConverter * FoundationSys::loadTrafficConverter(std::string servi
 	return NULL;
 }
 
+StorageBackend * FoundationSys::getStorage()
+{
+	return _storage;
+}
+
 AgentType FoundationSys::getType()
 {
 	return _type;
@@ -129,80 +129,6 @@ std::string Listener::getId()
 	return _id;
 }
 
-void Listener::addStreamStagedForProcessing(Poco::FIFOBuffer & fifoIn, int len)
-{
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Entering Listener - addStreamStagedForProcessing");
-	std::size_t i = 0;
-	for (; i < fifoIn.used() ; ++i){
-		_waitingProcessing += (*(fifoIn.begin() + i));
-	}
-	fifoIn.drain(len);
-	app.logger().debug("Leaving Listener - addStreamStagedForProcessing");
-	app.logger().debug(_waitingProcessing);
-}
-
-bool Listener::getMessage(Message & message)
-{
-	Poco::Util::Application& app = Poco::Util::Application::instance();
-	app.logger().debug("Entering get Message");
-	
-	bool val_return = false;
-	unsigned size;
-	
-	if (_waitingProcessing.size() > 0) {
-		std::size_t found = _waitingProcessing.find("Method");
-		if (found == 0)
-		{
-			std::size_t found2 = _waitingProcessing.find("Method", found + 1);
-			if (found2 != std::string::npos)
-			{
-				std::string messageData = _waitingProcessing.substr(found, found2);
-				message.setData(messageData);
-				// Even that the message could have errors is complete
-				_waitingProcessing.erase(0,found2);
-				app.logger().debug("get Message from:%z to:%z", found, found2);
-				val_return = true;
-			}
-			else
-			{
-				std::string messageData = _waitingProcessing.substr(found, std::string::npos);
-				message.setData(messageData);
-				if (message.isComplete(_waitingProcessing.size()) )
-				{
-					_waitingProcessing.erase(0, std::string::npos);
-					val_return = true;
-				}
-				else{
-					val_return = false;
-				}
-			}
-		}
-		else
-		{
-			// The message is not well formed, so we create a message with method
-			// not specified
-
-			app.logger().debug("undefined:%z", found);
-
-			Method method = undefined;
-			message.setMethod(method);
-			message.setParameter("Message_Size", (int) found);
-			_waitingProcessing.erase(0,found-1);
-			val_return = true;
-		}
-	} else {
-		app.logger().debug("buffer is empty nothing to do");
-		val_return = false;
-	}
-	if (val_return)
-		app.logger().debug("Leaving - get Message: true");
-	else
-		app.logger().debug("Leaving - get Message: false");
-
-	return val_return;
-}
-
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
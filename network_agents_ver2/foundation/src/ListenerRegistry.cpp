@@ -0,0 +1,193 @@
+#include "ListenerRegistry.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ListenerRegistry::ListenerRegistry()
+{
+	_all.head = NULL;
+	_all.tail = NULL;
+}
+
+ListenerRegistry::~ListenerRegistry()
+{
+	Entry * entry = _all.head;
+	while (entry != NULL)
+	{
+		Entry * next = entry->next;
+		(entry->listener)->Disconnect();
+		delete entry->listener;
+		delete entry;
+		entry = next;
+	}
+	_all.head = NULL;
+	_all.tail = NULL;
+	_by_address.clear();
+	_by_id.clear();
+	_by_type.clear();
+}
+
+std::string ListenerRegistry::getAddressKey(const Poco::Net::SocketAddress & socketAddress)
+{
+	return socketAddress.toString();
+}
+
+Listener * ListenerRegistry::add(const std::string & id, Poco::Net::SocketAddress socketAddress)
+{
+	std::string address = getAddressKey(socketAddress);
+	if ((_by_id.find(id) != _by_id.end()) || (_by_address.find(address) != _by_address.end()))
+		return NULL;
+
+	Entry * entry = new Entry();
+	entry->listener = new Listener(id, socketAddress);
+	entry->address = address;
+	entry->prev = _all.tail;
+	entry->next = NULL;
+	entry->type_prev = NULL;
+	entry->type_next = NULL;
+
+	if (_all.tail != NULL)
+		(_all.tail)->next = entry;
+	else
+		_all.head = entry;
+	_all.tail = entry;
+
+	_by_address.insert(std::pair<std::string, Entry *>(address, entry));
+	_by_id.insert(std::pair<std::string, Entry *>(id, entry));
+	return entry->listener;
+}
+
+Listener * ListenerRegistry::find(const Poco::Net::SocketAddress & socketAddress)
+{
+	std::unordered_map<std::string, Entry *>::iterator it;
+	it = _by_address.find(getAddressKey(socketAddress));
+	if (it != _by_address.end())
+		return (it->second)->listener;
+	return NULL;
+}
+
+Listener * ListenerRegistry::find(const std::string & id)
+{
+	std::unordered_map<std::string, Entry *>::iterator it;
+	it = _by_id.find(id);
+	if (it != _by_id.end())
+		return (it->second)->listener;
+	return NULL;
+}
+
+void ListenerRegistry::setType(Listener * listener, const std::string & type)
+{
+	std::unordered_map<std::string, Entry *>::iterator it;
+	it = _by_id.find(listener->getId());
+	if (it == _by_id.end())
+		return;
+
+	Entry * entry = it->second;
+	unlinkType(entry);
+
+	listener->setType(type);
+	entry->type = type;
+
+	std::unordered_map<std::string, EntryList>::iterator it_type;
+	it_type = _by_type.find(type);
+	if (it_type == _by_type.end())
+	{
+		EntryList list;
+		list.head = NULL;
+		list.tail = NULL;
+		it_type = _by_type.insert(std::pair<std::string, EntryList>(type, list)).first;
+	}
+
+	EntryList & list = it_type->second;
+	entry->type_prev = list.tail;
+	entry->type_next = NULL;
+	if (list.tail != NULL)
+		(list.tail)->type_next = entry;
+	else
+		list.head = entry;
+	list.tail = entry;
+}
+
+void ListenerRegistry::unlinkType(Entry * entry)
+{
+	if (entry->type.empty())
+		return;
+
+	std::unordered_map<std::string, EntryList>::iterator it_type;
+	it_type = _by_type.find(entry->type);
+	if (it_type != _by_type.end())
+	{
+		EntryList & list = it_type->second;
+		if (entry->type_prev != NULL)
+			(entry->type_prev)->type_next = entry->type_next;
+		else
+			list.head = entry->type_next;
+		if (entry->type_next != NULL)
+			(entry->type_next)->type_prev = entry->type_prev;
+		else
+			list.tail = entry->type_prev;
+	}
+
+	entry->type.clear();
+	entry->type_prev = NULL;
+	entry->type_next = NULL;
+}
+
+Listener * ListenerRegistry::remove(const Poco::Net::SocketAddress & socketAddress)
+{
+	std::unordered_map<std::string, Entry *>::iterator it;
+	it = _by_address.find(getAddressKey(socketAddress));
+	if (it == _by_address.end())
+		return NULL;
+
+	Entry * entry = it->second;
+	_by_address.erase(it);
+	_by_id.erase((entry->listener)->getId());
+	unlinkType(entry);
+
+	if (entry->prev != NULL)
+		(entry->prev)->next = entry->next;
+	else
+		_all.head = entry->next;
+	if (entry->next != NULL)
+		(entry->next)->prev = entry->prev;
+	else
+		_all.tail = entry->prev;
+
+	Listener * listener = entry->listener;
+	delete entry;
+	return listener;
+}
+
+std::size_t ListenerRegistry::size()
+{
+	return _by_address.size();
+}
+
+void ListenerRegistry::getListeners(std::vector<Listener *> & listeners)
+{
+	for (Entry * entry = _all.head; entry != NULL; entry = entry->next)
+	{
+		listeners.push_back(entry->listener);
+	}
+}
+
+void ListenerRegistry::getListeners(const std::string & type, std::vector<Listener *> & listeners)
+{
+	std::unordered_map<std::string, EntryList>::iterator it_type;
+	it_type = _by_type.find(type);
+	if (it_type == _by_type.end())
+		return;
+
+	for (Entry * entry = (it_type->second).head; entry != NULL; entry = entry->type_next)
+	{
+		listeners.push_back(entry->listener);
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
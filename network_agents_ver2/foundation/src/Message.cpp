@@ -3,6 +3,7 @@
 #include <iostream>
 #include <Poco/StringTokenizer.h>
 #include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
 #include "Message.h"
 #include "FoundationException.h"
 #include <stdlib.h>
@@ -94,6 +95,12 @@ void Message::setData(std::string data)
 			else if (methodParam[1].compare("get_availability") == 0){
 				_method = get_availability;
 			}
+			else if (methodParam[1].compare("period_done") == 0){
+				_method = period_done;
+			}
+			else if (methodParam[1].compare("snapshot") == 0){
+				_method = snapshot;
+			}
 			else{
 				_method = undefined;
 			}
@@ -236,6 +243,12 @@ std::string Message::getStrMethod()
 	   case get_availability:
 	   	  result = "get_availability";
 	   	  break;
+	   case period_done:
+	   	  result = "period_done";
+	   	  break;
+	   case snapshot:
+	   	  result = "snapshot";
+	   	  break;
     }
     return result;
 }
@@ -333,6 +346,24 @@ bool Message::isComplete(size_t lenght)
 		return false;
 }
 
+void Message::setVirtualTime(Poco::UInt64 time)
+{
+	setParameter("Virtual_Time", Poco::NumberFormatter::format(time));
+}
+
+bool Message::hasVirtualTime()
+{
+	return existsParameter("Virtual_Time");
+}
+
+Poco::UInt64 Message::getVirtualTime()
+{
+	Poco::UInt64 time = 0;
+	if (hasVirtualTime())
+		Poco::NumberParser::tryParseUnsigned64(getParameter("Virtual_Time"), time);
+	return time;
+}
+
 
 }  /// End Eco namespace
 
@@ -0,0 +1,71 @@
+#include "MessageFraming.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+MessageFraming::MessageFraming()
+{
+}
+
+MessageFraming::~MessageFraming()
+{
+}
+
+void MessageFraming::append(const char * data, std::size_t length)
+{
+	_staged.append(data, length);
+}
+
+void MessageFraming::append(Poco::FIFOBuffer & fifoIn)
+{
+	std::size_t used = fifoIn.used();
+	_staged.append(fifoIn.begin(), used);
+	fifoIn.drain(used);
+}
+
+bool MessageFraming::next(Message & message)
+{
+	if (_staged.empty())
+		return false;
+
+	std::size_t found = _staged.find("Method");
+	if (found == 0)
+	{
+		std::size_t found2 = _staged.find("Method", found + 1);
+		if (found2 != std::string::npos)
+		{
+			// Even that the message could have errors is complete
+			message.setData(_staged.substr(0, found2));
+			_staged.erase(0, found2);
+			return true;
+		}
+
+		message.setData(_staged);
+		if (message.isComplete(_staged.size()))
+		{
+			_staged.clear();
+			return true;
+		}
+		return false;
+	}
+
+	// The message is not well formed, so we create a message with method
+	// not specified and skip the data up to the next method.
+	Method method = undefined;
+	message.setMethod(method);
+	message.setParameter("Message_Size", (int) found);
+	_staged.erase(0, found);
+	return true;
+}
+
+std::size_t MessageFraming::size()
+{
+	return _staged.size();
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
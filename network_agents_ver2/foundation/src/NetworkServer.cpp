@@ -0,0 +1,270 @@
+#include <Poco/Util/Application.h>
+#include <Poco/NObserver.h>
+#include <Poco/Exception.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Net/IPAddress.h>
+#include <Poco/File.h>
+
+#include "NetworkServer.h"
+#include "ServerConnection.h"
+#include "SharedMemoryServer.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+NetworkServer::NetworkServer(const std::string & name,
+							 ServerDispatcher & dispatcher,
+							 unsigned reactors):
+_name(name),
+_dispatcher(dispatcher),
+_next_local(1),
+_shared(NULL),
+_next_reactor(0),
+_started(false)
+{
+	if (reactors == 0)
+		reactors = 1;
+
+	for (unsigned i = 0; i < reactors; ++i)
+	{
+		_reactors.push_back(new WaitingSocketReactor());
+		_threads.push_back(new Poco::Thread());
+	}
+	_dispatcher.setReactor(_reactors[0]);
+}
+
+NetworkServer::~NetworkServer()
+{
+	stop();
+
+	delete _shared;
+	_dispatcher.setReactor(NULL);
+	for (std::size_t i = 0; i < _reactors.size(); ++i)
+	{
+		delete _threads[i];
+		delete _reactors[i];
+	}
+}
+
+void NetworkServer::listenLocal(const std::string & path)
+{
+	// A socket file left by a previous run would make the bind fail.
+	Poco::File socketFile(path);
+	if (socketFile.exists())
+		socketFile.remove();
+
+	_localSocket.bind(Poco::Net::SocketAddress(Poco::Net::SocketAddress::UNIX_LOCAL, path));
+	_localSocket.listen();
+	_localPath = path;
+}
+
+void NetworkServer::listenSharedMemory(const std::string & name, unsigned slots,
+									   std::size_t ringSize)
+{
+	_shared = new SharedMemoryServer(*this, name, slots, ringSize);
+}
+
+void NetworkServer::start(Poco::UInt16 port)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	_socket.bind(port, true);
+	_socket.listen();
+
+	_reactors[0]->addEventHandler(_socket,
+		Poco::NObserver<NetworkServer, Poco::Net::ReadableNotification>(*this, &NetworkServer::onAccept));
+	if (_localPath.empty() == false)
+		_reactors[0]->addEventHandler(_localSocket,
+			Poco::NObserver<NetworkServer, Poco::Net::ReadableNotification>(*this, &NetworkServer::onAcceptLocal));
+
+	for (std::size_t i = 0; i < _reactors.size(); ++i)
+	{
+		_threads[i]->start(*_reactors[i]);
+	}
+	if (_shared != NULL)
+		_shared->start();
+	_started = true;
+
+	app.logger().information(Poco::format("Server %s listening on port %d with %z reactors",
+							 _name, (int) port, _reactors.size()));
+	if (_localPath.empty() == false)
+		app.logger().information(Poco::format("Server %s listening on %s", _name, _localPath));
+}
+
+void NetworkServer::stop()
+{
+	if (_started == false)
+		return;
+	_started = false;
+
+	_reactors[0]->removeEventHandler(_socket,
+		Poco::NObserver<NetworkServer, Poco::Net::ReadableNotification>(*this, &NetworkServer::onAccept));
+	if (_localPath.empty() == false)
+		_reactors[0]->removeEventHandler(_localSocket,
+			Poco::NObserver<NetworkServer, Poco::Net::ReadableNotification>(*this, &NetworkServer::onAcceptLocal));
+
+	for (std::size_t i = 0; i < _reactors.size(); ++i)
+	{
+		_reactors[i]->stop();
+	}
+	for (std::size_t i = 0; i < _threads.size(); ++i)
+	{
+		_threads[i]->join();
+	}
+
+	if (_shared != NULL)
+		_shared->stop();
+
+	if (_localPath.empty() == false)
+	{
+		_localSocket.close();
+		Poco::File(_localPath).remove();
+	}
+
+	logStats();
+}
+
+void NetworkServer::onAccept(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf)
+{
+	Poco::Net::StreamSocket socket = _socket.acceptConnection();
+	attach(socket, socket.peerAddress());
+}
+
+void NetworkServer::onAcceptLocal(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf)
+{
+	Poco::Net::StreamSocket socket = _localSocket.acceptConnection();
+
+	attach(socket, assignLocalAddress());
+}
+
+void NetworkServer::attach(Poco::Net::StreamSocket & socket,
+						   Poco::Net::SocketAddress socketAddress)
+{
+	_metrics.connectionOpened();
+
+	WaitingSocketReactor * reactor = _reactors[_next_reactor];
+	_next_reactor = (_next_reactor + 1) % _reactors.size();
+
+	if (reactor == _reactors[0])
+	{
+		new ServerConnection(socket, socketAddress, *reactor, *this);
+	}
+	else
+	{
+		// The connection registers itself from its own reactor thread, so
+		// no notification can reach it before it is built.
+		NetworkServer * server = this;
+		reactor->post([socket, socketAddress, reactor, server]() mutable
+		{
+			new ServerConnection(socket, socketAddress, *reactor, *server);
+		});
+	}
+}
+
+Poco::Net::SocketAddress NetworkServer::assignLocalAddress()
+{
+	Poco::UInt64 local;
+	{
+		Poco::FastMutex::ScopedLock lock(_local_mutex);
+		local = _next_local++;
+	}
+	return Poco::Net::SocketAddress(Poco::Net::SocketAddress::UNIX_LOCAL,
+									Poco::format("local:%s:%Lu", _name, local));
+}
+
+bool NetworkServer::isLocalPeer(const Poco::Net::SocketAddress & socketAddress)
+{
+	return socketAddress.family() == Poco::Net::SocketAddress::UNIX_LOCAL;
+}
+
+Poco::Net::IPAddress NetworkServer::getCallbackHost(const Poco::Net::SocketAddress & socketAddress)
+{
+	if (isLocalPeer(socketAddress))
+		return Poco::Net::IPAddress("127.0.0.1");
+	return socketAddress.host();
+}
+
+void NetworkServer::received(Poco::AutoPtr<ConnectionChannel> channel,
+							 Poco::Net::SocketAddress socketAddress,
+							 std::vector<Request> & requests)
+{
+	for (std::size_t i = 0; i < requests.size(); ++i)
+		_metrics.requestRead();
+
+	if (_reactors[0]->isReactorThread())
+	{
+		dispatch(channel, socketAddress, requests);
+		return;
+	}
+
+	NetworkServer * server = this;
+	_reactors[0]->post([server, channel, socketAddress, requests]() mutable
+	{
+		server->dispatch(channel, socketAddress, requests);
+	});
+}
+
+void NetworkServer::dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+							 Poco::Net::SocketAddress socketAddress,
+							 std::vector<Request> & requests)
+{
+	std::vector<Request>::iterator it;
+	for (it = requests.begin(); it != requests.end(); ++it)
+	{
+		_dispatcher.dispatch(channel, it->sequence, socketAddress, it->message);
+	}
+	_dispatcher.onReadBatch();
+}
+
+void NetworkServer::closed(Poco::Net::SocketAddress socketAddress)
+{
+	_metrics.connectionClosed();
+
+	if (_reactors[0]->isReactorThread())
+	{
+		disconnect(socketAddress);
+		return;
+	}
+
+	NetworkServer * server = this;
+	_reactors[0]->post([server, socketAddress]()
+	{
+		server->disconnect(socketAddress);
+	});
+}
+
+void NetworkServer::disconnect(Poco::Net::SocketAddress socketAddress)
+{
+	try
+	{
+		_dispatcher.onDisconnect(socketAddress);
+	}
+	catch (Poco::Exception &e)
+	{
+		// The peer was not registered.
+		Poco::Util::Application& app = Poco::Util::Application::instance();
+		app.logger().debug(Poco::format("Disconnect %s: %s", socketAddress.toString(), e.displayText()));
+	}
+}
+
+WaitingSocketReactor & NetworkServer::getDispatchReactor()
+{
+	return *_reactors[0];
+}
+
+ServerMetrics & NetworkServer::getMetrics()
+{
+	return _metrics;
+}
+
+void NetworkServer::logStats()
+{
+	_metrics.logStats(_name);
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -1,11 +1,9 @@
 #include <map>
 #include <iostream>
-#include <fstream>
-#include <Poco/StringTokenizer.h>
-#include <Poco/NumberParser.h>
 #include <Poco/NumberFormatter.h>
 
 #include "ProbabilityDistribution.h"
+#include "DelimitedFile.h"
 #include "FoundationException.h"
 
 namespace ChoiceNet
@@ -98,76 +96,63 @@ void ProbabilityDistribution::addPoint(double value, double probability)
 void ProbabilityDistribution::readPointsFromFile(std::string location, std::string file_name)
 {
 
-    std::string separator = ":";
     std::string absFileName = location;
     absFileName.append("/");
     absFileName.append(file_name);
 
-    // Open the file for reading, checking to make sure it was successfully opened
-    std::ifstream inFile;
-    // std::cout << "file_name:" << absFileName << std::endl;
-    inFile.open(absFileName.c_str());
-
-    if(inFile.is_open())
+    DelimitedFile file(':');
+    if (file.open(absFileName) == false)
     {
-        // std::cout << "We could open the file" << std::endl;
-        for ( std::string line; getline( inFile, line );)
-        {
-			Poco::StringTokenizer dividedLine(line, separator, Poco::StringTokenizer::TOK_TRIM);
-			if (dividedLine.count() == 2)
-			{
-				try{
-					double point = Poco::NumberParser::parseFloat(dividedLine[0]);
-					double probability = Poco::NumberParser::parseFloat(dividedLine[1]);
-					
-					// Validates typical poblems in data
-					if ((probability < 0) || (probability > 1)) {
-						std::string message = "Invalid probability for point ";
-						Poco::NumberFormatter::append(message, probability);
-						throw FoundationException(message);
-					}
-					else if (_points.count(point) > 0){
-						std::string message = "Point ";
-						Poco::NumberFormatter::append(message, point);
-						message.append(" is already given as parameter");
-						throw FoundationException(message);
-					}
-					else
-					{
-						// std::cout << "inserting line" << line << "Point:" << point << "Probability:" << probability << std::endl;
-						_points.insert(std::pair<double,double>(point,probability));
-					}
-				}
-				catch (Poco::SyntaxException e){
-					throw FoundationException("Invalid value in probability distribution file");
-				}
-			}
-			else
-			{
-				// we have to raise an exception because the file is not well formed.
-				throw FoundationException("Probability point line is not in the correct format( point : probability )");
-			}
+		throw FoundationException("Probability file was not found");
+    }
+
+	for (std::size_t line = 0; line < file.size(); ++line)
+	{
+		if (file.count(line) != 2)
+		{
+			// we have to raise an exception because the file is not well formed.
+			throw FoundationException("Probability point line is not in the correct format( point : probability )");
 		}
-		inFile.close(); 
-		
-		// Verifies that the sum of probabilities is equal to 1.0
-		double acum = 0;
-		std::map<double,double>::iterator it;
-		for(it = _points.begin(); it != _points.end(); it++) {
-			acum = acum + it->second;
+
+		double point = 0;
+		double probability = 0;
+		if ((file.parseFloat(line, 0, point) == false) ||
+			(file.parseFloat(line, 1, probability) == false))
+		{
+			throw FoundationException("Invalid value in probability distribution file");
 		}
-		
-		if (acum != 1.0)
+
+		// Validates typical poblems in data
+		if ((probability < 0) || (probability > 1)) {
+			std::string message = "Invalid probability for point ";
+			Poco::NumberFormatter::append(message, probability);
+			throw FoundationException(message);
+		}
+		else if (_points.count(point) > 0){
+			std::string message = "Point ";
+			Poco::NumberFormatter::append(message, point);
+			message.append(" is already given as parameter");
+			throw FoundationException(message);
+		}
+		else
 		{
-			_points.clear();
-			throw FoundationException("Probabilities in the file don't sum up 1.0");
+			_points.insert(std::pair<double,double>(point,probability));
 		}
-		
-    }
-    else{
-		throw FoundationException("Probability file was not found");
-    }
-	
+	}
+
+	// Verifies that the sum of probabilities is equal to 1.0
+	double acum = 0;
+	std::map<double,double>::iterator it;
+	for(it = _points.begin(); it != _points.end(); it++) {
+		acum = acum + it->second;
+	}
+
+	if (acum != 1.0)
+	{
+		_points.clear();
+		throw FoundationException("Probabilities in the file don't sum up 1.0");
+	}
+
 }
 	
 void ProbabilityDistribution::to_XML(Poco::XML::AutoPtr<Poco::XML::Document> pDoc,
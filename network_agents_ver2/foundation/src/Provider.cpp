@@ -132,6 +132,35 @@ double Provider::getResourceAvailability(unsigned period,
 	}
 }
 
+void Provider::setResourceAvailability(unsigned period,
+									   std::string resourceId,
+									   double quantity)
+{
+	ResourceMap::iterator it;
+	it = _resources.find(resourceId);
+	if (it != _resources.end())
+		(it->second)->setAvailability(period, quantity);
+}
+
+void Provider::getResources(std::vector<std::string> & resourceIds)
+{
+	ResourceMap::iterator it;
+	for (it = _resources.begin(); it != _resources.end(); ++it)
+		resourceIds.push_back(it->first);
+}
+
+void Provider::getAvailabilities(std::string resourceId, double & initial,
+								 std::map<unsigned, double> & periods)
+{
+	ResourceMap::iterator it;
+	it = _resources.find(resourceId);
+	if (it != _resources.end())
+	{
+		initial = (it->second)->getInitialAvailability();
+		(it->second)->getAvailabilities(periods);
+	}
+}
+
 double Provider::getUnitaryRequirement(unsigned period,
 									   std::string resourceId,
 									   DecisionVariable *variable,
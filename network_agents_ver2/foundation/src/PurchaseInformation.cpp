@@ -27,14 +27,12 @@ PurchaseInformation::~PurchaseInformation()
 	
 	// Release the memory assigned to service information objects
 	PurchaseServiceInformationContainer::iterator it_service;
-	it_service = _service_information.begin();
-	while( (it_service!=_service_information.end())  )
+	for (it_service = _service_information.begin(); it_service != _service_information.end(); ++it_service)
 	{
 		// std::cout << "Deleting service purchase in the system" << std::endl;
 		delete it_service->second;
-		_service_information.erase(it_service);
-		++it_service;
 	}
+	_service_information.clear();
 
 	// std::cout << "Deleted the purchase in the system" << std::endl;
 
@@ -119,6 +117,23 @@ void PurchaseInformation::toDatabase(Poco::Data::SessionPool * _pool, int execut
 	}
 }
 
+void PurchaseInformation::getDBPurchases(int execution_count, int period,
+										 std::vector<PurchaseServiceBidStruct> & rows)
+{
+	PurchaseServiceInformationContainer::iterator it;
+	for (it = _service_information.begin(); it != _service_information.end(); ++it)
+	{
+		(it->second)->getDBPurchases(execution_count, period, it->first, rows);
+	}
+}
+
+void PurchaseInformation::setPurchaseQuantities(std::string serviceId, std::string bidId,
+												double quantity, double quantityBacklog)
+{
+	addService(serviceId);
+	_service_information[serviceId]->setQuantities(bidId, quantity, quantityBacklog);
+}
+
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
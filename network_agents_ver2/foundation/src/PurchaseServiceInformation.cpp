@@ -12,6 +12,7 @@
 #include <Poco/NumberFormatter.h>
 
 #include "PurchaseServiceInformation.h"
+#include "BulkInsert.h"
 
 using namespace Poco::Data::Keywords;
 
@@ -234,20 +235,12 @@ void PurchaseServiceInformation::toDatabase(Poco::Data::SessionPool * _pool, int
 	if (periods.size() > 0 ){
 
 		Poco::Data::Session session(_pool->get());
-		Poco::Data::Statement inserttmp(session);
-
-		inserttmp << "insert into simulation_bid_purchases_tmp(period, serviceId, bidId, quantity, qty_backlog, execution_count) values(?,?,?,?,?,?)", use(periods),
-						use(serviceIds), use(bidIds), use(quantities), use(quantityBacklogs), use(executioncount);
-
-		inserttmp.execute();
-
-		Poco::Data::Statement insert(session);
-		insert << "insert into simulation_bid_purchases(period, serviceId, bidId, quantity, qty_backlog, execution_count) select period, serviceId, bidId, quantity, qty_backlog, execution_count from simulation_bid_purchases_tmp";
-		insert.execute();
-
-		Poco::Data::Statement deletetmp(session);
-		deletetmp << "truncate simulation_bid_purchases_tmp";
-		deletetmp.execute();
+		BulkInsert insert("simulation_bid_purchases",
+			"period, serviceId, bidId, quantity, qty_backlog, execution_count",
+			BulkInsert::DEFAULT_CHUNK);
+		insert.column(periods).column(serviceIds).column(bidIds)
+			  .column(quantities).column(quantityBacklogs).column(executioncount);
+		insert.execute(session);
 
 		session.commit();
 	}
@@ -255,6 +248,32 @@ void PurchaseServiceInformation::toDatabase(Poco::Data::SessionPool * _pool, int
 	app.logger().debug("Ending purchase service information toDatabase");
 }
 
+void PurchaseServiceInformation::getDBPurchases(int execution_count, int period, std::string serviceId,
+												std::vector<PurchaseServiceBidStruct> & rows)
+{
+	std::map<std::string, PurchaseQuantities>::iterator it_purchase;
+	for (it_purchase = _summaries_by_bid.begin(); it_purchase != _summaries_by_bid.end(); ++it_purchase)
+	{
+		PurchaseServiceBidStruct row;
+		row._period = period;
+		row._serviceId = serviceId;
+		row._bidId = it_purchase->first;
+		row._quantity = (it_purchase->second)._quantity;
+		row._quantity_backlog = (it_purchase->second)._quantity_backlog;
+		row._execution_count = execution_count;
+		rows.push_back(row);
+	}
+}
+
+void PurchaseServiceInformation::setQuantities(std::string bidId, double quantity,
+											   double quantityBacklog)
+{
+	PurchaseQuantities quant;
+	quant._quantity = quantity;
+	quant._quantity_backlog = quantityBacklog;
+	_summaries_by_bid[bidId] = quant;
+}
+
 }  /// End Eco namespace
 
 }  /// End ChoiceNet namespace
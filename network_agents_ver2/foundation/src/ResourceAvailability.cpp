@@ -49,6 +49,21 @@ double ResourceAvailability::getAvailability(unsigned period)
 	}
 }
 
+void ResourceAvailability::setAvailability(unsigned period, double quantity)
+{
+	_time_availability[period] = quantity;
+}
+
+double ResourceAvailability::getInitialAvailability(void)
+{
+	return _init_availability;
+}
+
+void ResourceAvailability::getAvailabilities(std::map<unsigned, double> & periods)
+{
+	periods = _time_availability;
+}
+
 double ResourceAvailability::getUnitaryRequirement(unsigned period,
 												   DecisionVariable *variable,
 										    	   double level)
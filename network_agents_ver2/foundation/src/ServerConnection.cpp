@@ -0,0 +1,156 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Delegate.h>
+#include <Poco/Exception.h>
+#include <Poco/Net/NetException.h>
+#include <vector>
+
+#include "ServerConnection.h"
+#include "NetworkServer.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ServerConnection::ServerConnection(Poco::Net::StreamSocket & socket,
+								   Poco::Net::SocketAddress socketAddress,
+								   WaitingSocketReactor & reactor,
+								   NetworkServer & server):
+_socket(socket),
+_reactor(reactor),
+_server(server),
+_address(socketAddress),
+_fifoIn(BUFFER_SIZE, true),
+_fifoOut(BUFFER_SIZE, true)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Connection from " + _address.toString());
+
+	_channel = new ConnectionChannel(this, reactor);
+
+	_fifoOut.readable += Poco::delegate(this, &ServerConnection::onFIFOOutReadable);
+
+	_reactor.addEventHandler(_socket,
+		Poco::NObserver<ServerConnection, Poco::Net::ShutdownNotification>(*this, &ServerConnection::onSocketShutdown));
+	_reactor.addEventHandler(_socket,
+		Poco::NObserver<ServerConnection, Poco::Net::ErrorNotification>(*this, &ServerConnection::onSocketError));
+	_reactor.addEventHandler(_socket,
+		Poco::NObserver<ServerConnection, Poco::Net::ReadableNotification>(*this, &ServerConnection::onSocketReadable));
+}
+
+ServerConnection::~ServerConnection()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Disconnecting " + _address.toString());
+
+	// Responses still in flight are discarded from now on.
+	_channel->detach();
+
+	_server.closed(_address);
+
+	try
+	{
+		_reactor.removeEventHandler(_socket, Poco::NObserver<ServerConnection,
+					Poco::Net::ReadableNotification>(*this, &ServerConnection::onSocketReadable));
+		_reactor.removeEventHandler(_socket, Poco::NObserver<ServerConnection,
+					Poco::Net::WritableNotification>(*this, &ServerConnection::onSocketWritable));
+		_reactor.removeEventHandler(_socket, Poco::NObserver<ServerConnection,
+					Poco::Net::ShutdownNotification>(*this, &ServerConnection::onSocketShutdown));
+		_reactor.removeEventHandler(_socket, Poco::NObserver<ServerConnection,
+					Poco::Net::ErrorNotification>(*this, &ServerConnection::onSocketError));
+
+		_fifoOut.readable -= Poco::delegate(this, &ServerConnection::onFIFOOutReadable);
+	}
+	catch (Poco::Exception &e)
+	{
+		app.logger().error(Poco::format("Error closing connection %s: %s", _address.toString(), e.displayText()));
+	}
+}
+
+void ServerConnection::onFIFOOutReadable(bool& b)
+{
+	if (b)
+		_reactor.addEventHandler(_socket, Poco::NObserver<ServerConnection,
+				Poco::Net::WritableNotification>(*this, &ServerConnection::onSocketWritable));
+	else
+		_reactor.removeEventHandler(_socket, Poco::NObserver<ServerConnection,
+				Poco::Net::WritableNotification>(*this, &ServerConnection::onSocketWritable));
+}
+
+void ServerConnection::onSocketReadable(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf)
+{
+	// some socket implementations (windows) report available
+	// bytes on client disconnect, so we double-check here
+	int len = 0;
+	try
+	{
+		if (_socket.available())
+			len = _socket.receiveBytes(_fifoIn.next(), _fifoIn.available());
+	}
+	catch (Poco::Net::NetException &e)
+	{
+		len = 0;
+	}
+
+	if (len <= 0)
+	{
+		delete this;
+		return;
+	}
+
+	_fifoIn.advance(len);
+	_framing.append(_fifoIn);
+	_server.getMetrics().bytesRead(len);
+
+	std::vector<NetworkServer::Request> requests;
+	bool defined = true;
+	do {
+		NetworkServer::Request request;
+		defined = _framing.next(request.message);
+		if (defined == true)
+		{
+			// The response keeps the place of the request in the connection.
+			request.sequence = _channel->reserve();
+			requests.push_back(request);
+		}
+	} while (defined == true);
+
+	if (requests.size() > 0)
+		_server.received(_channel, _address, requests);
+}
+
+void ServerConnection::onSocketWritable(const Poco::AutoPtr<Poco::Net::WritableNotification>& pNf)
+{
+	int len = _socket.sendBytes((_fifoOut.buffer()).begin(), _fifoOut.used());
+	if (len > 0)
+	{
+		_fifoOut.drain(len);
+		_server.getMetrics().bytesWritten(len);
+	}
+}
+
+void ServerConnection::onSocketShutdown(const Poco::AutoPtr<Poco::Net::ShutdownNotification>& pNf)
+{
+	delete this;
+}
+
+void ServerConnection::onSocketError(const Poco::AutoPtr<Poco::Net::ErrorNotification>& pNf)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Socket error: " + _address.toString());
+}
+
+void ServerConnection::writeResponse(const std::string & responseStr)
+{
+	if ((responseStr.length() + 1) > (_fifoOut.size() - _fifoOut.used()))
+	{
+		_fifoOut.resize(_fifoOut.used() + responseStr.length() + 1, true);
+	}
+	_fifoOut.write(responseStr.c_str(), responseStr.length());
+	_server.getMetrics().responseQueued();
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
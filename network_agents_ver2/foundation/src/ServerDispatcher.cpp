@@ -0,0 +1,106 @@
+#include <Poco/Util/Application.h>
+#include <Poco/NumberFormatter.h>
+
+#include "ServerDispatcher.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ServerDispatcher::ServerDispatcher():
+_reactor(NULL)
+{
+}
+
+ServerDispatcher::~ServerDispatcher()
+{
+}
+
+void ServerDispatcher::addMethod(Method method, const MethodHandler & handler)
+{
+	std::size_t index = (std::size_t) method;
+	if (_methods.size() <= index)
+		_methods.resize(index + 1);
+	_methods[index] = handler;
+}
+
+void ServerDispatcher::execute(Poco::Net::SocketAddress socketAddress,
+							   Message & message, Message & messageResponse)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	Method meth = message.getMethod();
+	// This object will be the response for the calling application.
+	messageResponse.setMethod(meth);
+
+	std::size_t index = (std::size_t) meth;
+	try
+	{
+		if ((index < _methods.size()) && (_methods[index]))
+			_methods[index](socketAddress, message, messageResponse);
+		else
+			errorProcedure(messageResponse);
+	}
+	catch(FoundationException &e)
+	{
+		std::string codeStr;
+		Poco::NumberFormatter::append(codeStr,e.code());
+		messageResponse.setParameter("Status_Code", codeStr);
+		messageResponse.setParameter("Status_Description", e.message());
+	}
+	catch(Poco::Exception &e)
+	{
+		// The exceptions of the servers carry their status code.
+		std::string codeStr;
+		Poco::NumberFormatter::append(codeStr,e.code());
+		messageResponse.setParameter("Status_Code", codeStr);
+		messageResponse.setParameter("Status_Description", e.message());
+	}
+	catch(...)
+	{
+		app.logger().information("Raise a unidentified exception");
+		messageResponse.setParameter("Status_Code", "1000");
+		messageResponse.setParameter("Status_Description", "Error Unidentified exception");
+	}
+}
+
+void ServerDispatcher::dispatch(Poco::AutoPtr<ConnectionChannel> channel,
+								unsigned sequence,
+								Poco::Net::SocketAddress socketAddress,
+								Message & message)
+{
+	Message messageResponse;
+	execute(socketAddress, message, messageResponse);
+	channel->deliver(sequence, messageResponse.to_string());
+}
+
+void ServerDispatcher::onReadBatch()
+{
+}
+
+void ServerDispatcher::onDisconnect(Poco::Net::SocketAddress socketAddress)
+{
+}
+
+void ServerDispatcher::setReactor(WaitingSocketReactor * reactor)
+{
+	_reactor = reactor;
+}
+
+WaitingSocketReactor & ServerDispatcher::getReactor()
+{
+	return *_reactor;
+}
+
+void ServerDispatcher::errorProcedure(Message & messageResponse)
+{
+	messageResponse.setParameter("Status_Code", "300");
+	messageResponse.setParameter("Status_Description", "Invalid Method");
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,86 @@
+#include <Poco/Util/Application.h>
+
+#include "ServerMetrics.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+ServerMetrics::ServerMetrics():
+_open(0)
+{
+	resetStats();
+}
+
+ServerMetrics::~ServerMetrics()
+{
+}
+
+void ServerMetrics::connectionOpened()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	++_open;
+	++_accepted;
+}
+
+void ServerMetrics::connectionClosed()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	if (_open > 0)
+		--_open;
+	++_closed;
+}
+
+void ServerMetrics::bytesRead(std::size_t bytes)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_bytes_read += bytes;
+}
+
+void ServerMetrics::requestRead()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	++_requests;
+}
+
+void ServerMetrics::responseQueued()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	++_responses;
+}
+
+void ServerMetrics::bytesWritten(std::size_t bytes)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_bytes_written += bytes;
+}
+
+void ServerMetrics::logStats(const std::string & name)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	app.logger().information(Poco::format("Server %s connections open:%lu accepted:%lu closed:%lu",
+							 name, _open, _accepted, _closed));
+	app.logger().information(Poco::format("Server %s requests:%lu responses:%lu read:%Lu bytes written:%Lu bytes in:%Ld ms",
+							 name, _requests, _responses, _bytes_read, _bytes_written,
+							 (Poco::Int64) (_since.elapsed() / 1000)));
+	resetStats();
+}
+
+void ServerMetrics::resetStats()
+{
+	_accepted = 0;
+	_closed = 0;
+	_requests = 0;
+	_responses = 0;
+	_bytes_read = 0;
+	_bytes_written = 0;
+	_since.update();
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
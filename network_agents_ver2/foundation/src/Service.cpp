@@ -206,6 +206,8 @@ void Service::loadDemand(std::string file_name)
 	std::map<std::string, std::string> parameters;
 	parameters.insert(std::pair<std::string, std::string> ("location", adj_path));
 	parameters.insert(std::pair<std::string, std::string> ("file_name", file_name));
+	if (app.config().getBool("demand_cache", true))
+		parameters.insert(std::pair<std::string, std::string> ("cache", "true"));
 	_demand_forecaster = new PointSetDemandForecaster( parameters );
 
 }
@@ -0,0 +1,108 @@
+#include <Poco/Timestamp.h>
+#include <unistd.h>
+
+#include "SharedMemoryClient.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+SharedMemoryClient::SharedMemoryClient(const std::string & name):
+_segment(name),
+_slot(0),
+_buffer(BUFFER_SIZE)
+{
+	for (; _slot < _segment.slots(); ++_slot)
+	{
+		SharedMemorySegment::Slot & slot = _segment.slot(_slot);
+		Poco::UInt32 expected = SharedMemorySegment::SLOT_FREE;
+		if (slot.state.compare_exchange_strong(expected, SharedMemorySegment::SLOT_ATTACHING))
+		{
+			// The server does not touch a slot that is not attached.
+			_segment.requests(_slot).reset();
+			_segment.responses(_slot).reset();
+			slot.pid.store((Poco::Int32) getpid());
+			slot.session.fetch_add(1);
+			slot.state.store(SharedMemorySegment::SLOT_ATTACHED);
+
+			SharedMemorySegment::Header & header = _segment.header();
+			SharedMemorySegment::ring(header.doorbell, header.sleeping);
+			return;
+		}
+	}
+	throw FoundationException("No free slot in the shared memory segment " + name);
+}
+
+SharedMemoryClient::~SharedMemoryClient()
+{
+	_segment.slot(_slot).state.store(SharedMemorySegment::SLOT_CLOSED);
+
+	SharedMemorySegment::Header & header = _segment.header();
+	SharedMemorySegment::ring(header.doorbell, header.sleeping);
+}
+
+void SharedMemoryClient::send(const std::string & request)
+{
+	SharedMemorySegment::Header & header = _segment.header();
+	SharedMemorySegment::Slot & slot = _segment.slot(_slot);
+	SharedMemoryRing requests = _segment.requests(_slot);
+
+	std::size_t sent = 0;
+	while (sent < request.size())
+	{
+		if (slot.state.load() != SharedMemorySegment::SLOT_ATTACHED)
+			throw FoundationException("The shared memory slot was closed by the server");
+
+		std::size_t len = requests.write(request.data() + sent, request.size() - sent);
+		sent += len;
+		if (len > 0)
+		{
+			SharedMemorySegment::ring(header.doorbell, header.sleeping);
+		}
+		else
+		{
+			// Full, the server is behind.
+			SharedMemorySegment::wait(slot.doorbell, slot.sleeping,
+									  slot.doorbell.load(), FULL_WAIT);
+		}
+	}
+}
+
+bool SharedMemoryClient::receive(Message & message, long milliseconds)
+{
+	SharedMemorySegment::Header & header = _segment.header();
+	SharedMemorySegment::Slot & slot = _segment.slot(_slot);
+	SharedMemoryRing responses = _segment.responses(_slot);
+
+	Poco::Timestamp start;
+	Poco::Timestamp::TimeDiff timeout = (Poco::Timestamp::TimeDiff) milliseconds * 1000;
+
+	while (true)
+	{
+		if (_framing.next(message))
+			return true;
+
+		Poco::UInt32 seen = slot.doorbell.load();
+		std::size_t len = responses.read(&_buffer[0], _buffer.size());
+		if (len > 0)
+		{
+			_framing.append(&_buffer[0], len);
+			// Room for the responses the server could not write.
+			SharedMemorySegment::ring(header.doorbell, header.sleeping);
+			continue;
+		}
+
+		Poco::Timestamp::TimeDiff elapsed = start.elapsed();
+		if (elapsed >= timeout)
+			return false;
+		SharedMemorySegment::wait(slot.doorbell, slot.sleeping, seen,
+								  (long) ((timeout - elapsed) / 1000) + 1);
+	}
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
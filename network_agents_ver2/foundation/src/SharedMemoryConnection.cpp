@@ -0,0 +1,112 @@
+#include <Poco/Util/Application.h>
+
+#include "SharedMemoryConnection.h"
+#include "SharedMemoryServer.h"
+#include "SharedMemorySegment.h"
+#include "NetworkServer.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+SharedMemoryConnection::SharedMemoryConnection(SharedMemoryServer & transport,
+											   unsigned slot,
+											   Poco::UInt32 session,
+											   Poco::Net::SocketAddress socketAddress,
+											   NetworkServer & server):
+_transport(transport),
+_slot(slot),
+_session(session),
+_address(socketAddress),
+_server(server),
+_buffer(BUFFER_SIZE)
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug(Poco::format("Shared memory connection on slot %u as %s",
+							slot, _address.toString()));
+
+	_channel = new ConnectionChannel(this, server.getDispatchReactor());
+}
+
+SharedMemoryConnection::~SharedMemoryConnection()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+	app.logger().debug("Disconnecting " + _address.toString());
+
+	// Responses still in flight are discarded from now on.
+	_channel->detach();
+
+	_server.closed(_address);
+}
+
+bool SharedMemoryConnection::pump()
+{
+	SharedMemorySegment & segment = _transport.getSegment();
+	bool progress = false;
+
+	SharedMemoryRing requestRing = segment.requests(_slot);
+	std::size_t len = requestRing.read(&_buffer[0], _buffer.size());
+	if (len > 0)
+	{
+		progress = true;
+		_framing.append(&_buffer[0], len);
+		_server.getMetrics().bytesRead(len);
+
+		std::vector<NetworkServer::Request> requests;
+		bool defined = true;
+		do {
+			NetworkServer::Request request;
+			defined = _framing.next(request.message);
+			if (defined == true)
+			{
+				request.sequence = _channel->reserve();
+				requests.push_back(request);
+			}
+		} while (defined == true);
+
+		if (requests.size() > 0)
+			_server.received(_channel, _address, requests);
+	}
+
+	std::size_t written = 0;
+	{
+		Poco::FastMutex::ScopedLock lock(_output_mutex);
+		if (_output.empty() == false)
+		{
+			SharedMemoryRing responseRing = segment.responses(_slot);
+			written = responseRing.write(_output.data(), _output.size());
+			_output.erase(0, written);
+		}
+	}
+
+	if (written > 0)
+	{
+		progress = true;
+		_server.getMetrics().bytesWritten(written);
+
+		SharedMemorySegment::Slot & slot = segment.slot(_slot);
+		SharedMemorySegment::ring(slot.doorbell, slot.sleeping);
+	}
+	return progress;
+}
+
+void SharedMemoryConnection::writeResponse(const std::string & responseStr)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_output_mutex);
+		_output.append(responseStr);
+	}
+	_server.getMetrics().responseQueued();
+	_transport.wakeUp();
+}
+
+Poco::UInt32 SharedMemoryConnection::getSession()
+{
+	return _session;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
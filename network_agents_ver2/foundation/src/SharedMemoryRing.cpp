@@ -0,0 +1,98 @@
+#include <cstring>
+
+#include "SharedMemoryRing.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+SharedMemoryRing::SharedMemoryRing(char * memory, std::size_t capacity):
+_control(reinterpret_cast<Control *>(memory)),
+_data(memory + sizeof(Control)),
+_capacity(capacity)
+{
+	if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+		throw FoundationException("The ring capacity must be a power of two");
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+}
+
+std::size_t SharedMemoryRing::footprint(std::size_t capacity)
+{
+	return sizeof(Control) + capacity;
+}
+
+void SharedMemoryRing::reset()
+{
+	_control->head.store(0);
+	_control->tail.store(0);
+}
+
+std::size_t SharedMemoryRing::write(const char * data, std::size_t length)
+{
+	Poco::UInt64 head = _control->head.load(std::memory_order_relaxed);
+	Poco::UInt64 tail = _control->tail.load(std::memory_order_acquire);
+
+	std::size_t free = _capacity - (std::size_t) (head - tail);
+	if (length > free)
+		length = free;
+	if (length == 0)
+		return 0;
+
+	std::size_t offset = (std::size_t) (head & (_capacity - 1));
+	std::size_t first = _capacity - offset;
+	if (first > length)
+		first = length;
+	memcpy(_data + offset, data, first);
+	memcpy(_data, data + first, length - first);
+
+	_control->head.store(head + length, std::memory_order_release);
+	return length;
+}
+
+std::size_t SharedMemoryRing::read(char * data, std::size_t length)
+{
+	Poco::UInt64 tail = _control->tail.load(std::memory_order_relaxed);
+	Poco::UInt64 head = _control->head.load(std::memory_order_acquire);
+
+	std::size_t used = (std::size_t) (head - tail);
+	if (length > used)
+		length = used;
+	if (length == 0)
+		return 0;
+
+	std::size_t offset = (std::size_t) (tail & (_capacity - 1));
+	std::size_t first = _capacity - offset;
+	if (first > length)
+		first = length;
+	memcpy(data, _data + offset, first);
+	memcpy(data + first, _data, length - first);
+
+	_control->tail.store(tail + length, std::memory_order_release);
+	return length;
+}
+
+std::size_t SharedMemoryRing::readable()
+{
+	return (std::size_t) (_control->head.load(std::memory_order_acquire)
+						  - _control->tail.load(std::memory_order_acquire));
+}
+
+std::size_t SharedMemoryRing::writable()
+{
+	return _capacity - readable();
+}
+
+std::size_t SharedMemoryRing::capacity()
+{
+	return _capacity;
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,146 @@
+#include <Poco/Exception.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <climits>
+#include <new>
+
+#include "SharedMemorySegment.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+SharedMemorySegment::SharedMemorySegment(const std::string & name, unsigned slots, std::size_t ringSize):
+_memory(NULL),
+_base(NULL),
+_slots(slots),
+_ring_size(ringSize)
+{
+	if ((slots == 0) || (ringSize < MIN_RING_SIZE) || ((ringSize & (ringSize - 1)) != 0))
+		throw FoundationException("Invalid shared memory slots or ring size");
+
+	std::size_t size = sizeof(Header) + (slots * slotSize(ringSize));
+	_memory = new Poco::SharedMemory(name, size, Poco::SharedMemory::AM_WRITE, 0, true);
+	_base = _memory->begin();
+
+	Header * header = new (_base) Header();
+	header->slots = slots;
+	header->ring_size = ringSize;
+	header->doorbell.store(0);
+	header->sleeping.store(0);
+
+	for (unsigned i = 0; i < slots; ++i)
+	{
+		Slot * slot = new (slotBase(i)) Slot();
+		slot->state.store(SLOT_FREE);
+		slot->session.store(0);
+		slot->doorbell.store(0);
+		slot->sleeping.store(0);
+		slot->pid.store(0);
+		new (slotBase(i) + sizeof(Slot)) SharedMemoryRing::Control();
+		new (slotBase(i) + sizeof(Slot) + SharedMemoryRing::footprint(ringSize)) SharedMemoryRing::Control();
+		requests(i).reset();
+		responses(i).reset();
+	}
+
+	// Published last, agents do not attach to a segment being built.
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = MAGIC;
+}
+
+SharedMemorySegment::SharedMemorySegment(const std::string & name):
+_memory(NULL),
+_base(NULL),
+_slots(0),
+_ring_size(0)
+{
+	try
+	{
+		Poco::SharedMemory probe(name, sizeof(Header), Poco::SharedMemory::AM_WRITE, 0, false);
+		Header * header = reinterpret_cast<Header *>(probe.begin());
+		if (header->magic != MAGIC)
+			throw FoundationException("Invalid shared memory segment " + name);
+		_slots = header->slots;
+		_ring_size = (std::size_t) header->ring_size;
+	}
+	catch (Poco::SystemException &e)
+	{
+		throw FoundationException("Shared memory segment not found " + name);
+	}
+
+	std::size_t size = sizeof(Header) + (_slots * slotSize(_ring_size));
+	_memory = new Poco::SharedMemory(name, size, Poco::SharedMemory::AM_WRITE, 0, false);
+	_base = _memory->begin();
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+	delete _memory;
+}
+
+SharedMemorySegment::Header & SharedMemorySegment::header()
+{
+	return *reinterpret_cast<Header *>(_base);
+}
+
+unsigned SharedMemorySegment::slots()
+{
+	return _slots;
+}
+
+SharedMemorySegment::Slot & SharedMemorySegment::slot(unsigned index)
+{
+	return *reinterpret_cast<Slot *>(slotBase(index));
+}
+
+SharedMemoryRing SharedMemorySegment::requests(unsigned index)
+{
+	return SharedMemoryRing(slotBase(index) + sizeof(Slot), _ring_size);
+}
+
+SharedMemoryRing SharedMemorySegment::responses(unsigned index)
+{
+	return SharedMemoryRing(slotBase(index) + sizeof(Slot)
+							+ SharedMemoryRing::footprint(_ring_size), _ring_size);
+}
+
+void SharedMemorySegment::ring(std::atomic<Poco::UInt32> & doorbell,
+							   std::atomic<Poco::UInt32> & sleeping)
+{
+	doorbell.fetch_add(1);
+	if (sleeping.load() > 0)
+		syscall(SYS_futex, reinterpret_cast<int *>(&doorbell), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+void SharedMemorySegment::wait(std::atomic<Poco::UInt32> & doorbell,
+							   std::atomic<Poco::UInt32> & sleeping,
+							   Poco::UInt32 seen, long milliseconds)
+{
+	struct timespec timeout;
+	timeout.tv_sec = milliseconds / 1000;
+	timeout.tv_nsec = (milliseconds % 1000) * 1000000;
+
+	sleeping.fetch_add(1);
+	if (doorbell.load() == seen)
+		syscall(SYS_futex, reinterpret_cast<int *>(&doorbell), FUTEX_WAIT, (int) seen, &timeout, NULL, 0);
+	sleeping.fetch_sub(1);
+}
+
+std::size_t SharedMemorySegment::slotSize(std::size_t ringSize)
+{
+	return sizeof(Slot) + (2 * SharedMemoryRing::footprint(ringSize));
+}
+
+char * SharedMemorySegment::slotBase(unsigned index)
+{
+	return _base + sizeof(Header) + (index * slotSize(_ring_size));
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
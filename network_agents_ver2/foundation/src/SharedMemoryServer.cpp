@@ -0,0 +1,143 @@
+#include <Poco/Util/Application.h>
+#include <signal.h>
+#include <errno.h>
+
+#include "SharedMemoryServer.h"
+#include "NetworkServer.h"
+
+
+namespace ChoiceNet
+{
+namespace Eco
+{
+
+SharedMemoryServer::SharedMemoryServer(NetworkServer & server, const std::string & name,
+									   unsigned slots, std::size_t ringSize):
+_server(server),
+_name(name),
+_segment(name, slots, ringSize),
+_connections(slots, (SharedMemoryConnection *) NULL),
+_stop(false)
+{
+}
+
+SharedMemoryServer::~SharedMemoryServer()
+{
+	stop();
+}
+
+void SharedMemoryServer::start()
+{
+	Poco::Util::Application& app = Poco::Util::Application::instance();
+
+	_stop = false;
+	_thread.start(*this);
+
+	app.logger().information(Poco::format("Shared memory segment %s with %u slots",
+							 _name, _segment.slots()));
+}
+
+void SharedMemoryServer::stop()
+{
+	if (_thread.isRunning())
+	{
+		_stop = true;
+		wakeUp();
+		_thread.join();
+	}
+
+	// The reactors are stopped, nothing else uses the connections.
+	for (unsigned i = 0; i < _connections.size(); ++i)
+	{
+		delete _connections[i];
+		_connections[i] = NULL;
+	}
+}
+
+void SharedMemoryServer::run()
+{
+	SharedMemorySegment::Header & header = _segment.header();
+	bool idle = false;
+
+	while (_stop == false)
+	{
+		Poco::UInt32 seen = header.doorbell.load();
+		bool progress = false;
+
+		for (unsigned i = 0; i < _connections.size(); ++i)
+		{
+			SharedMemorySegment::Slot & slot = _segment.slot(i);
+			Poco::UInt32 state = slot.state.load();
+
+			// Agents that died without detaching are looked for only when
+			// there is nothing else to do.
+			bool alive = true;
+			if ((idle == true) && (state == SharedMemorySegment::SLOT_ATTACHED))
+				alive = isAlive(i);
+
+			if ((_connections[i] != NULL)
+				  && ((state != SharedMemorySegment::SLOT_ATTACHED) || (alive == false)
+					  || (slot.session.load() != _connections[i]->getSession())))
+			{
+				close(i);
+			}
+
+			if ((state == SharedMemorySegment::SLOT_CLOSED) || (alive == false))
+			{
+				slot.state.store(SharedMemorySegment::SLOT_FREE);
+				continue;
+			}
+
+			if ((_connections[i] == NULL) && (state == SharedMemorySegment::SLOT_ATTACHED))
+				open(i);
+
+			if (_connections[i] != NULL)
+				progress = _connections[i]->pump() || progress;
+		}
+
+		idle = (progress == false);
+		if (idle == true)
+			SharedMemorySegment::wait(header.doorbell, header.sleeping, seen, IDLE_WAIT);
+	}
+}
+
+void SharedMemoryServer::wakeUp()
+{
+	SharedMemorySegment::Header & header = _segment.header();
+	SharedMemorySegment::ring(header.doorbell, header.sleeping);
+}
+
+SharedMemorySegment & SharedMemoryServer::getSegment()
+{
+	return _segment;
+}
+
+void SharedMemoryServer::open(unsigned index)
+{
+	SharedMemorySegment::Slot & slot = _segment.slot(index);
+
+	Poco::Net::SocketAddress socketAddress = _server.assignLocalAddress();
+
+	_server.getMetrics().connectionOpened();
+	_connections[index] = new SharedMemoryConnection(*this, index, slot.session.load(),
+													 socketAddress, _server);
+}
+
+void SharedMemoryServer::close(unsigned index)
+{
+	SharedMemoryConnection * connection = _connections[index];
+	_connections[index] = NULL;
+
+	// Its channel may be writing a response on the dispatch reactor.
+	_server.getDispatchReactor().post([connection]() { delete connection; });
+}
+
+bool SharedMemoryServer::isAlive(unsigned index)
+{
+	pid_t pid = (pid_t) _segment.slot(index).pid.load();
+	return ((pid <= 0) || (kill(pid, 0) == 0) || (errno != ESRCH));
+}
+
+}  /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,114 @@
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+#include <Poco/Checksum.h>
+#include <Poco/Exception.h>
+#include <fstream>
+#include <cstring>
+
+#include "SnapshotFile.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+void SnapshotFile::write(const std::string & path, const char * magic,
+						 Poco::UInt32 version, const std::string & payload,
+						 const std::string & kind)
+{
+	Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+	crc.update(payload);
+
+	Header header;
+	std::memset(&header, 0, sizeof(Header));
+	std::memcpy(header.magic, magic, sizeof(header.magic));
+	header.version = version;
+	header.checksum = crc.checksum();
+	header.size = payload.size();
+
+	std::string tmpPath = path + ".tmp";
+	std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+	if (out.is_open() == false)
+		throw FoundationException("The " + kind + " could not be created: " + path, 339);
+	out.write((const char *) &header, sizeof(Header));
+	out.write(payload.data(), payload.size());
+	out.close();
+	try
+	{
+		if (out.fail())
+		{
+			Poco::File(tmpPath).remove();
+			throw FoundationException("The " + kind + " could not be written: " + path, 339);
+		}
+		Poco::File(tmpPath).renameTo(path);
+	}
+	catch (Poco::FileException &e)
+	{
+		throw FoundationException("The " + kind + " could not be written: " + e.displayText(), 339);
+	}
+}
+
+bool SnapshotFile::read(const std::string & path, const char * magic,
+						Poco::UInt32 version, const std::string & kind,
+						std::string & payload, std::string & reason)
+{
+	Poco::File file(path);
+	if (file.exists() == false)
+	{
+		reason = "not found";
+		return false;
+	}
+	if (file.getSize() < sizeof(Header))
+	{
+		reason = "truncated";
+		return false;
+	}
+
+	try
+	{
+		Poco::SharedMemory mapping(file, Poco::SharedMemory::AM_READ);
+		std::size_t mapped = mapping.end() - mapping.begin();
+
+		Header header;
+		std::memcpy(&header, mapping.begin(), sizeof(Header));
+		if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+		{
+			reason = "not a " + kind;
+			return false;
+		}
+		if (header.version != version)
+		{
+			reason = "written by another version";
+			return false;
+		}
+		if (mapped != sizeof(Header) + header.size)
+		{
+			reason = "truncated";
+			return false;
+		}
+
+		const char * begin = mapping.begin() + sizeof(Header);
+		Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+		crc.update(begin, (unsigned) header.size);
+		if (crc.checksum() != header.checksum)
+		{
+			reason = "checksum mismatch";
+			return false;
+		}
+
+		payload.assign(begin, (std::size_t) header.size);
+	}
+	catch (Poco::Exception &e)
+	{
+		reason = e.displayText();
+		return false;
+	}
+	return true;
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,104 @@
+#include <Poco/Util/Application.h>
+#include <Poco/Data/Statement.h>
+#include <Poco/Exception.h>
+
+#include "SqlStorageBackend.h"
+#include "ConfigurationLoader.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+// SQLite has no "update ... limit".
+static const std::string SQLITE_COUNT_UPDATE = "update simulation_generalparameters set execution_count = execution_count + 1 where rowid = (select min(rowid) from simulation_generalparameters)";
+
+SqlStorageBackend::SqlStorageBackend(const std::string & connector,
+									 const std::string & connectionString):
+_connector(connector),
+_pool(NULL),
+_sqlite(connector.compare("SQLite") == 0),
+_max_placeholders(BulkInsert::MAX_PLACEHOLDERS)
+{
+	_pool = new Poco::Data::SessionPool(connector, connectionString);
+	if (_sqlite)
+	{
+		_max_placeholders = 999;
+
+		// The journal mode is kept by the database file.
+		Poco::Data::Session session(_pool->get());
+		Poco::Data::Statement wal(session);
+		wal << "PRAGMA journal_mode=WAL";
+		wal.execute();
+	}
+}
+
+SqlStorageBackend::~SqlStorageBackend()
+{
+	delete _pool;
+}
+
+const std::string & SqlStorageBackend::getName() const
+{
+	return _connector;
+}
+
+Poco::Data::SessionPool * SqlStorageBackend::getPool()
+{
+	return _pool;
+}
+
+void SqlStorageBackend::readConfiguration(bool countExecution, unsigned threads,
+										  ConfigurationRows & rows)
+{
+	ConfigurationLoader loader(*_pool, threads);
+	if (_sqlite)
+		loader.setCountUpdate(SQLITE_COUNT_UPDATE);
+	loader.load(countExecution, rows);
+}
+
+int SqlStorageBackend::readExecutionCount(bool countExecution, int configured)
+{
+	ConfigurationLoader loader(*_pool, 1);
+	if (_sqlite)
+		loader.setCountUpdate(SQLITE_COUNT_UPDATE);
+	GeneralParametersRow row;
+	loader.loadGeneralParameters(countExecution, row);
+	return row.execution_count;
+}
+
+void SqlStorageBackend::write(const std::vector<BulkInsert *> & inserts)
+{
+	Poco::Data::Session session(_pool->get());
+	if (_sqlite)
+	{
+		// Set by connection; a WAL database is consistent without the sync
+		// at every commit.
+		Poco::Data::Statement sync(session);
+		sync << "PRAGMA synchronous=NORMAL";
+		sync.execute();
+
+		Poco::Data::Statement timeout(session);
+		timeout << "PRAGMA busy_timeout=5000";
+		timeout.execute();
+	}
+
+	session.begin();
+	try
+	{
+		for (std::size_t i = 0; i < inserts.size(); ++i)
+			inserts[i]->execute(session, _max_placeholders);
+	}
+	catch (Poco::Exception &e)
+	{
+		session.rollback();
+		throw;
+	}
+	session.commit();
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -0,0 +1,81 @@
+#include <Poco/NumberFormatter.h>
+
+#include "StorageBackend.h"
+#include "SqlStorageBackend.h"
+#include "FileStorageBackend.h"
+#include "ColumnarStorageBackend.h"
+#include "FoundationException.h"
+
+
+namespace ChoiceNet
+{
+
+namespace Eco
+{
+
+StorageBackend * StorageBackend::create(Poco::Util::AbstractConfiguration & config)
+{
+	return create(config, config.getString("storage_backend", "mysql"));
+}
+
+StorageBackend * StorageBackend::create(Poco::Util::AbstractConfiguration & config,
+										const std::string & backend)
+{
+	if (backend.compare("mysql") == 0)
+	{
+		// Connection string to POCO
+		std::string db_host = (std::string)
+					config.getString("db_host");
+
+		unsigned short db_port = (unsigned short)
+					config.getInt("db_port",3306);
+
+		std::string db_user = (std::string)
+					config.getString("db_user","root");
+
+		std::string db_password = (std::string)
+					config.getString("db_password","password");
+
+		std::string db_name = (std::string)
+					config.getString("db_name","Network_Simulation");
+
+		std::string sPort = Poco::NumberFormatter::format(db_port);
+		std::string connectionStr = "host=" + db_host + ";port=" + sPort + ";user=" + db_user + ";password=" + db_password + ";db=" + db_name;
+		return new SqlStorageBackend("MySQL", connectionStr);
+	}
+
+	if (backend.compare("sqlite") == 0)
+		return new SqlStorageBackend("SQLite", config.getString("storage_path"));
+
+	if (backend.compare("file") == 0)
+		return new FileStorageBackend(config.getString("storage_path"),
+									  config.getString("config_snapshot"));
+
+	if (backend.compare("columnar") == 0)
+		return new ColumnarStorageBackend(config.getString("storage_path"),
+										  config.getString("config_snapshot"));
+
+	throw FoundationException("Unknown storage backend: " + backend, 341);
+}
+
+StorageBackend::~StorageBackend()
+{
+}
+
+Poco::Data::SessionPool * StorageBackend::getPool()
+{
+	return NULL;
+}
+
+int StorageBackend::readExecutionCount(bool countExecution, int configured)
+{
+	return configured;
+}
+
+void StorageBackend::startExecution(int executionCount)
+{
+}
+
+}   /// End Eco namespace
+
+}  /// End ChoiceNet namespace
@@ -1,5 +1,10 @@
 
 #include <iostream>
+#include <unistd.h>
+#include <exception>
+#include <Poco/NObserver.h>
+#include <Poco/Exception.h>
+#include <Poco/Util/Application.h>
 #include "WaitingSocketReactor.h"
 
 namespace ChoiceNet
@@ -9,20 +14,116 @@ namespace Eco
 {
 
 WaitingSocketReactor::WaitingSocketReactor():
-Poco::Net::SocketReactor()
+Poco::Net::SocketReactor(),
+_wakeup_pending(false),
+_thread(NULL)
 {
+	// The wakeup channel is a datagram socket bound to the loopback, any
+	// byte received on it just makes the reactor leave the select call.
+	_wakeup_socket.bind(Poco::Net::SocketAddress("127.0.0.1", 0));
+	_wakeup_socket.setBlocking(false);
+	_wakeup_address = _wakeup_socket.address();
+
+	addEventHandler(_wakeup_socket,
+		Poco::NObserver<WaitingSocketReactor, Poco::Net::ReadableNotification>(*this, &WaitingSocketReactor::onWakeup));
 }
 
 WaitingSocketReactor::~WaitingSocketReactor()
 {
+	removeEventHandler(_wakeup_socket,
+		Poco::NObserver<WaitingSocketReactor, Poco::Net::ReadableNotification>(*this, &WaitingSocketReactor::onWakeup));
+}
+
+void WaitingSocketReactor::post(const Task & task)
+{
+	bool wakeup = false;
+	{
+		Poco::FastMutex::ScopedLock lock(_tasks_mutex);
+		_tasks.push_back(task);
+		if (_wakeup_pending == false)
+		{
+			_wakeup_pending = true;
+			wakeup = true;
+		}
+	}
+
+	// Only one wakeup byte is in flight at any time.
+	if (wakeup)
+	{
+		char signal = 1;
+		_wakeup_sender.sendTo(&signal, 1, _wakeup_address);
+	}
+}
+
+void WaitingSocketReactor::run()
+{
+	_thread = Poco::Thread::current();
+	Poco::Net::SocketReactor::run();
+}
+
+bool WaitingSocketReactor::isReactorThread()
+{
+	return ((_thread != NULL) && (Poco::Thread::current() == _thread));
+}
+
+void WaitingSocketReactor::onWakeup(const Poco::AutoPtr<Poco::Net::ReadableNotification>& pNf)
+{
+	char buffer[64];
+	while (_wakeup_socket.available() > 0)
+	{
+		_wakeup_socket.receiveBytes(buffer, sizeof(buffer));
+	}
+	runPostedTasks();
+}
+
+void WaitingSocketReactor::runPostedTasks()
+{
+	std::deque<Task> tasks;
+	{
+		Poco::FastMutex::ScopedLock lock(_tasks_mutex);
+		tasks.swap(_tasks);
+		_wakeup_pending = false;
+	}
+
+	std::deque<Task>::iterator it;
+	for (it = tasks.begin(); it != tasks.end(); ++it)
+	{
+		try
+		{
+			(*it)();
+		}
+		catch (Poco::Exception &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(Poco::format("Error running reactor task: %s", e.displayText()));
+		}
+		catch (std::exception &e)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error(Poco::format("Error running reactor task: %s", std::string(e.what())));
+		}
+		catch (...)
+		{
+			Poco::Util::Application& app = Poco::Util::Application::instance();
+			app.logger().error("Error running reactor task: unknown error");
+		}
+	}
 }
 
 void WaitingSocketReactor::onIdle()
 {
 	// std::cout << "On waiting for sockets" << std::endl;
+	runPostedTasks();
 	sleep(0.0001);
 }
 
+void WaitingSocketReactor::onTimeout()
+{
+	// Safety net in case a wakeup byte was lost.
+	runPostedTasks();
+	Poco::Net::SocketReactor::onTimeout();
+}
+
 
 } /// End Eco namespace
 
@@ -0,0 +1,109 @@
+/*
+ * Test the bulk inserts.
+ *
+ * $Id: BulkInsert_test.cpp $
+ * $HeadURL: https://./test/BulkInsert_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "BulkInsert.h"
+#include "FoundationException.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class BulkInsert_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( BulkInsert_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BulkInsert_Test );
+
+void BulkInsert_Test::general_test()
+{
+	std::vector<int> ids;
+	ids.push_back(1);
+	ids.push_back(2);
+	ids.push_back(3);
+	std::vector<std::string> names;
+	names.push_back("plain");
+	names.push_back("tab\there, line\nbreak");
+	names.push_back("back\\slash\r");
+	std::vector<double> values;
+	values.push_back(0.5);
+	values.push_back(-2);
+	values.push_back(10);
+
+	BulkInsert insert("simulation_test", "id, name, value", 0);
+	insert.column(ids).column(names).column(values);
+	CPPUNIT_ASSERT(insert.size() == 3);
+
+	// The text values cannot split their field or their line.
+	std::string text;
+	insert.appendText(text);
+	CPPUNIT_ASSERT(text == "1\tplain\t0.5\n"
+						   "2\ttab\\there, line\\nbreak\t-2\n"
+						   "3\tback\\\\slash\\r\t10\n");
+
+	// No statement has more values than the placeholder limit, the last
+	// one holding the remaining rows.
+	std::vector<int> many(2500, 7);
+	BulkInsert wide("simulation_test", "a, b, c, d, e, f, g", 0);
+	for (int i = 0; i < 7; ++i)
+		wide.column(many);
+
+	std::vector<std::size_t> rows;
+	std::size_t limits[] = { 999, 65535, 1000, 7, 14 };
+	for (std::size_t l = 0; l < sizeof(limits) / sizeof(limits[0]); ++l)
+	{
+		wide.getStatementRows(limits[l], rows);
+		CPPUNIT_ASSERT(rows.empty() == false);
+
+		std::size_t total = 0;
+		for (std::size_t s = 0; s < rows.size(); ++s)
+		{
+			CPPUNIT_ASSERT(rows[s] > 0);
+			CPPUNIT_ASSERT(rows[s] * 7 <= limits[l]);
+			if (s + 1 < rows.size())
+				CPPUNIT_ASSERT(rows[s] == rows[0]);
+			total += rows[s];
+		}
+		CPPUNIT_ASSERT(total == 2500);
+	}
+
+	// SQLite: 142 rows of 7 values, 17 statements and 86 rows left.
+	wide.getStatementRows(999, rows);
+	CPPUNIT_ASSERT(rows.size() == 18);
+	CPPUNIT_ASSERT(rows[0] == 142);
+	CPPUNIT_ASSERT(rows[17] == 86);
+
+	// MySQL: the default chunk of 500 rows fits.
+	wide.getStatementRows(BulkInsert::MAX_PLACEHOLDERS, rows);
+	CPPUNIT_ASSERT(rows.size() == 5);
+	CPPUNIT_ASSERT(rows[4] == 500);
+
+	// The chunk given is kept when it fits.
+	BulkInsert small("simulation_test", "a, b, c, d, e, f, g", 100);
+	for (int i = 0; i < 7; ++i)
+		small.column(many);
+	small.getStatementRows(999, rows);
+	CPPUNIT_ASSERT(rows.size() == 25);
+	CPPUNIT_ASSERT(rows[24] == 100);
+
+	BulkInsert empty("simulation_test", "a", 0);
+	empty.getStatementRows(999, rows);
+	CPPUNIT_ASSERT(rows.empty());
+
+	std::vector<int> shorter(2, 0);
+	CPPUNIT_ASSERT_THROW(insert.column(shorter), FoundationException);
+}
@@ -0,0 +1,103 @@
+/*
+ * Test the columnar result log.
+ *
+ * $Id: ColumnarLog_test.cpp $
+ * $HeadURL: https://./test/ColumnarLog_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <Poco/TemporaryFile.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ColumnarLog.h"
+#include "FoundationException.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class ColumnarLog_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( ColumnarLog_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ColumnarLog_Test );
+
+class TextStorage: public StorageBackend
+/// Keeps the rows written as text.
+{
+public:
+	std::string name;
+	std::string text;
+	std::size_t writes;
+
+	TextStorage(): name("text"), writes(0) {}
+
+	const std::string & getName() const { return name; }
+
+	void readConfiguration(bool countExecution, unsigned threads,
+						   ConfigurationRows & rows) {}
+
+	void write(const std::vector<BulkInsert *> & inserts)
+	{
+		for (std::size_t i = 0; i < inserts.size(); ++i)
+			inserts[i]->appendText(text);
+		++writes;
+	}
+};
+
+void ColumnarLog_Test::general_test()
+{
+	Poco::TemporaryFile file;
+	std::vector<int> periods;
+	std::vector<double> quantities;
+	std::vector<std::string> bids;
+
+	periods.push_back(1);
+	periods.push_back(1);
+	quantities.push_back(0.5);
+	quantities.push_back(2.25);
+	bids.push_back("bid1");
+	bids.push_back("bid2");
+	{
+		ColumnarLog log(file.path());
+		BulkInsert insert("simulation_bid", "period, quantity, bidId", 10);
+		insert.column(periods).column(quantities).column(bids);
+		log.append(insert);
+	}
+
+	// A chunk cut by a crash is dropped when the log is reopened.
+	{
+		std::ofstream out(file.path().c_str(), std::ios::binary | std::ios::app);
+		out << "CHNK and less";
+	}
+
+	periods[0] = 2;
+	periods[1] = 2;
+	bids[0] = "bid3";
+	{
+		ColumnarLog log(file.path());
+		BulkInsert insert("simulation_bid", "period, quantity, bidId", 10);
+		insert.column(periods).column(quantities).column(bids);
+		log.append(insert);
+
+		// The log keeps the columns of its table.
+		BulkInsert other("simulation_purchase", "period, quantity, bidId", 10);
+		other.column(periods).column(quantities).column(bids);
+		CPPUNIT_ASSERT_THROW(log.append(other), FoundationException);
+	}
+
+	TextStorage storage;
+	CPPUNIT_ASSERT(ColumnarLog::load(file.path(), storage, 10) == 4);
+	CPPUNIT_ASSERT(storage.writes == 2);
+	CPPUNIT_ASSERT(storage.text ==
+				   "1\t0.5\tbid1\n1\t2.25\tbid2\n2\t0.5\tbid3\n2\t2.25\tbid2\n");
+}
@@ -0,0 +1,86 @@
+/*
+ * Test the configuration snapshot.
+ *
+ * $Id: ConfigurationSnapshot_test.cpp $
+ * $HeadURL: https://./test/ConfigurationSnapshot_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <Poco/TemporaryFile.h>
+#include <fstream>
+#include <string>
+
+#include "ConfigurationSnapshot.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class ConfigurationSnapshot_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( ConfigurationSnapshot_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ConfigurationSnapshot_Test );
+
+void ConfigurationSnapshot_Test::general_test()
+{
+	ConfigurationRows rows;
+	rows.general.bid_periods = 7;
+	rows.general.pareto_fronts_to_exchange = 2;
+	rows.general.execution_count = 12;
+
+	ResourceRow resource = { 1, "bandwidth" };
+	rows.resources.push_back(resource);
+
+	DistributionRow distribution = { 3, "uniform", "C", "uniform_distribution" };
+	rows.distributions.push_back(distribution);
+	DistributionParameterRow parameter = { 3, "lower", 0.25 };
+	rows.distribution_parameters.push_back(parameter);
+
+	DecisionVariableRow variable = { 4, "delay", "m", 0, 1, 1, "Q", 3, 3, 0 };
+	rows.decision_variables.push_back(variable);
+
+	ServiceRow service = { 5, "voice", "demand.txt", "D", "" };
+	rows.services.push_back(service);
+	ServiceVariableRow serviceVariable = { 5, 4 };
+	rows.service_variables.push_back(serviceVariable);
+	TrafficRow traffic = { 5, 10.5, 2 };
+	rows.traffic.push_back(traffic);
+	rows.services_to_execute.push_back(5);
+
+	Poco::TemporaryFile file;
+	std::string path = file.path();
+	ConfigurationSnapshot::write(path, rows);
+
+	ConfigurationRows read;
+	std::string reason;
+	CPPUNIT_ASSERT(ConfigurationSnapshot::read(path, read, reason) == true);
+	CPPUNIT_ASSERT(read.general.bid_periods == 7);
+	CPPUNIT_ASSERT(read.general.execution_count == 12);
+	CPPUNIT_ASSERT(read.resources.size() == 1);
+	CPPUNIT_ASSERT(read.resources[0].name == "bandwidth");
+	CPPUNIT_ASSERT(read.distribution_parameters[0].value == 0.25);
+	CPPUNIT_ASSERT(read.decision_variables[0].modeling == "Q");
+	CPPUNIT_ASSERT(read.services[0].file_name_demand == "demand.txt");
+	CPPUNIT_ASSERT(read.service_variables[0].decision_variable_id == 4);
+	CPPUNIT_ASSERT(read.traffic[0].average == 10.5);
+	CPPUNIT_ASSERT(read.services_to_execute.size() == 1);
+
+	// A byte changed after the header fails the checksum.
+	{
+		std::fstream io(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		io.seekp(-1, std::ios::end);
+		io.put('x');
+	}
+	CPPUNIT_ASSERT(ConfigurationSnapshot::read(path, read, reason) == false);
+	CPPUNIT_ASSERT(reason == "checksum mismatch");
+
+	CPPUNIT_ASSERT(ConfigurationSnapshot::read(path + ".none", read, reason) == false);
+}
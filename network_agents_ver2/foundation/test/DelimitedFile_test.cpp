@@ -0,0 +1,144 @@
+/*
+ * Test the delimited files.
+ *
+ * $Id: DelimitedFile_test.cpp $
+ * $HeadURL: https://./test/DelimitedFile_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <Poco/TemporaryFile.h>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "DelimitedFile.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class DelimitedFile_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( DelimitedFile_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DelimitedFile_Test );
+
+// The field is a number when strtod reads all of it, and parseFloat must
+// then give the same double, bit for bit.
+static bool parsedAsStrtod(const std::string & field)
+{
+	double value = 0;
+	bool parsed = DelimitedFile::parseFloat(field.data(), field.data() + field.size(), value);
+
+	char * end = NULL;
+	double expected = std::strtod(field.c_str(), &end);
+	bool number = (field.empty() == false) && (*end == '\0');
+
+	if (parsed != number)
+		return false;
+	return (number == false) || (std::memcmp(&value, &expected, sizeof(double)) == 0);
+}
+
+void DelimitedFile_Test::general_test()
+{
+	const char * fields[] = {
+		"0", "-0", "+0", "1", "-1", "+1", "10.5", "0.1", "0.3", "-0.7",
+		"1.", ".5", "-.5", "+.5", "007.25", "0.000001", "123456789.123456",
+		// 15 significant digits, the last taken without strtod.
+		"999999999999999", "0.123456789012345", "-12345.6789012345",
+		"0.000000000000001", "0.0000000000000001",
+		// More than 15 digits.
+		"9999999999999999", "12345678901234567890", "0.1234567890123456789",
+		"3.14159265358979323846", "-2.718281828459045235",
+		// Exponents.
+		"1e3", "1E3", "-1.5e-3", "2.5e+10", "1e308", "1e-320", "6.02214076e23",
+		// Blanks, a leading one is skipped by strtod, a trailing one is not.
+		" 1.5", "\t-2", "1.5 ", "2\t",
+		// Not numbers.
+		"", "-", "+", ".", "-.", "1.2.3", "1-2", "abc", "1x", "--1", "1e", "e5"
+	};
+	for (std::size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i)
+	{
+		CPPUNIT_ASSERT_MESSAGE(fields[i], parsedAsStrtod(fields[i]));
+	}
+
+	unsigned number = 0;
+	std::string field("4294967295");
+	CPPUNIT_ASSERT(DelimitedFile::parseUnsigned(field.data(), field.data() + field.size(), number));
+	CPPUNIT_ASSERT(number == 4294967295U);
+	field = "4294967296";
+	CPPUNIT_ASSERT(DelimitedFile::parseUnsigned(field.data(), field.data() + field.size(), number) == false);
+	field = "-1";
+	CPPUNIT_ASSERT(DelimitedFile::parseUnsigned(field.data(), field.data() + field.size(), number) == false);
+
+	// The fields are trimmed, the empty lines kept and the lines ended by
+	// a carriage return read as the others.
+	Poco::TemporaryFile file;
+	std::string path = file.path();
+	{
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out << "key1 ,  1.25 ,\t7" << "\n";
+		out << "" << "\n";
+		out << " key2,,-3e2 " << "\r\n";
+		out << "\r\n";
+		out << "key3, 12345678901234567 ,x";
+	}
+
+	DelimitedFile delimited(',');
+	CPPUNIT_ASSERT(delimited.open(path));
+	CPPUNIT_ASSERT(delimited.size() == 5);
+
+	CPPUNIT_ASSERT(delimited.count(0) == 3);
+	CPPUNIT_ASSERT(delimited.get(0, 0) == "key1");
+	CPPUNIT_ASSERT(delimited.get(0, 1) == "1.25");
+	double value = 0;
+	CPPUNIT_ASSERT(delimited.parseFloat(0, 1, value));
+	CPPUNIT_ASSERT(value == 1.25);
+	CPPUNIT_ASSERT(delimited.parseUnsigned(0, 2, number));
+	CPPUNIT_ASSERT(number == 7);
+
+	CPPUNIT_ASSERT(delimited.count(1) == 0);
+	CPPUNIT_ASSERT(delimited.get(1, 0) == "");
+	CPPUNIT_ASSERT(delimited.parseFloat(1, 0, value) == false);
+
+	CPPUNIT_ASSERT(delimited.count(2) == 3);
+	CPPUNIT_ASSERT(delimited.get(2, 0) == "key2");
+	CPPUNIT_ASSERT(delimited.get(2, 1) == "");
+	CPPUNIT_ASSERT(delimited.parseFloat(2, 1, value) == false);
+	CPPUNIT_ASSERT(delimited.parseFloat(2, 2, value));
+	CPPUNIT_ASSERT(value == -300);
+
+	CPPUNIT_ASSERT(delimited.count(3) == 0);
+	CPPUNIT_ASSERT(delimited.hasCount(3) == false);
+
+	CPPUNIT_ASSERT(delimited.count(4) == 3);
+	CPPUNIT_ASSERT(delimited.parseFloat(4, 1, value));
+	CPPUNIT_ASSERT(value == std::strtod("12345678901234567", NULL));
+	CPPUNIT_ASSERT(delimited.parseFloat(4, 2, value) == false);
+	CPPUNIT_ASSERT(delimited.parseFloat(4, 3, value) == false);
+
+	std::size_t line = 0;
+	CPPUNIT_ASSERT(delimited.find("key2", line));
+	CPPUNIT_ASSERT(line == 2);
+	CPPUNIT_ASSERT(delimited.find("key3", line));
+	CPPUNIT_ASSERT(line == 4);
+	CPPUNIT_ASSERT(delimited.find("key4", line) == false);
+
+	// Every line has three fields.
+	{
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out << "key1,1,0.5\n";
+		out << "key2 , 2 , 1.5\r\n";
+	}
+	CPPUNIT_ASSERT(delimited.open(path));
+	CPPUNIT_ASSERT(delimited.hasCount(3));
+	CPPUNIT_ASSERT(delimited.hasCount(2) == false);
+}
@@ -0,0 +1,70 @@
+/*
+ * Test the demand series.
+ *
+ * $Id: DemandSeries_test.cpp $
+ * $HeadURL: https://./test/DemandSeries_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <Poco/TemporaryFile.h>
+#include <Poco/File.h>
+#include <fstream>
+#include <string>
+
+#include "DemandSeries.h"
+#include "FoundationException.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class DemandSeries_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( DemandSeries_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DemandSeries_Test );
+
+void DemandSeries_Test::general_test()
+{
+	Poco::TemporaryFile file;
+	std::string path = file.path();
+	{
+		std::ofstream out(path.c_str());
+		out << "1 : 10.5" << std::endl << "2 : 20" << std::endl << "3 : 30" << std::endl;
+	}
+
+	DemandSeries series;
+	series.load(path, true);
+	CPPUNIT_ASSERT(series.size() == 3);
+	CPPUNIT_ASSERT(series.isFromCache() == false);
+	CPPUNIT_ASSERT(series.get(0) == 0);
+	CPPUNIT_ASSERT(series.get(1) == 10.5);
+	CPPUNIT_ASSERT(series.get(3) == 30);
+
+	// The periods after the last one repeat the series.
+	CPPUNIT_ASSERT(series.get(4) == 10.5);
+	CPPUNIT_ASSERT(series.get(6) == 30);
+
+	// The second load maps the cache written by the first one.
+	DemandSeries cached;
+	cached.load(path, true);
+	CPPUNIT_ASSERT(cached.isFromCache() == true);
+	CPPUNIT_ASSERT(cached.size() == 3);
+	CPPUNIT_ASSERT(cached.get(2) == 20);
+	Poco::File(DemandSeries::getCachePath(path)).remove();
+
+	// Periods must be consecutive.
+	{
+		std::ofstream out(path.c_str());
+		out << "1 : 10" << std::endl << "3 : 30" << std::endl;
+	}
+	DemandSeries partitioned;
+	CPPUNIT_ASSERT_THROW(partitioned.load(path, false), FoundationException);
+}
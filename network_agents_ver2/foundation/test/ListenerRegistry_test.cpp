@@ -0,0 +1,94 @@
+/*
+ * Test the listener registry.
+ *
+ * $Id: ListenerRegistry_test.cpp $
+ * $HeadURL: https://./test/ListenerRegistry_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <Poco/Net/SocketAddress.h>
+#include <vector>
+
+#include "Listener.h"
+#include "ListenerRegistry.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class ListenerRegistry_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( ListenerRegistry_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ListenerRegistry_Test );
+
+void ListenerRegistry_Test::general_test()
+{
+	ListenerRegistry registry;
+
+	Poco::Net::SocketAddress address1("127.0.0.1", 10001);
+	Poco::Net::SocketAddress address2("127.0.0.1", 10002);
+	Poco::Net::SocketAddress address3("127.0.0.1", 10003);
+
+	Listener * listener1 = registry.add("provider1", address1);
+	Listener * listener2 = registry.add("provider2", address2);
+	Listener * listener3 = registry.add("presenter1", address3);
+
+	CPPUNIT_ASSERT(listener1 != NULL);
+	CPPUNIT_ASSERT(listener2 != NULL);
+	CPPUNIT_ASSERT(listener3 != NULL);
+	CPPUNIT_ASSERT(registry.size() == 3);
+
+	// Neither the id nor the address can be registered twice.
+	CPPUNIT_ASSERT(registry.add("provider1", address3) == NULL);
+	CPPUNIT_ASSERT(registry.add("provider4", address1) == NULL);
+
+	CPPUNIT_ASSERT(registry.find(address2) == listener2);
+	CPPUNIT_ASSERT(registry.find(std::string("presenter1")) == listener3);
+
+	registry.setType(listener1, "provider");
+	registry.setType(listener2, "provider");
+	registry.setType(listener3, "presenter");
+
+	std::vector<Listener *> providers;
+	registry.getListeners("provider", providers);
+	CPPUNIT_ASSERT(providers.size() == 2);
+	CPPUNIT_ASSERT(providers[0] == listener1);
+	CPPUNIT_ASSERT(providers[1] == listener2);
+	CPPUNIT_ASSERT(listener1->getType() == PROVIDER);
+
+	// Removing a listener takes it out of every index.
+	CPPUNIT_ASSERT(registry.remove(address1) == listener1);
+	CPPUNIT_ASSERT(registry.remove(address1) == NULL);
+	CPPUNIT_ASSERT(registry.find(std::string("provider1")) == NULL);
+	CPPUNIT_ASSERT(registry.size() == 2);
+
+	providers.clear();
+	registry.getListeners("provider", providers);
+	CPPUNIT_ASSERT(providers.size() == 1);
+	CPPUNIT_ASSERT(providers[0] == listener2);
+
+	std::vector<Listener *> all;
+	registry.getListeners(all);
+	CPPUNIT_ASSERT(all.size() == 2);
+	CPPUNIT_ASSERT(all[0] == listener2);
+	CPPUNIT_ASSERT(all[1] == listener3);
+
+	// The id is available again.
+	Listener * listener4 = registry.add("provider1", address1);
+	CPPUNIT_ASSERT(listener4 != NULL);
+
+	// The listeners are not connected, release them here.
+	delete listener1;
+	delete registry.remove(address1);
+	delete registry.remove(address2);
+	delete registry.remove(address3);
+	CPPUNIT_ASSERT(registry.size() == 0);
+}
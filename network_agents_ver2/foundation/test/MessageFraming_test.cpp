@@ -0,0 +1,81 @@
+/*
+ * Test the message framing.
+ *
+ * $Id: MessageFraming_test.cpp $
+ * $HeadURL: https://./test/MessageFraming_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "Message.h"
+#include "MessageFraming.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class MessageFraming_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( MessageFraming_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( MessageFraming_Test );
+
+void MessageFraming_Test::general_test()
+{
+	MessageFraming framing;
+
+	Message connectMessage;
+	connectMessage.setMethod(ChoiceNet::Eco::connect);
+	connectMessage.setParameter("Agent", "provider1");
+	std::string first = connectMessage.to_string();
+
+	Message portMessage;
+	portMessage.setMethod(send_port);
+	portMessage.setParameter("Port", "5000");
+	portMessage.setParameter("Type", "provider");
+	std::string second = portMessage.to_string();
+
+	// A partial message is kept until the rest arrives.
+	framing.append(first.c_str(), first.size() - 5);
+	Message message;
+	CPPUNIT_ASSERT(framing.next(message) == false);
+
+	// The rest of the first message arrives with the second one.
+	std::string rest = first.substr(first.size() - 5) + second;
+	framing.append(rest.c_str(), rest.size());
+
+	Message message1;
+	CPPUNIT_ASSERT(framing.next(message1) == true);
+	CPPUNIT_ASSERT(message1.getMethod() == ChoiceNet::Eco::connect);
+	CPPUNIT_ASSERT(message1.getParameter("Agent") == "provider1");
+
+	Message message2;
+	CPPUNIT_ASSERT(framing.next(message2) == true);
+	CPPUNIT_ASSERT(message2.getMethod() == send_port);
+	CPPUNIT_ASSERT(message2.getParameter("Port") == "5000");
+
+	CPPUNIT_ASSERT(framing.next(message) == false);
+	CPPUNIT_ASSERT(framing.size() == 0);
+
+	// Data not starting with a method is given as an undefined message and
+	// skipped up to the next method.
+	std::string garbage = "xx" + second;
+	framing.append(garbage.c_str(), garbage.size());
+
+	Message message3;
+	CPPUNIT_ASSERT(framing.next(message3) == true);
+	CPPUNIT_ASSERT(message3.getMethod() == undefined);
+
+	Message message4;
+	CPPUNIT_ASSERT(framing.next(message4) == true);
+	CPPUNIT_ASSERT(message4.getMethod() == send_port);
+	CPPUNIT_ASSERT(framing.size() == 0);
+}
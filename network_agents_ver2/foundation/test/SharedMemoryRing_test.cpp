@@ -0,0 +1,57 @@
+/*
+ * Test the shared memory ring.
+ *
+ * $Id: SharedMemoryRing_test.cpp $
+ * $HeadURL: https://./test/SharedMemoryRing_test.cpp $
+ */
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+#include <new>
+
+#include "SharedMemoryRing.h"
+
+
+using namespace ChoiceNet::Eco;
+
+class SharedMemoryRing_Test : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( SharedMemoryRing_Test );
+
+	CPPUNIT_TEST( general_test );
+	CPPUNIT_TEST_SUITE_END();
+
+  public:
+	void general_test();
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SharedMemoryRing_Test );
+
+void SharedMemoryRing_Test::general_test()
+{
+	std::vector<char> memory(SharedMemoryRing::footprint(16));
+	new (&memory[0]) SharedMemoryRing::Control();
+	SharedMemoryRing ring(&memory[0], 16);
+	ring.reset();
+
+	char buffer[32];
+	CPPUNIT_ASSERT(ring.read(buffer, sizeof(buffer)) == 0);
+	CPPUNIT_ASSERT(ring.writable() == 16);
+
+	// Only what fits is written.
+	std::string first = "Method=connect;Agent=1;";
+	CPPUNIT_ASSERT(ring.write(first.c_str(), first.size()) == 16);
+	CPPUNIT_ASSERT(ring.readable() == 16);
+	CPPUNIT_ASSERT(ring.write(first.c_str(), first.size()) == 0);
+
+	CPPUNIT_ASSERT(ring.read(buffer, 10) == 10);
+	CPPUNIT_ASSERT(std::string(buffer, 10) == first.substr(0, 10));
+
+	// The rest wraps around the end of the ring.
+	CPPUNIT_ASSERT(ring.write(first.c_str() + 16, first.size() - 16) == 7);
+	CPPUNIT_ASSERT(ring.read(buffer, sizeof(buffer)) == 13);
+	CPPUNIT_ASSERT(std::string(buffer, 13) == first.substr(10));
+	CPPUNIT_ASSERT(ring.readable() == 0);
+}
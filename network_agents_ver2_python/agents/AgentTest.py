@@ -0,0 +1,80 @@
+from foundation.Agent import Agent
+from foundation.AgentServer import AgentServerHandler
+from foundation.AgentType import AgentType
+from foundation.Message import Message
+from ConsumerTest import ChannelClockServerStub
+import foundation.agent_properties
+import logging
+import threading
+
+logger = logging.getLogger('agent_test')
+logger.setLevel(logging.DEBUG)
+fh = logging.FileHandler('agent_test.log')
+fh.setLevel(logging.DEBUG)
+formatter = logging.Formatter('%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+fh.setFormatter(formatter)
+logger.addHandler(fh)
+
+def test_acknowledge_interval():
+    foundation.agent_properties.intervals_per_cycle = 2
+    foundation.agent_properties.send_information_on_interval = 1
+    provider = Agent('Provider1', 1, AgentType(AgentType.PROVIDER_BACKHAUL), '1', 1,
+                     '', '', 'B', '', threading.RLock())
+    channel = ChannelClockServerStub(True)
+    provider._agntClient._channelClockServer = channel
+
+    # No interval started.
+    assert provider.acknowledgeInterval() == False
+    assert len(channel._messages) == 0
+
+    # An interval without purchase feedback is done at once, only once.
+    provider._list_vars['Interval_Started'] = 4
+    assert provider.acknowledgeInterval() == True
+    assert channel._messages[0].getMethod() == Message.PERIOD_DONE
+    assert channel._messages[0].getParameter('Period') == '4'
+    assert provider.acknowledgeInterval() == False
+    assert len(channel._messages) == 1
+
+    # The feedback interval waits for the feedback and the bids.
+    provider._list_vars['Interval_Started'] = 5
+    assert provider.acknowledgeInterval() == False
+    provider._list_vars['Feedback_Period'] = 2
+    provider._list_vars['State'] = AgentServerHandler.BID_PERMITED
+    assert provider.acknowledgeInterval() == False
+    provider._list_vars['State'] = AgentServerHandler.IDLE
+    assert provider.acknowledgeInterval() == True
+    assert channel._messages[1].getParameter('Period') == '5'
+
+    # The feedback may arrive before the interval starts.
+    provider._list_vars['Feedback_Period'] = 3
+    provider._list_vars['Interval_Started'] = 7
+    assert provider.acknowledgeInterval() == True
+    assert channel._messages[2].getParameter('Period') == '7'
+    logger.info('test_acknowledge_interval passed')
+
+def test_join_interval():
+    foundation.agent_properties.intervals_per_cycle = 2
+    foundation.agent_properties.send_information_on_interval = 1
+    provider = Agent('Provider2', 2, AgentType(AgentType.PROVIDER_BACKHAUL), '1', 1,
+                     '', '', 'B', '', threading.RLock())
+    channel = ChannelClockServerStub(True)
+    provider._agntClient._channelClockServer = channel
+
+    # Joined during a feedback interval, whose feedback was already sent.
+    response = Message('')
+    response.setMessageStatusOk()
+    response.setParameter('Period', '9')
+    provider.joinInterval(response)
+    assert provider.acknowledgeInterval() == True
+    assert channel._messages[0].getParameter('Period') == '9'
+
+    # A clock server not giving the period.
+    provider.joinInterval(Message(''))
+    assert provider.acknowledgeInterval() == False
+    logger.info('test_join_interval passed')
+
+
+if __name__ == '__main__':
+    test_acknowledge_interval()
+    test_join_interval()
+    print 'Agent tests passed'
@@ -214,11 +214,24 @@ class Consumer(Agent):
                     break
 
             qtyPurchased = parameters['quantity'] - quantity
-            logger.debug('Agent: %s - :Period: %s - :AvailBids: %s :initial qty:%s :qty_purchased:%s :Purchase the bid: %s', self._list_vars['strId'], str(self._list_vars['Current_Period']), str(numBids), str(parameters['quantity']), str(qtyPurchased), bidId )
+            logger.debug('Agent: %s - :Period: %s - :AvailBids: %s :units:%s :initial qty:%s :qty_purchased:%s :Purchase the bid: %s', self._list_vars['strId'], str(self._list_vars['Current_Period']), str(numBids), str(parameters['units']), str(parameters['quantity']), str(qtyPurchased), bidId )
         else:
             logger.debug(' Agent: %s - Period: %s - could not puchase', self._list_vars['strId'], str(self._list_vars['Current_Period']))
 
             # logger.debug('Agent: %s - Period: %s - Ending exec_algorithm',self._list_vars['strId'], str(self._list_vars['Current_Period']))
+
+    '''
+    Tells the clock server the purchases of the activation are done, so
+    a clock running in barrier mode does not wait for its timeout.
+    '''
+    def acknowledgePeriod(self):
+        messageDone = Message('')
+        messageDone.setMethod(Message.PERIOD_DONE)
+        messageDone.setParameter('Period', str(self._list_vars['Current_Period']))
+        response = self.sendMessageClock(messageDone)
+        if (not response.isMessageStatusOk()):
+            logger.debug('Agent: %s - Period: %s - period_done not accepted', self._list_vars['strId'], str(self._list_vars['Current_Period']))
+
 	'''
 	The run method activates the avaiable consumer agents.
 	'''
@@ -241,6 +254,7 @@ class Consumer(Agent):
                         self._list_vars['State'] = AgentServerHandler.IDLE
                     finally:
                         self.lock.release() 
+                    self.acknowledgePeriod()
                 elif (self._list_vars['State'] == AgentServerHandler.IDLE):
                     time.sleep(0.1)
         # logger.debug('Agent: %s - Shuting down', self._list_vars['strId'])
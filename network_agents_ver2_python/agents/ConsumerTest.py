@@ -0,0 +1,54 @@
+from Consumer import Consumer
+from foundation.Message import Message
+import logging
+
+logger = logging.getLogger('consumer_test')
+logger.setLevel(logging.DEBUG)
+fh = logging.FileHandler('consumer_test.log')
+fh.setLevel(logging.DEBUG)
+formatter = logging.Formatter('%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+fh.setFormatter(formatter)
+logger.addHandler(fh)
+
+class ChannelClockServerStub(object):
+    '''
+    Records the messages sent to the clock server and answers them
+    with the status given.
+    '''
+    def __init__(self, statusOk):
+        self._statusOk = statusOk
+        self._messages = []
+
+    def sendMessage(self, message):
+        self._messages.append(message)
+        response = Message('')
+        if (self._statusOk):
+            response.setMessageStatusOk()
+        return response
+
+def test_acknowledge_period():
+    consumer = Consumer('Consumer1', 1, '1', 1)
+    channel = ChannelClockServerStub(True)
+    consumer._agntClient._channelClockServer = channel
+    consumer._list_vars['Current_Period'] = 7
+
+    consumer.acknowledgePeriod()
+    assert len(channel._messages) == 1
+    message = channel._messages[0]
+    assert message.getMethod() == Message.PERIOD_DONE
+    assert message.getParameter('Period') == '7'
+
+    # A refused acknowledgement is only logged.
+    channel._statusOk = False
+    consumer.acknowledgePeriod()
+    assert len(channel._messages) == 2
+
+    # Without a clock server connection nothing is sent.
+    consumer._agntClient._channelClockServer = None
+    consumer.acknowledgePeriod()
+    logger.info('test_acknowledge_period passed')
+
+
+if __name__ == '__main__':
+    test_acknowledge_period()
+    print 'Consumer tests passed'
@@ -163,6 +163,10 @@ class Agent(Process):
             if (result_clock.isMessageStatusOk() and result_mkt_place.isMessageStatusOk() ):
                 periodStr = result_mkt_place.getParameter("Period")
                 self._list_vars['Current_Period'] = int(periodStr)
+                agent_type = self._list_vars['Type']
+                if ((agent_type.getType() == AgentType.PROVIDER_ISP) 
+                   or (agent_type.getType() == AgentType.PROVIDER_BACKHAUL)):
+                    self.joinInterval(result_clock)
                 logger.info('Servers connected ' + str(periodStr))
                 return int(periodStr)
             else:
@@ -173,6 +177,23 @@ class Agent(Process):
             self.lock.release()
     
 
+    '''
+    The interval the provider started listening in is acknowledged like
+    any other, once the provider is set up. Its purchase feedback was
+    sent before, so it does not wait for it.
+    '''
+    def joinInterval(self, result_clock):
+        try:
+            interval = int(result_clock.getParameter("Period"))
+        except FoundationException:
+            # Clock servers not giving the period.
+            return
+        if (interval > self._list_vars.get('Interval_Started', -1)):
+            self._list_vars['Interval_Started'] = interval
+        cycle = interval // agent_properties.intervals_per_cycle
+        if (cycle > self._list_vars.get('Feedback_Period', -1)):
+            self._list_vars['Feedback_Period'] = cycle
+
     '''
     This method creates the server for listening messages from 
     the demand server or the marketplace server.
@@ -273,9 +294,40 @@ class Agent(Process):
             logger.error('exception Id:%s - Message:%s', self._list_vars['Id'], e.__str__()) 
             raise FoundationException(e.__str__())
 
+    def sendMessageClock(self, message):
+        return self._agntClient.sendMessageClock(message)
+
     def sendMessageMarket(self, message):
         return self._agntClient.sendMessageMarket(message)
 
+    '''
+    Tells the clock server the last interval started is done. The
+    intervals in which the market sends the purchase feedback are done
+    once the feedback arrived and the bids answering it were sent, so a
+    clock running in barrier mode leaves the agent its decision time.
+    '''
+    def acknowledgeInterval(self):
+        self._lock.acquire()
+        try:
+            interval = self._list_vars.get('Interval_Started', -1)
+            if ((interval < 0) or (self._list_vars['State'] == AgentServerHandler.BID_PERMITED)):
+                return False
+            intervals = agent_properties.intervals_per_cycle
+            if ((interval % intervals) == agent_properties.send_information_on_interval):
+                if (self._list_vars.get('Feedback_Period', -1) < (interval // intervals)):
+                    return False
+            self._list_vars['Interval_Started'] = -1
+        finally:
+            self._lock.release()
+
+        messageDone = Message('')
+        messageDone.setMethod(Message.PERIOD_DONE)
+        messageDone.setParameter('Period', str(interval))
+        response = self.sendMessageClock(messageDone)
+        if (not response.isMessageStatusOk()):
+            logger.debug('Agent: %s - Interval: %s - period_done not accepted', self._list_vars['strId'], str(interval))
+        return True
+
     def sendMessageMarketBuy(self, message):
         return self._agntClient.sendMessageMarketBuy(message)
 
@@ -54,8 +54,19 @@ class AgentServerHandler(asyncore.dispatcher):
     def end_period_process(self, message):    
         pass
 
+    '''
+    The providers acknowledge every interval started to the clock server,
+    see Agent.acknowledgeInterval.
+    '''
     def start_period_process(self, message):
-        pass
+        self.lock.acquire()
+        try:
+            agent_type = self._list_args['Type']
+            if (( agent_type.getType() == AgentType.PROVIDER_ISP) 
+               or ( agent_type.getType() == AgentType.PROVIDER_BACKHAUL)):
+                self._list_args['Interval_Started'] = int(message.getParameter("Period"))
+        finally:
+            self.lock.release()
     
     '''
     This method activates the agent with all its parameters.
@@ -71,7 +82,14 @@ class AgentServerHandler(asyncore.dispatcher):
                 quantityStr = message.getParameter("Quantity")    
                 period = int(message.getParameter("Period"))
                 parameters['service'] = serviceId
+                # The quantity is the total of the demand units given
+                # to the consumer, it is purchased as a whole.
                 parameters['quantity'] = float(quantityStr) 
+                try:
+                    parameters['units'] = int(message.getParameter("Units"))
+                except FoundationException:
+                    # Clock servers giving a single unit.
+                    parameters['units'] = 1
                 
                 # set the state to be active.
                 self._list_args['State'] = AgentServerHandler.TO_BE_ACTIVED
@@ -306,6 +324,7 @@ class AgentServerHandler(asyncore.dispatcher):
                 if (( agent_type.getType() == AgentType.PROVIDER_ISP) 
                     or (agent_type.getType() == AgentType.PROVIDER_BACKHAUL)):
                     self._list_args['State'] = AgentServerHandler.BID_PERMITED    
+                    self._list_args['Feedback_Period'] = period
                 logger.debug('Receive Purchase feedback - Agent:%s Period: %s ', str(self._list_args['Id']), str(self._list_args['Current_Period'] ))        
         except Exception as e: 
            raise FoundationException(str(e))
@@ -18,8 +18,12 @@ class Channel_ClockServer(object):
         HOST = agent_properties.addr_clock_server
         #PORT = 3333           # The same port as used by the server
         PORT = agent_properties.clock_listening_port
-        self._s_clock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-        err = self._s_clock.connect_ex((HOST, PORT))
+        if (agent_properties.clock_socket_path != ''):
+            self._s_clock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            err = self._s_clock.connect_ex(agent_properties.clock_socket_path)
+        else:
+            self._s_clock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            err = self._s_clock.connect_ex((HOST, PORT))
         if (err > 0):
 		raise FoundationException("Error: the Clock Server is not running")
     
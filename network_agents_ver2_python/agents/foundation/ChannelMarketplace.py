@@ -18,8 +18,13 @@ class Channel_Marketplace(object):
         #PORT = 5555           # The same port as used by the server
         PORT = port
         try:
-            self._s_mkt = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-            err = self._s_mkt.connect_ex((HOST, PORT))
+            path = agent_properties.mkt_place_socket_paths.get(HOST, '')
+            if (path != ''):
+                self._s_mkt = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                err = self._s_mkt.connect_ex(path)
+            else:
+                self._s_mkt = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+                err = self._s_mkt.connect_ex((HOST, PORT))
             if (err > 0):
                 raise FoundationException("Error: the Market Place Server is not running")
         except socket.error, msg:
@@ -27,6 +27,7 @@ class Message(object):
     GET_UNITARY_COST = 18
     ACTIVATE_PRESENTER = 19
     GET_AVAILABILITY = 30
+    PERIOD_DONE = 31
     
     # define the separator
     LINE_SEPARATOR = '\r\n'
@@ -83,6 +84,8 @@ class Message(object):
                     self._method = Message.ACTIVATE_PRESENTER
                 elif (methodParam[1] == 'get_availability'):
                     self._method = Message.GET_AVAILABILITY
+                elif (methodParam[1] == 'period_done'):
+                    self._method = Message.PERIOD_DONE
                 else:
                     self._method = Message.UNDEFINED
             else:
@@ -181,6 +184,8 @@ class Message(object):
             self._method = Message.ACTIVATE_PRESENTER
         elif (method == Message.GET_AVAILABILITY):
             self._method = Message.GET_AVAILABILITY
+        elif (method == Message.PERIOD_DONE):
+            self._method = Message.PERIOD_DONE
         else:
             self._method = Message.UNDEFINED
 
@@ -231,6 +236,8 @@ class Message(object):
             return "activate_presenter"
         elif (self._method == Message.GET_AVAILABILITY):
             return "get_availability"
+        elif (self._method == Message.PERIOD_DONE):
+            return "period_done"
         else:
             return "invalid_method"
 
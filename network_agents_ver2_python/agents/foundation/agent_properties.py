@@ -28,12 +28,23 @@ addr_agent_mktplace_isp = '10.10.1.1'
 addr_agent_mktplace_backhaul = '10.10.1.1'
 addr_agent_clock_server = '10.10.1.1'
 
+# Unix domain sockets of the servers (their local_socket_path), used
+# instead of TCP when the agent runs on the same host. The market paths
+# are indexed by the market address. A server calls an agent connected
+# this way back on 127.0.0.1, so the agent addresses above must accept
+# loopback connections.
+clock_socket_path = ''
+mkt_place_socket_paths = {}
+
 threshold = 2
 own_neighbor_radius = 0.05
 others_neighbor_radius = 100 # almost every bid is in the neighbor.
 initial_number_bids = 5
 num_periods_market_share = 3
 intervals_per_cycle = 2
+# Interval of the cycle in which the market place sends the purchase
+# feedback, its send_information_on_interval.
+send_information_on_interval = 1
 
 #directory results
 result_directory = 'results/'